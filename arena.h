@@ -0,0 +1,73 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+//one block per owner (a chunk), bump allocated, freed all at once
+//only for what we allocate ourselves, raylib mallocs inside LoadModel/LoadImage and copying that in after would only
+//double the peak and add a memcpy, so those stay on raylibs heap and are freed the raylib way
+#include "raylib.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ARENA_ALIGN 16
+
+typedef struct {
+    unsigned char *base;
+    size_t size;
+    size_t used;
+} Arena;
+
+static inline size_t ArenaAlignUp(size_t n)
+{
+    return (n + (ARENA_ALIGN - 1)) & ~(size_t)(ARENA_ALIGN - 1);
+}
+
+// the one reservation, size should come from the Arena*Bytes helpers below
+bool ArenaInit(Arena *a, size_t size)
+{
+    memset(a, 0, sizeof(Arena));
+    if (size == 0) return true;
+    a->base = (unsigned char *)malloc(size);
+    if (!a->base)
+    {
+        TraceLog(LOG_ERROR, "ARENA: failed to reserve %zu bytes", size);
+        return false;
+    }
+    a->size = size;
+    return true;
+}
+
+// NULL when it does not fit, nothing is ever freed on its own
+void *ArenaAlloc(Arena *a, size_t size)
+{
+    size_t aligned = ArenaAlignUp(size);
+    if (a->base == NULL || a->used + aligned > a->size)
+    {
+        TraceLog(LOG_WARNING, "ARENA: out of space (%zu used of %zu, wanted %zu)", a->used, a->size, size);
+        return NULL;
+    }
+    void *p = a->base + a->used;
+    a->used += aligned;
+    return p;
+}
+
+void *ArenaCopy(Arena *a, const void *src, size_t size)
+{
+    void *p = ArenaAlloc(a, size);
+    if (p) memcpy(p, src, size);
+    return p;
+}
+
+void ArenaReset(Arena *a)
+{
+    a->used = 0;
+}
+
+void ArenaFree(Arena *a)
+{
+    free(a->base);
+    memset(a, 0, sizeof(Arena));
+}
+
+#endif //ARENA_H
@@ -0,0 +1,416 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+//scripted camera path for benchmarking play, fixed timestep, writes a json report at the end
+//script is plain text, one command per line, # for comments, angles in degrees:
+//  pose x y z yaw pitch       jump there for one frame (recorded paths are just a list of these)
+//  fly x y z seconds          straight line, no ground snap, faces the way it goes
+//  walk x z seconds           same but on the ground
+//  look yaw pitch seconds     turn in place
+//  dash dist                  instant move along the view direction (GOKU_DASH_DIST)
+//  chunk cx cy                teleport to a chunk center, like ENTER
+//  wait seconds
+//  day / night
+#include "raylib.h"
+#include "raymath.h"
+#include "profiler.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_DT (1.0f/60.0f)
+#define BENCH_SEED 1337
+#define BENCH_HITCH_MS 33.3f   // two frames at 60
+#define BENCH_SPIKE_MS 100.0f
+
+typedef enum {
+    BENCH_CMD_POSE = 0,
+    BENCH_CMD_FLY,
+    BENCH_CMD_WALK,
+    BENCH_CMD_LOOK,
+    BENCH_CMD_DASH,
+    BENCH_CMD_CHUNK,
+    BENCH_CMD_WAIT,
+    BENCH_CMD_DAY,
+    BENCH_CMD_NIGHT,
+} BenchCmdType;
+
+typedef struct {
+    BenchCmdType type;
+    Vector3 pos;
+    float yaw, pitch;   // radians once parsed
+    float seconds;
+    float dist;
+    int cx, cy;
+} BenchCmd;
+
+// What the path wants the camera to do this frame, the caller applies it
+typedef struct {
+    Vector3 pos;
+    float yaw, pitch;
+    bool ground;        // snap to terrain
+    bool teleport;      // go to chunk (cx, cy)
+    int cx, cy;
+    bool setDay;
+    bool day;
+} BenchPose;
+
+typedef struct {
+    int chunkTextures;
+    int chunkModels;
+    int tiles;
+    int tileUnloads;
+} BenchUploads;
+
+typedef struct {
+    bool active;
+    bool running;       // loading is done and the path is playing
+    bool done;
+    char scriptName[256];
+    char outPath[256];
+    BenchCmd *cmds;
+    int cmdCount;
+    int cur;
+    float segT;
+    BenchPose segStart;
+    //stats
+    double loadStartMs;
+    float loadSeconds;
+    float *frameMs;
+    int frameCount;
+    int frameCap;
+    double phaseSum[PROF_PHASE_COUNT];
+    BenchUploads uploads;       // counted all the time, the run keeps the delta
+    BenchUploads uploadsAtStart;
+    int maxUploadsFrame;
+    long drawCallSum;
+    size_t peakGpuBytes;
+} BenchRun;
+
+BenchRun benchRun = { 0 };
+
+static bool BenchPushCmd(BenchRun *b, BenchCmd cmd, int *cap)
+{
+    if (b->cmdCount >= *cap)
+    {
+        int newCap = *cap > 0 ? *cap * 2 : 64;
+        BenchCmd *grown = (BenchCmd *)realloc(b->cmds, sizeof(BenchCmd) * newCap);
+        if (!grown) return false;
+        b->cmds = grown;
+        *cap = newCap;
+    }
+    b->cmds[b->cmdCount++] = cmd;
+    return true;
+}
+
+// Parse a script from memory, returns the number of commands
+int BenchParseScript(BenchRun *b, const char *text)
+{
+    int cap = b->cmdCount;
+    const char *line = text;
+    int lineNo = 0;
+    while (line && *line)
+    {
+        const char *end = strchr(line, '\n');
+        int len = end ? (int)(end - line) : (int)strlen(line);
+        char buf[256];
+        if (len >= (int)sizeof(buf)) len = sizeof(buf) - 1;
+        memcpy(buf, line, len);
+        buf[len] = '\0';
+        line = end ? end + 1 : NULL;
+        lineNo++;
+
+        char *hash = strchr(buf, '#');
+        if (hash) *hash = '\0';
+        char word[16] = { 0 };
+        if (sscanf(buf, "%15s", word) != 1) continue;
+
+        BenchCmd c = { 0 };
+        float a = 0, d = 0, e = 0, f = 0, g = 0;
+        bool ok = true;
+        if (strcmp(word, "pose") == 0)
+        {
+            ok = sscanf(buf, "%*s %f %f %f %f %f", &a, &d, &e, &f, &g) == 5;
+            c.type = BENCH_CMD_POSE; c.pos = (Vector3){ a, d, e }; c.yaw = f*DEG2RAD; c.pitch = g*DEG2RAD;
+        }
+        else if (strcmp(word, "fly") == 0)
+        {
+            ok = sscanf(buf, "%*s %f %f %f %f", &a, &d, &e, &f) == 4;
+            c.type = BENCH_CMD_FLY; c.pos = (Vector3){ a, d, e }; c.seconds = f;
+        }
+        else if (strcmp(word, "walk") == 0)
+        {
+            ok = sscanf(buf, "%*s %f %f %f", &a, &e, &f) == 3;
+            c.type = BENCH_CMD_WALK; c.pos = (Vector3){ a, 0, e }; c.seconds = f;
+        }
+        else if (strcmp(word, "look") == 0)
+        {
+            ok = sscanf(buf, "%*s %f %f %f", &a, &d, &f) == 3;
+            c.type = BENCH_CMD_LOOK; c.yaw = a*DEG2RAD; c.pitch = d*DEG2RAD; c.seconds = f;
+        }
+        else if (strcmp(word, "dash") == 0)
+        {
+            ok = sscanf(buf, "%*s %f", &a) == 1;
+            c.type = BENCH_CMD_DASH; c.dist = a;
+        }
+        else if (strcmp(word, "chunk") == 0)
+        {
+            ok = sscanf(buf, "%*s %d %d", &c.cx, &c.cy) == 2;
+            c.type = BENCH_CMD_CHUNK;
+        }
+        else if (strcmp(word, "wait") == 0)
+        {
+            ok = sscanf(buf, "%*s %f", &f) == 1;
+            c.type = BENCH_CMD_WAIT; c.seconds = f;
+        }
+        else if (strcmp(word, "day") == 0) { c.type = BENCH_CMD_DAY; }
+        else if (strcmp(word, "night") == 0) { c.type = BENCH_CMD_NIGHT; }
+        else { ok = false; }
+
+        if (!ok)
+        {
+            TraceLog(LOG_WARNING, "BENCH: skipping bad line %d: %s", lineNo, buf);
+            continue;
+        }
+        if (!BenchPushCmd(b, c, &cap))
+        {
+            TraceLog(LOG_ERROR, "BENCH: out of memory parsing script");
+            break;
+        }
+    }
+    return b->cmdCount;
+}
+
+bool BenchLoadScript(BenchRun *b, const char *path)
+{
+    char *text = LoadFileText(path);
+    if (!text)
+    {
+        TraceLog(LOG_ERROR, "BENCH: could not read script %s", path);
+        return false;
+    }
+    BenchParseScript(b, text);
+    UnloadFileText(text);
+    snprintf(b->scriptName, sizeof(b->scriptName), "%s", path);
+    return b->cmdCount > 0;
+}
+
+void BenchFree(BenchRun *b)
+{
+    free(b->cmds);
+    free(b->frameMs);
+    memset(b, 0, sizeof(BenchRun));
+}
+
+static inline float BenchLerpAngle(float a, float b, float t)
+{
+    return a + (b - a) * t;
+}
+
+// Advance the path by one fixed step, pose is the camera state in and the wanted state out
+// returns false once the script is finished
+bool BenchStep(BenchRun *b, float dt, BenchPose *pose)
+{
+    pose->teleport = false;
+    pose->setDay = false;
+    if (b->cur >= b->cmdCount) return false;
+    BenchCmd *c = &b->cmds[b->cur];
+    if (b->segT == 0.0f)
+    {
+        b->segStart = *pose;
+        //face the way we travel
+        if (c->type == BENCH_CMD_FLY || c->type == BENCH_CMD_WALK)
+        {
+            Vector3 dir = Vector3Subtract(c->pos, pose->pos);
+            if (fabsf(dir.x) + fabsf(dir.z) > 0.001f) pose->yaw = b->segStart.yaw = atan2f(dir.z, dir.x);
+        }
+    }
+    b->segT += dt;
+    float t = c->seconds > 0.0f ? Clamp(b->segT / c->seconds, 0.0f, 1.0f) : 1.0f;
+    switch (c->type)
+    {
+        case BENCH_CMD_POSE:
+            pose->pos = c->pos; pose->yaw = c->yaw; pose->pitch = c->pitch; pose->ground = false;
+            break;
+        case BENCH_CMD_FLY:
+            pose->pos = Vector3Lerp(b->segStart.pos, c->pos, t); pose->ground = false;
+            break;
+        case BENCH_CMD_WALK:
+            pose->pos.x = Lerp(b->segStart.pos.x, c->pos.x, t);
+            pose->pos.z = Lerp(b->segStart.pos.z, c->pos.z, t);
+            pose->ground = true;
+            break;
+        case BENCH_CMD_LOOK:
+            pose->yaw = BenchLerpAngle(b->segStart.yaw, c->yaw, t);
+            pose->pitch = BenchLerpAngle(b->segStart.pitch, c->pitch, t);
+            break;
+        case BENCH_CMD_DASH:
+        {
+            Vector3 fwd = { cosf(pose->pitch)*cosf(pose->yaw), sinf(pose->pitch), cosf(pose->pitch)*sinf(pose->yaw) };
+            pose->pos = Vector3Add(pose->pos, Vector3Scale(fwd, c->dist));
+            pose->ground = true; //the mouse dash lands on the ground too
+        } break;
+        case BENCH_CMD_CHUNK:
+            pose->teleport = true; pose->cx = c->cx; pose->cy = c->cy; pose->ground = true;
+            break;
+        case BENCH_CMD_WAIT:
+            break;
+        case BENCH_CMD_DAY:
+        case BENCH_CMD_NIGHT:
+            pose->setDay = true; pose->day = c->type == BENCH_CMD_DAY;
+            break;
+    }
+    if (t >= 1.0f)
+    {
+        b->cur++;
+        b->segT = 0.0f;
+    }
+    return true;
+}
+
+static int BenchUploadTotal(BenchUploads u)
+{
+    return u.chunkTextures + u.chunkModels + u.tiles + u.tileUnloads;
+}
+
+// Call once per frame after ProfFrameEnd while running
+void BenchRecordFrame(BenchRun *b, int uploadsThisFrame, int drawCalls, size_t gpuBytes)
+{
+    if (b->frameCount >= b->frameCap)
+    {
+        int newCap = b->frameCap > 0 ? b->frameCap * 2 : 4096;
+        float *grown = (float *)realloc(b->frameMs, sizeof(float) * newCap);
+        if (!grown) return;
+        b->frameMs = grown;
+        b->frameCap = newCap;
+    }
+    int slot = ProfSlot(frameProfiler.count - 1);
+    b->frameMs[b->frameCount++] = frameProfiler.frameMs[slot];
+    for (int ph = 0; ph < PROF_PHASE_COUNT; ph++) b->phaseSum[ph] += frameProfiler.history[slot][ph];
+    if (uploadsThisFrame > b->maxUploadsFrame) b->maxUploadsFrame = uploadsThisFrame;
+    b->drawCallSum += drawCalls;
+    if (gpuBytes > b->peakGpuBytes) b->peakGpuBytes = gpuBytes;
+}
+
+// kB from /proc/self/status, VmHWM is the peak resident set
+long BenchReadProcStatusKb(const char *field)
+{
+    FILE *f = fopen("/proc/self/status", "r");
+    if (!f) return -1;
+    char line[256];
+    long kb = -1;
+    size_t n = strlen(field);
+    while (fgets(line, sizeof(line), f))
+    {
+        if (strncmp(line, field, n) == 0 && line[n] == ':')
+        {
+            sscanf(line + n + 1, "%ld", &kb);
+            break;
+        }
+    }
+    fclose(f);
+    return kb;
+}
+
+static int BenchCompareFloat(const void *a, const void *b)
+{
+    float fa = *(const float *)a, fb = *(const float *)b;
+    return (fa > fb) - (fa < fb);
+}
+
+// nearest rank on a sorted array
+static float BenchPercentile(const float *sorted, int n, float p)
+{
+    if (n <= 0) return 0.0f;
+    int idx = (int)ceilf(p / 100.0f * n) - 1;
+    if (idx < 0) idx = 0;
+    if (idx >= n) idx = n - 1;
+    return sorted[idx];
+}
+
+bool BenchWriteReport(BenchRun *b)
+{
+    FILE *f = fopen(b->outPath, "w");
+    if (!f)
+    {
+        TraceLog(LOG_ERROR, "BENCH: could not write %s", b->outPath);
+        return false;
+    }
+    int n = b->frameCount;
+    float *sorted = (float *)malloc(sizeof(float) * (n > 0 ? n : 1));
+    if (n > 0) memcpy(sorted, b->frameMs, sizeof(float) * n);
+    qsort(sorted, n, sizeof(float), BenchCompareFloat);
+    double sum = 0.0;
+    int hitches = 0, spikes = 0;
+    for (int i = 0; i < n; i++)
+    {
+        sum += b->frameMs[i];
+        if (b->frameMs[i] > BENCH_HITCH_MS) hitches++;
+        if (b->frameMs[i] > BENCH_SPIKE_MS) spikes++;
+    }
+    BenchUploads u = b->uploads;
+    u.chunkTextures -= b->uploadsAtStart.chunkTextures;
+    u.chunkModels -= b->uploadsAtStart.chunkModels;
+    u.tiles -= b->uploadsAtStart.tiles;
+    u.tileUnloads -= b->uploadsAtStart.tileUnloads;
+
+    fprintf(f, "{\n");
+    fprintf(f, "  \"script\": \"%s\",\n", b->scriptName);
+    fprintf(f, "  \"fixed_dt\": %.6f,\n", BENCH_DT);
+    fprintf(f, "  \"load_seconds\": %.3f,\n", b->loadSeconds);
+    fprintf(f, "  \"frames\": %d,\n", n);
+    fprintf(f, "  \"wall_seconds\": %.3f,\n", sum / 1000.0);
+    fprintf(f, "  \"frame_ms\": { \"min\": %.3f, \"avg\": %.3f, \"p50\": %.3f, \"p90\": %.3f, \"p95\": %.3f, \"p99\": %.3f, \"max\": %.3f },\n",
+            n ? sorted[0] : 0.0f, n ? sum / n : 0.0, BenchPercentile(sorted, n, 50), BenchPercentile(sorted, n, 90),
+            BenchPercentile(sorted, n, 95), BenchPercentile(sorted, n, 99), n ? sorted[n - 1] : 0.0f);
+    fprintf(f, "  \"hitches\": { \"over_%.0f_ms\": %d, \"over_%.0f_ms\": %d },\n", BENCH_HITCH_MS, hitches, BENCH_SPIKE_MS, spikes);
+    fprintf(f, "  \"phase_avg_ms\": {");
+    for (int ph = 0; ph < PROF_PHASE_COUNT; ph++)
+    {
+        fprintf(f, "%s \"%s\": %.3f", ph ? "," : "", ProfPhaseNames[ph], n ? b->phaseSum[ph] / n : 0.0);
+    }
+    fprintf(f, " },\n");
+    fprintf(f, "  \"uploads\": { \"chunk_textures\": %d, \"chunk_models\": %d, \"tiles\": %d, \"tile_unloads\": %d, \"max_per_frame\": %d },\n",
+            u.chunkTextures, u.chunkModels, u.tiles, u.tileUnloads, b->maxUploadsFrame);
+    fprintf(f, "  \"draw_calls_avg\": %.1f,\n", n ? (double)b->drawCallSum / n : 0.0);
+    fprintf(f, "  \"peak_ram_kb\": %ld,\n", BenchReadProcStatusKb("VmHWM"));
+    fprintf(f, "  \"peak_vram_bytes\": %zu\n", b->peakGpuBytes); //from memtrack.h
+    fprintf(f, "}\n");
+    fclose(f);
+    TraceLog(LOG_INFO, "BENCH: %d frames, p50 %.2f ms, p99 %.2f ms, %d hitches -> %s",
+             n, BenchPercentile(sorted, n, 50), BenchPercentile(sorted, n, 99), hitches, b->outPath);
+    free(sorted);
+    return true;
+}
+
+//recording, F5 in play, the file can be fed straight back to --bench
+FILE *benchRecordFile = NULL;
+
+void BenchToggleRecording(void)
+{
+    if (benchRecordFile)
+    {
+        fclose(benchRecordFile);
+        benchRecordFile = NULL;
+        TraceLog(LOG_INFO, "BENCH: recording stopped");
+        return;
+    }
+    time_t now = time(NULL);
+    struct tm *t = localtime(&now);
+    char filename[128];
+    strftime(filename, sizeof(filename), "bench_path_%Y%m%d_%H%M%S.txt", t);
+    benchRecordFile = fopen(filename, "w");
+    if (!benchRecordFile) { TraceLog(LOG_WARNING, "BENCH: could not open %s", filename); return; }
+    fprintf(benchRecordFile, "# recorded camera path, one pose per frame\n");
+    TraceLog(LOG_INFO, "BENCH: recording to %s", filename);
+}
+
+void BenchRecordPose(Vector3 pos, float yaw, float pitch)
+{
+    if (!benchRecordFile) return;
+    fprintf(benchRecordFile, "pose %.3f %.3f %.3f %.3f %.3f\n", pos.x, pos.y, pos.z, yaw*RAD2DEG, pitch*RAD2DEG);
+}
+
+#endif //BENCH_H
@@ -4,7 +4,7 @@
 LDFLAGS="-lraylib -lGL -lm -lpthread -ldl -lrt -lX11" 
 
 echo "start -> main (create)"
-gcc main.c -o create $LDFLAGS
+gcc -O3 main.c -o create $LDFLAGS #-O3, gcc 12 only vectorizes the flattening row loops at -O3 (check with -fopt-info-vec)
 echo "start -> preview (play)"
 gcc preview.c -o play $LDFLAGS
 echo "start -> study (lod)"
@@ -0,0 +1,118 @@
+#ifndef CHUNK_HASH_H
+#define CHUNK_HASH_H
+
+//content hashes for incremental export, a chunk whose inputs hash the same as last time is left alone
+//the hash sits next to the outputs (map/chunk_XX_YY/hash.txt) and is only written after the chunk is fully exported,
+//so a crash halfway leaves the old hash (or none) and the chunk is redone next time
+//also the tmp file + rename helpers, so readers never see half written manifests
+#include "raylib.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+typedef uint64_t ContentHash;
+
+#define CONTENT_HASH_INIT 1469598103934665603ULL //FNV-1a 64 offset basis
+#define CONTENT_HASH_PRIME 1099511628211ULL
+
+static inline ContentHash HashBytes(ContentHash h, const void *data, size_t size)
+{
+    const unsigned char *p = (const unsigned char *)data;
+    for (size_t i = 0; i < size; i++)
+    {
+        h ^= p[i];
+        h *= CONTENT_HASH_PRIME;
+    }
+    return h;
+}
+
+static inline ContentHash HashInt(ContentHash h, int v) { return HashBytes(h, &v, sizeof(v)); }
+static inline ContentHash HashFloat(ContentHash h, float v) { return HashBytes(h, &v, sizeof(v)); }
+
+// cells [x0, x0+w) x [y0, y0+h) of a size x size float map, clamped to the map like the kernels that read it
+ContentHash HashFloatWindow(ContentHash h, const float *data, int size, int x0, int y0, int w, int hgt)
+{
+    for (int y = y0; y < y0 + hgt; y++)
+    {
+        int cy = y < 0 ? 0 : (y >= size ? size - 1 : y);
+        for (int x = x0; x < x0 + w; x++)
+        {
+            int cx = x < 0 ? 0 : (x >= size ? size - 1 : x);
+            h = HashFloat(h, data[cy * size + cx]);
+        }
+    }
+    return h;
+}
+
+// same for an rgba8 image, cells outside it are skipped (GetImageColor gives them nothing either)
+ContentHash HashImageWindow(ContentHash h, Image img, int x0, int y0, int w, int hgt)
+{
+    if (img.data == NULL || img.format != PIXELFORMAT_UNCOMPRESSED_R8G8B8A8) return HashInt(h, -1);
+    const Color *pixels = (const Color *)img.data;
+    for (int y = y0; y < y0 + hgt; y++)
+    {
+        if (y < 0 || y >= img.height) continue;
+        int xa = x0 < 0 ? 0 : x0;
+        int xb = x0 + w > img.width ? img.width : x0 + w;
+        if (xb > xa) h = HashBytes(h, &pixels[y * img.width + xa], sizeof(Color) * (xb - xa));
+    }
+    return h;
+}
+
+static void ChunkHashPath(int cx, int cy, char *out, size_t size)
+{
+    snprintf(out, size, "map/chunk_%02d_%02d/hash.txt", cx, cy);
+}
+
+// false when the chunk has no hash yet
+bool ChunkHashRead(int cx, int cy, ContentHash *out)
+{
+    char path[64];
+    ChunkHashPath(cx, cy, path, sizeof(path));
+    FILE *f = fopen(path, "r");
+    if (!f) return false;
+    unsigned long long v = 0;
+    bool ok = fscanf(f, "%llx", &v) == 1;
+    fclose(f);
+    *out = (ContentHash)v;
+    return ok;
+}
+
+//------------------------------------------------------------------atomic writes
+// open path.tmp for writing, AtomicFileCommit renames it over path once everything is in it
+FILE *AtomicFileOpen(const char *path, const char *mode)
+{
+    char tmp[512];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    FILE *f = fopen(tmp, mode);
+    if (!f) TraceLog(LOG_WARNING, "ATOMIC: could not open %s", tmp);
+    return f;
+}
+
+bool AtomicFileCommit(FILE *f, const char *path)
+{
+    char tmp[512];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    bool ok = fflush(f) == 0 && !ferror(f);
+    fclose(f);
+    if (!ok || rename(tmp, path) != 0)
+    {
+        TraceLog(LOG_ERROR, "ATOMIC: could not replace %s", path);
+        remove(tmp);
+        return false;
+    }
+    return true;
+}
+
+bool ChunkHashWrite(int cx, int cy, ContentHash hash)
+{
+    char path[64];
+    ChunkHashPath(cx, cy, path, sizeof(path));
+    FILE *f = AtomicFileOpen(path, "w");
+    if (!f) return false;
+    fprintf(f, "%016llx\n", (unsigned long long)hash);
+    return AtomicFileCommit(f, path);
+}
+
+#endif //CHUNK_HASH_H
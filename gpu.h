@@ -25,13 +25,56 @@
 /////////THIS IS THE IMPORTANT ONE/////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-// Draw multiple mesh instances with material and different transforms, fro rpi5 with GRAPHICS_API_OPENGL_21
-void DrawMeshInstancedCustom(Mesh mesh, Material material, const Matrix *transforms, int instances)
+// Bind an instance transform buffer to the instanceTransform attribute (divisor 1), on the mesh VAO if there is one
+void AttachInstanceBuffer(Mesh mesh, Shader shader, unsigned int instancesVboId)
 {
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
-    // Instancing required variables
-    float16 *instanceTransforms = NULL;
+    // Enable mesh VAO to attach new buffer
+    rlEnableVertexArray(mesh.vaoId);
+    rlEnableVertexBuffer(instancesVboId);
+
+    // Instances transformation matrices are sent to shader attribute location: SHADER_LOC_VERTEX_INSTANCE_TX
+    for (unsigned int i = 0; i < 4; i++)
+    {
+        rlEnableVertexAttribute(shader.locs[SHADER_LOC_VERTEX_INSTANCE_TX] + i);
+        rlSetVertexAttribute(shader.locs[SHADER_LOC_VERTEX_INSTANCE_TX] + i, 4, RL_FLOAT, 0, sizeof(Matrix), i*sizeof(Vector4));
+        //rlSetVertexAttributeDivisor(shader.locs[SHADER_LOC_VERTEX_INSTANCE_TX] + i, 1);
+        glVertexAttribDivisor(shader.locs[SHADER_LOC_VERTEX_INSTANCE_TX] + i, 1);//CHANGED THIS LINE!!!!
+    }
+
+    rlDisableVertexBuffer();
+    rlDisableVertexArray();
+#endif
+}
+
+// Upload instance transforms once, for instances that never move (stars), returns the vbo id (0 on failure)
+// the buffer stays attached to the mesh VAO, so draw it with DrawMeshInstancedStatic and free with rlUnloadVertexBuffer
+unsigned int LoadInstanceBuffer(Mesh mesh, Shader shader, const Matrix *transforms, int instances)
+{
     unsigned int instancesVboId = 0;
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    float16 *instanceTransforms = (float16 *)RL_MALLOC(instances*sizeof(float16));
+    if (instanceTransforms == NULL) return 0;
+    for (int i = 0; i < instances; i++) instanceTransforms[i] = MatrixToFloatV(transforms[i]);
+
+    rlEnableVertexArray(mesh.vaoId);
+    instancesVboId = rlLoadVertexBuffer(instanceTransforms, instances*sizeof(float16), false);
+    rlDisableVertexArray();
+    RL_FREE(instanceTransforms);
+
+    if (instancesVboId != 0) AttachInstanceBuffer(mesh, shader, instancesVboId);
+    else TraceLog(LOG_WARNING, "INSTANCING: failed to upload %d instance transforms", instances);
+#endif
+    return instancesVboId;
+}
+
+// Draw instances from a buffer that is already attached (LoadInstanceBuffer or AttachInstanceBuffer), no per frame upload
+void DrawMeshInstancedStatic(Mesh mesh, Material material, unsigned int instancesVboId, int instances)
+{
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    if (instancesVboId == 0 || instances <= 0) return;
+    // Without VAOs the attribute state is global and gets stomped by other draws, so bind it again
+    if (mesh.vaoId == 0) AttachInstanceBuffer(mesh, material.shader, instancesVboId);
 
     // Bind shader program
     rlEnableShader(material.shader.id);
@@ -78,33 +121,6 @@ void DrawMeshInstancedCustom(Mesh mesh, Material material, const Matrix *transfo
     if (material.shader.locs[SHADER_LOC_MATRIX_VIEW] != -1) rlSetUniformMatrix(material.shader.locs[SHADER_LOC_MATRIX_VIEW], matView);
     if (material.shader.locs[SHADER_LOC_MATRIX_PROJECTION] != -1) rlSetUniformMatrix(material.shader.locs[SHADER_LOC_MATRIX_PROJECTION], matProjection);
 
-    // Create instances buffer
-    instanceTransforms = (float16 *)RL_MALLOC(instances*sizeof(float16));
-
-    // Fill buffer with instances transformations as float16 arrays
-    for (int i = 0; i < instances; i++) instanceTransforms[i] = MatrixToFloatV(transforms[i]);
-
-    // Enable mesh VAO to attach new buffer
-    rlEnableVertexArray(mesh.vaoId);
-
-    // This could alternatively use a static VBO and either glMapBuffer() or glBufferSubData()
-    // It isn't clear which would be reliably faster in all cases and on all platforms,
-    // anecdotally glMapBuffer() seems very slow (syncs) while glBufferSubData() seems
-    // no faster, since we're transferring all the transform matrices anyway
-    instancesVboId = rlLoadVertexBuffer(instanceTransforms, instances*sizeof(float16), false);
-
-    // Instances transformation matrices are sent to shader attribute location: SHADER_LOC_VERTEX_INSTANCE_TX
-    for (unsigned int i = 0; i < 4; i++)
-    {
-        rlEnableVertexAttribute(material.shader.locs[SHADER_LOC_VERTEX_INSTANCE_TX] + i);
-        rlSetVertexAttribute(material.shader.locs[SHADER_LOC_VERTEX_INSTANCE_TX] + i, 4, RL_FLOAT, 0, sizeof(Matrix), i*sizeof(Vector4));
-        //rlSetVertexAttributeDivisor(material.shader.locs[SHADER_LOC_VERTEX_INSTANCE_TX] + i, 1);
-        glVertexAttribDivisor(material.shader.locs[SHADER_LOC_VERTEX_INSTANCE_TX] + i, 1);//CHANGED THIS LINE!!!!
-    }
-
-    rlDisableVertexBuffer();
-    rlDisableVertexArray();
-
     // Accumulate internal matrix transform (push/pop) and view matrix
     // NOTE: In this case, model instance transformation must be computed in the shader
     matModelView = MatrixMultiply(rlGetMatrixTransform(), matView);
@@ -264,10 +280,24 @@ void DrawMeshInstancedCustom(Mesh mesh, Material material, const Matrix *transfo
 
     // Disable shader program
     rlDisableShader();
+#endif
+}
+
+// Draw multiple mesh instances with material and different transforms, fro rpi5 with GRAPHICS_API_OPENGL_21
+void DrawMeshInstancedCustom(Mesh mesh, Material material, const Matrix *transforms, int instances)
+{
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    if (instances <= 0) return;
+    // This could alternatively use a static VBO and either glMapBuffer() or glBufferSubData()
+    // It isn't clear which would be reliably faster in all cases and on all platforms,
+    // anecdotally glMapBuffer() seems very slow (syncs) while glBufferSubData() seems
+    // no faster, since we're transferring all the transform matrices anyway
+    // (things that never move should use LoadInstanceBuffer + DrawMeshInstancedStatic instead)
+    unsigned int instancesVboId = LoadInstanceBuffer(mesh, material.shader, transforms, instances);
+    DrawMeshInstancedStatic(mesh, material, instancesVboId, instances);
 
     // Remove instance transforms buffer
     rlUnloadVertexBuffer(instancesVboId);
-    RL_FREE(instanceTransforms);
 #endif
 }
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -5,6 +5,13 @@
 #include "stb_perlin.h"
 
 #include "models.h"
+#include "stage_timer.h"
+#include "world.h"
+#include "tilestore.h"
+#include "chunk_hash.h"
+#include "parallel.h"
+#include "morphology.h"
+#include "mipmap.h"
 #include <math.h>
 #include <stdio.h>
 #include <float.h>
@@ -31,20 +38,18 @@ void EnsureDirectoryExists(const char *path) {
     }
 }
 //********************************** */
-#define CHUNK_SIZE 64
-#define MAP_SIZE 1024
-#define CHUNK_COUNT (MAP_SIZE / CHUNK_SIZE)
+//CHUNK_SIZE, CHUNK_COUNT, MAP_SIZE, MAP_SCALE, TILE_GRID_SIZE, CHUNK_WORLD_SIZE come from world.h (runtime, --chunks/--tile-grid)
 #define MAP_SIZE_SCALE 0.5f
-#define HEIGHT_SCALE 60.0f
-#define MAP_SCALE 16
-#define UPSCALED_TEXTURE_SIZE 1024
+#define HEIGHT_SCALE (world.heightScale)
+#define UPSCALED_TEXTURE_SIZE (world.textureSize)
 
-#define ROAD_MAP_SIZE 1024
-#define NUM_FEATURE_POINTS 512
+#define ROAD_MAP_SIZE (MAP_SIZE) //one road cell per height map cell, the road/slope/flatten loops take it as their stride
+#define FEATURE_POINT_AREA 2048 //cells per road feature point, the 512 points the roads were tuned with on a 1024 map
 #define FEATURE_SPACING 64  // test with 16, 32, or 64 pixels
 #define FLATTEN_RADIUS 2
 #define FLATTEN_STRENGTH 0.0034f //james bond, 0.007f is a bit strong with the new flattening, but creates really nice ridges.
 #define FLATTEN_LERP_FACT 0.42f
+#define WORLEY_CELL 64 //feature point buckets, one point per FEATURE_POINT_AREA cells is ~2 per cell
 
 //fpr trees/props
 #define ASSET_TWEAK_MOD 5000
@@ -62,9 +67,7 @@ void EnsureDirectoryExists(const char *path) {
 #define MIN_HEIGHT           0.0f
 
 //for baking cookies
-#define TILE_GRID_SIZE 8 //sync with preview.c
 #define TILE_SIZE (CHUNK_SIZE / TILE_GRID_SIZE)
-#define CHUNK_WORLD_SIZE 1024.0f
 #define TILE_WORLD_SIZE (CHUNK_WORLD_SIZE / TILE_GRID_SIZE)
 
 //WATER
@@ -95,6 +98,7 @@ typedef struct {
     snprintf(buf, sizeof(buf), "map/chunk_%02d_%02d/tile_64/%02d_%02d/", cx, cy, tx, ty)
 //max value (there is probably an easier way to do this but chatgpt gave me this cool code so I thought I would use it)
 #define MAX(a, b) ((a) > (b) ? (a) : (b))
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
 
 //models we use for tile batching (all static props)
 //Model tree, treeBg, rock; -> static prop models handled mostly in models.h
@@ -202,10 +206,13 @@ void BakeTileObjects(int cx, int cy, int tx, int ty, EnvObject *objects, int cou
     char modelPath[512];
     snprintf(modelPath, sizeof(modelPath), "%stile_%s_64.obj", folderPath, tileObjectType);
     EnsureDirectoryExists(folderPath);
-    ExportMesh(merged, modelPath);
+    TimedExportMesh(merged, modelPath);
     //UnloadModel(model);
     UnloadMesh(merged);
-    FILE *f = fopen("map/manifest.txt", "a"); // Open for append
+    //per chunk manifest, ExportMap glues them into map/manifest.txt, so chunks that are skipped keep their lines
+    char chunkManifest[64];
+    snprintf(chunkManifest, sizeof(chunkManifest), "map/chunk_%02d_%02d/manifest.txt", cx, cy);
+    FILE *f = fopen(chunkManifest, "a"); // Open for append
     if (f != NULL) {
         fprintf(f, "%d %d %d %d %d %s\n", cx,cy,tx,ty,type,modelPath);  // modelPath is the filename you saved to
         fclose(f);
@@ -215,7 +222,7 @@ void BakeTileObjects(int cx, int cy, int tx, int ty, EnvObject *objects, int cou
 
 void ExportBatchTiles(int cx, int cy, StaticGameObject *props, int totalPropCount, Model_Type mt) {
     // Step 1: Count trees per tile
-    int tileCounts[TILE_GRID_SIZE][TILE_GRID_SIZE] = { 0 };
+    int tileCounts[WORLD_MAX_TILE_GRID][WORLD_MAX_TILE_GRID] = { 0 }; //only the first TILE_GRID_SIZE rows/cols are used
     for (int i = 0; i < totalPropCount; i++) {
         if(props[i].type==mt)
         {
@@ -260,14 +267,15 @@ void ExportBatchTiles(int cx, int cy, StaticGameObject *props, int totalPropCoun
 }
 //ding cookes are done hehe
 
-Vector2 featurePoints[NUM_FEATURE_POINTS];
 Image roadImage;
 Image hardRoadMap;
 
-Model chunkModels[CHUNK_COUNT][CHUNK_COUNT]; // 16x16 = 256 chunks
-Model chunkModels32[CHUNK_COUNT][CHUNK_COUNT]; // 16x16 = 256 chunks
-Model chunkModels16[CHUNK_COUNT][CHUNK_COUNT]; // 16x16 = 256 chunks
-Model chunkModels8[CHUNK_COUNT][CHUNK_COUNT]; // 16x16 = 256 chunks
+//CHUNK_COUNT x CHUNK_COUNT each, allocated in main once the world is known (rows are WORLD_MAX_CHUNK_COUNT wide so [cx][cy] still works)
+typedef Model ChunkModelRow[WORLD_MAX_CHUNK_COUNT];
+ChunkModelRow *chunkModels;
+ChunkModelRow *chunkModels32;
+ChunkModelRow *chunkModels16;
+ChunkModelRow *chunkModels8;
 
 static inline float Clampf(float value, float min, float max) {
     return (value < min) ? min : (value > max) ? max : value;
@@ -290,15 +298,16 @@ Color AverageColor(Color a, Color b) {
     return result;
 }
 
-float GetSlopeAt(int x, int y, Color *terrainData)
+// terrainData is size x size
+float GetSlopeAt(int x, int y, Color *terrainData, int size)
 {
     // Avoid edges
-    if (x <= 0 || y <= 0 || x >= ROAD_MAP_SIZE - 1 || y >= ROAD_MAP_SIZE - 1) return 0.0f;
+    if (x <= 0 || y <= 0 || x >= size - 1 || y >= size - 1) return 0.0f;
 
-    float hL = terrainData[y * ROAD_MAP_SIZE + (x - 1)].r / 255.0f;
-    float hR = terrainData[y * ROAD_MAP_SIZE + (x + 1)].r / 255.0f;
-    float hU = terrainData[(y - 1) * ROAD_MAP_SIZE + x].r / 255.0f;
-    float hD = terrainData[(y + 1) * ROAD_MAP_SIZE + x].r / 255.0f;
+    float hL = terrainData[y * size + (x - 1)].r / 255.0f;
+    float hR = terrainData[y * size + (x + 1)].r / 255.0f;
+    float hU = terrainData[(y - 1) * size + x].r / 255.0f;
+    float hD = terrainData[(y + 1) * size + x].r / 255.0f;
 
     float dx = (hR - hL) * 0.5f;
     float dy = (hD - hU) * 0.5f;
@@ -306,27 +315,115 @@ float GetSlopeAt(int x, int y, Color *terrainData)
     return sqrtf(dx * dx + dy * dy);
 }
 
-void GenerateWorleyRoadMap(Image *outImage, Image *hardMap, Color *terrainColorData, Color *terrainData) {
-    const int SIZE = ROAD_MAP_SIZE;
-    const float threshold = 0.78f;  // adjust for road width
-    const float minEdge = 0.05f;  // Skip exact feature point centers
+//feature points bucketed into a uniform grid, cellStart[c]..cellStart[c+1] index into points (counting sort)
+typedef struct {
+    float ox, oy;        // world position of cell 0,0
+    int w, h;            // cells
+    int *cellStart;      // w*h+1
+    Vector2 *points;     // featurePoints sorted by cell
+} WorleyGrid;
+
+bool WorleyGridBuild(WorleyGrid *g, const Vector2 *pts, int count, int size)
+{
+    //cover the map and every point (the random extras can land past the road map when the world is bigger)
+    float minX = 0, minY = 0, maxX = (float)size, maxY = (float)size;
+    for (int i = 0; i < count; i++) {
+        minX = fminf(minX, pts[i].x); maxX = fmaxf(maxX, pts[i].x + 1);
+        minY = fminf(minY, pts[i].y); maxY = fmaxf(maxY, pts[i].y + 1);
+    }
+    g->ox = minX;
+    g->oy = minY;
+    g->w = (int)ceilf((maxX - minX) / WORLEY_CELL);
+    g->h = (int)ceilf((maxY - minY) / WORLEY_CELL);
+    g->cellStart = (int *)calloc(g->w * g->h + 1, sizeof(int));
+    g->points = (Vector2 *)malloc(sizeof(Vector2) * (count > 0 ? count : 1));
+    int *cellOf = (int *)malloc(sizeof(int) * (count > 0 ? count : 1));
+    if (!g->cellStart || !g->points || !cellOf) {
+        TraceLog(LOG_ERROR, "WORLEY: out of memory for the point grid");
+        free(g->cellStart); free(g->points); free(cellOf);
+        return false;
+    }
+    for (int i = 0; i < count; i++) {
+        int cx = MIN((int)((pts[i].x - g->ox) / WORLEY_CELL), g->w - 1);
+        int cy = MIN((int)((pts[i].y - g->oy) / WORLEY_CELL), g->h - 1);
+        cellOf[i] = cy * g->w + cx;
+        g->cellStart[cellOf[i] + 1]++;
+    }
+    for (int c = 0; c < g->w * g->h; c++) g->cellStart[c + 1] += g->cellStart[c];
+    int *fill = (int *)malloc(sizeof(int) * g->w * g->h);
+    memcpy(fill, g->cellStart, sizeof(int) * g->w * g->h);
+    for (int i = 0; i < count; i++) g->points[fill[cellOf[i]]++] = pts[i];
+    free(fill);
+    free(cellOf);
+    return true;
+}
+
+void WorleyGridFree(WorleyGrid *g)
+{
+    free(g->cellStart);
+    free(g->points);
+    g->cellStart = NULL;
+    g->points = NULL;
+}
 
-    for (int y = 0; y < SIZE; y++) {
-        for (int x = 0; x < SIZE; x++) {
-            float d1 = 1e9f, d2 = 1e9f;
-            for (int i = 0; i < NUM_FEATURE_POINTS; i++) {
-                float dx = (float)(featurePoints[i].x - x);
-                float dy = (float)(featurePoints[i].y - y);
-                float dist = dx*dx + dy*dy;
-
-                if (dist < d1) {
-                    d2 = d1;
-                    d1 = dist;
-                } else if (dist < d2) {
-                    d2 = dist;
+// squared distance to the nearest and second nearest point, same numbers the brute force loop over every point gave
+// rings of cells go outward until nothing past the ring can beat d2
+static void WorleyNearest2(const WorleyGrid *g, int x, int y, float *outD1, float *outD2)
+{
+    float d1 = 1e9f, d2 = 1e9f;
+    int gx = (int)((x - g->ox) / WORLEY_CELL);
+    int gy = (int)((y - g->oy) / WORLEY_CELL);
+    int maxRing = MAX(MAX(gx, g->w - 1 - gx), MAX(gy, g->h - 1 - gy));
+    for (int r = 0; r <= maxRing; r++) {
+        for (int cy = gy - r; cy <= gy + r; cy++) {
+            if (cy < 0 || cy >= g->h) continue;
+            bool edgeRow = (cy == gy - r || cy == gy + r);
+            for (int cx = gx - r; cx <= gx + r; cx += (edgeRow || r == 0) ? 1 : 2 * r) {
+                if (cx < 0 || cx >= g->w) continue;
+                int c = cy * g->w + cx;
+                for (int i = g->cellStart[c]; i < g->cellStart[c + 1]; i++) {
+                    float dx = (float)(g->points[i].x - x);
+                    float dy = (float)(g->points[i].y - y);
+                    float dist = dx*dx + dy*dy;
+
+                    if (dist < d1) {
+                        d2 = d1;
+                        d1 = dist;
+                    } else if (dist < d2) {
+                        d2 = dist;
+                    }
                 }
             }
-            Color baseColor = terrainColorData[y * ROAD_MAP_SIZE + x];
+        }
+        //every point outside the rings so far is further than the closest edge of the block they cover
+        float gapX = fminf(x - (g->ox + (gx - r) * WORLEY_CELL), g->ox + (gx + r + 1) * WORLEY_CELL - x);
+        float gapY = fminf(y - (g->oy + (gy - r) * WORLEY_CELL), g->oy + (gy + r + 1) * WORLEY_CELL - y);
+        float gap = fminf(gapX, gapY);
+        if (gap * gap >= d2) break;
+    }
+    *outD1 = d1;
+    *outD2 = d2;
+}
+
+typedef struct {
+    const WorleyGrid *grid;
+    int size;                // every buffer is size x size
+    Color *road;
+    Color *hard;
+    Color *terrainColorData;
+    Color *terrainData;
+} WorleyJob;
+
+static void WorleyRows(int y0, int y1, void *ctx)
+{
+    WorleyJob *job = (WorleyJob *)ctx;
+    const float threshold = 0.78f;  // adjust for road width
+    const float minEdge = 0.05f;  // Skip exact feature point centers
+
+    int size = job->size;
+    for (int y = y0; y < y1; y++) {
+        for (int x = 0; x < size; x++) {
+            Color baseColor = job->terrainColorData[y * size + x];
 
             // Classify undesirable surfaces
             bool isBadSurface =
@@ -337,95 +434,34 @@ void GenerateWorleyRoadMap(Image *outImage, Image *hardMap, Color *terrainColorD
             // Snow
             (baseColor.r == 255 && baseColor.g == 255 && baseColor.b == 255);
 
-            float slope = GetSlopeAt(x, y, terrainData);
+            float slope = GetSlopeAt(x, y, job->terrainData, size);
             bool isTooSteep = slope > 0.3f; // tweak this - note, 0-roughtly 0.707, 0.42 is a little high, roughly 60% slope//
+            if (isBadSurface || isTooSteep) continue; //no road here whatever the distances say
 
+            float d1, d2;
+            WorleyNearest2(job->grid, x, y, &d1, &d2);
             float edgeVal = fabsf(sqrtf(d2) - sqrtf(d1));
-            if (edgeVal < threshold && edgeVal > minEdge && !isBadSurface && !isTooSteep) {
-                ImageDrawPixel(outImage, x, y, (Color){ 140, 120, 100, 255 }); // dirt
-                ImageDrawPixel(hardMap, x, y, WHITE); // road mask
-            }
-        }
-    }
-}
-
-void ExpandRoadPaths(Image *hardMap, int radius) {
-    Color *pixels = (Color *)hardMap->data;
-    Color *copy = malloc(sizeof(Color) * ROAD_MAP_SIZE * ROAD_MAP_SIZE);
-    memcpy(copy, pixels, sizeof(Color) * ROAD_MAP_SIZE * ROAD_MAP_SIZE);
-
-    for (int y = 0; y < ROAD_MAP_SIZE; y++) {
-        for (int x = 0; x < ROAD_MAP_SIZE; x++) {
-            int idx = y * ROAD_MAP_SIZE + x;
-            if (copy[idx].r > 200) {
-                // Expand out in a square radius
-                for (int dy = -radius; dy <= radius; dy++) {
-                    for (int dx = -radius; dx <= radius; dx++) {
-                        int nx = x + dx;
-                        int ny = y + dy;
-                        if ((unsigned)nx >= ROAD_MAP_SIZE || (unsigned)ny >= ROAD_MAP_SIZE) continue;
-                        pixels[ny * ROAD_MAP_SIZE + nx] = WHITE;
-                    }
-                }
+            if (edgeVal < threshold && edgeVal > minEdge) {
+                job->road[y * size + x] = (Color){ 140, 120, 100, 255 }; // dirt
+                job->hard[y * size + x] = WHITE; // road mask
             }
         }
     }
-
-    free(copy);
 }
 
-void FilterSmallRoadBlobs(Image *hardMap, int minSize) 
-{
-    Color *pixels = (Color *)hardMap->data;  // in-place
-    bool *visited = calloc(ROAD_MAP_SIZE * ROAD_MAP_SIZE, sizeof(bool));
-    int total = ROAD_MAP_SIZE * ROAD_MAP_SIZE;
-    int *stack = malloc(sizeof(int) * total);
-    int *blob  = malloc(sizeof(int) * total);
-
-    for (int y = 0; y < ROAD_MAP_SIZE; y++) {
-        for (int x = 0; x < ROAD_MAP_SIZE; x++) {
-            int idx = y * ROAD_MAP_SIZE + x;
-            if (visited[idx] || pixels[idx].r <= 200) continue;
-
-            int stackSize = 0, blobSize = 0;
-            stack[stackSize++] = idx;
-
-            while (stackSize > 0) {
-                int cur = stack[--stackSize];
-                if (visited[cur]) continue;
-                visited[cur] = true;
-                blob[blobSize++] = cur;
-
-                int cx = cur % ROAD_MAP_SIZE;
-                int cy = cur / ROAD_MAP_SIZE;
-
-                for (int oy = -1; oy <= 1; oy++) {
-                    for (int ox = -1; ox <= 1; ox++) {
-                        if (!ox && !oy) continue;
-                        int nx = cx + ox;
-                        int ny = cy + oy;
-                        if ((unsigned)nx >= ROAD_MAP_SIZE || (unsigned)ny >= ROAD_MAP_SIZE) continue;
-                        int ni = ny * ROAD_MAP_SIZE + nx;
-                        if (!visited[ni] && pixels[ni].r > 200) {
-                            stack[stackSize++] = ni;
-                        }
-                    }
-                }
-            }
-
-            if (blobSize < minSize) {
-                for (int i = 0; i < blobSize; i++) pixels[blob[i]] = BLACK;
-            }
-        }
-    }
-
-    free(stack);
-    free(blob);
-    free(visited);
+// roads sit on the edges between worley cells (d2 - d1 small), rows run in parallel straight into both images
+// both images and both terrain buffers are the same size, square
+void GenerateWorleyRoadMap(Image *outImage, Image *hardMap, Color *terrainColorData, Color *terrainData, const Vector2 *points, int pointCount) {
+    int size = outImage->width;
+    WorleyGrid grid;
+    if (!WorleyGridBuild(&grid, points, pointCount, size)) return;
+    //both come from GenImageColor so they are rgba8
+    WorleyJob job = { &grid, size, (Color *)outImage->data, (Color *)hardMap->data, terrainColorData, terrainData };
+    ParallelFor(size, WorleyRows, &job);
+    WorleyGridFree(&grid);
 }
 
-
-void ClampMeshEdges(Model chunks[CHUNK_COUNT][CHUNK_COUNT], int lodSize) {
+void ClampMeshEdges(ChunkModelRow *chunks, int lodSize) {
     for (int cy = 0; cy < CHUNK_COUNT; cy++) {
         for (int cx = 0; cx < CHUNK_COUNT; cx++) {
             Mesh *mesh = &(chunks[cx][cy].meshes[0]);
@@ -500,7 +536,8 @@ float GetNoiseValue(float x, float y, float frequency, int octaves, int seed, fl
     return total / maxValue;
 }
 
-void GenerateHeightmap(float *heightData, int width, int height, float scale, float frequency, int octaves, int seed, float lacunarity)
+// noise for the w x h block at (x0, y0) of a worldSize map, the noise only depends on the global cell so tiles line up
+void GenerateHeightmapRegion(float *heightData, int x0, int y0, int w, int h, int worldSize, float scale, float frequency, int octaves, int seed, float lacunarity)
 {
     // Params — let these be tweakable via keys
     float baseFreq = frequency;
@@ -518,10 +555,10 @@ void GenerateHeightmap(float *heightData, int width, int height, float scale, fl
     float heightAmplify = 1.5f;
     float elevationOffset = 0.2f;
 
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            float nx = ((float)x - width / 2.0f) / width * scale;
-            float ny = ((float)y - height / 2.0f) / height * scale;
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            float nx = ((float)(x0 + x) - worldSize / 2.0f) / worldSize * scale;
+            float ny = ((float)(y0 + y) - worldSize / 2.0f) / worldSize * scale;
 
             float base = GetNoiseValue(nx, ny, baseFreq, baseOctaves, seed, baseLacunarity);
             float detail = GetNoiseValue(nx, ny, detailFreq, detailOctaves, seed+100, detailLacunarity);
@@ -532,65 +569,201 @@ void GenerateHeightmap(float *heightData, int width, int height, float scale, fl
             float val = base + detail * detailStrength * mask;
 
             val = val * heightAmplify + elevationOffset;
-            heightData[y * width + x] = Clampf(val, -1.0f, 1.0f);
+            heightData[y * w + x] = Clampf(val, -1.0f, 1.0f);
         }
     }
 }
 
-void ApplyFastBoxBlur(Color *pixels, int width, int height, int kernelSize, bool useAvg) {
-    int step = kernelSize / 4;
-    if (step < 1) step = 1;
+void GenerateHeightmap(float *heightData, int width, int height, float scale, float frequency, int octaves, int seed, float lacunarity)
+{
+    GenerateHeightmapRegion(heightData, 0, 0, width, height, width, scale, frequency, octaves, seed, lacunarity);
+}
 
-    Color *copy = malloc(sizeof(Color) * width * height);
-    memcpy(copy, pixels, sizeof(Color) * width * height);
+//the blur only looks at every step-th pixel (step = kernel/4) and fills the step x step block from there,
+//so sums are only needed at those samples: each row gets a prefix sum, the sample columns read their window out of it,
+//and a running sum per sample column slides down the rows (each row goes in once and out once), kernel size does not matter
+typedef struct {
+    Color *pixels;
+    const Color *copy;   // the pixels before this pass, every window reads these
+    int width, height;
+    int half;            // kernelSize / 2, windows are 2*half+1
+    int step;
+    int samplesX;
+    bool useAvg;
+} BoxBlurJob;
+
+// r, g, b window sums of one row at every sample column, out is 3 planes of samplesX
+static void BoxBlurRowSums(const BoxBlurJob *job, int y, int *prefix, int *out)
+{
+    const Color *row = &job->copy[y * job->width];
+    int w = job->width;
+    int *pr = prefix, *pg = prefix + (w + 1), *pb = prefix + 2 * (w + 1);
+    pr[0] = pg[0] = pb[0] = 0;
+    for (int x = 0; x < w; x++) {
+        pr[x + 1] = pr[x] + row[x].r;
+        pg[x + 1] = pg[x] + row[x].g;
+        pb[x + 1] = pb[x] + row[x].b;
+    }
+    int n = job->samplesX;
+    for (int i = 0; i < n; i++) {
+        int x = i * job->step;
+        int a = x - job->half < 0 ? 0 : x - job->half;
+        int b = (x + job->half >= w ? w - 1 : x + job->half) + 1;
+        out[i] = pr[b] - pr[a];
+        out[n + i] = pg[b] - pg[a];
+        out[2 * n + i] = pb[b] - pb[a];
+    }
+}
 
-    for (int y = 0; y < height; y += step) {
-        //TraceLog(LOG_INFO, "y even bother ? %d", y);
-        for (int x = 0; x < width; x += step) {
-            int r = 0, g = 0, b = 0, count = 0;
-
-            for (int dy = -kernelSize / 2; dy <= kernelSize / 2; dy++) {
-                for (int dx = -kernelSize / 2; dx <= kernelSize / 2; dx++) {
-                    int nx = x + dx;
-                    int ny = y + dy;
-                    if (nx >= 0 && ny >= 0 && nx < width && ny < height) {
-                        Color c = copy[ny * width + nx];
-                        r += c.r; g += c.g; b += c.b;
-                        count++;
-                    }
-                }
-            }
+static void BoxBlurRowAdd(int *restrict acc, const int *restrict sums, int count, int sign)
+{
+    for (int i = 0; i < count; i++) acc[i] += sign * sums[i];
+}
 
+static void BoxBlurRows(int s0, int s1, void *ctx)
+{
+    BoxBlurJob *job = (BoxBlurJob *)ctx;
+    int w = job->width, h = job->height, n = job->samplesX, step = job->step;
+    int *prefix = (int *)malloc(sizeof(int) * 3 * (w + 1));
+    int *sums = (int *)malloc(sizeof(int) * 3 * n);
+    int *acc = (int *)calloc(3 * n, sizeof(int));
+    int pa = 0, pb = -1; //rows in acc right now
+
+    for (int si = s0; si < s1; si++) {
+        int y = si * step;
+        int a = y - job->half < 0 ? 0 : y - job->half;
+        int b = y + job->half >= h ? h - 1 : y + job->half;
+        if (a > pb) { //no overlap with the last window (first sample, or step > kernel)
+            memset(acc, 0, sizeof(int) * 3 * n);
+            pa = a;
+            pb = a - 1;
+        }
+        for (int r = pa; r < a; r++) {
+            BoxBlurRowSums(job, r, prefix, sums);
+            BoxBlurRowAdd(acc, sums, 3 * n, -1);
+        }
+        for (int r = pb + 1; r <= b; r++) {
+            BoxBlurRowSums(job, r, prefix, sums);
+            BoxBlurRowAdd(acc, sums, 3 * n, 1);
+        }
+        pa = a;
+        pb = b;
+
+        int countY = b - a + 1;
+        for (int i = 0; i < n; i++) {
+            int x = i * step;
+            int xa = x - job->half < 0 ? 0 : x - job->half;
+            int xb = x + job->half >= w ? w - 1 : x + job->half;
+            int count = countY * (xb - xa + 1);
             Color avg = {
-                .r = r / count,
-                .g = g / count,
-                .b = b / count,
+                .r = acc[i] / count,
+                .g = acc[n + i] / count,
+                .b = acc[2 * n + i] / count,
                 .a = 255
             };
 
             // Fill step x step block with the average color
-            for (int fy = 0; fy < step; fy++) {
-                for (int fx = 0; fx < step; fx++) {
-                    int tx = x + fx;
-                    int ty = y + fy;
-                    if (tx < width && ty < height) {
-                        if(useAvg)
-                        {pixels[ty * width + tx] = AverageColor(avg, pixels[ty * width + tx]);}
-                        else
-                        {pixels[ty * width + tx] = avg;}
-                    }
+            for (int ty = y; ty < y + step && ty < h; ty++) {
+                for (int tx = x; tx < x + step && tx < w; tx++) {
+                    if (job->useAvg) job->pixels[ty * w + tx] = AverageColor(avg, job->pixels[ty * w + tx]);
+                    else job->pixels[ty * w + tx] = avg;
                 }
             }
         }
     }
 
+    free(prefix);
+    free(sums);
+    free(acc);
+}
+
+void ApplyFastBoxBlur(Color *pixels, int width, int height, int kernelSize, bool useAvg) {
+    int step = kernelSize / 4;
+    if (step < 1) step = 1;
+
+    Color *copy = malloc(sizeof(Color) * width * height);
+    memcpy(copy, pixels, sizeof(Color) * width * height);
+
+    BoxBlurJob job = { pixels, copy, width, height, kernelSize / 2, step, (width + step - 1) / step, useAvg };
+    ParallelFor((height + step - 1) / step, BoxBlurRows, &job); //sample rows fill disjoint pixel rows
+
     free(copy);
 }
+// counter based random, the nth number for a key is always the same no matter which process or thread asks, or in what order
+static inline unsigned int CounterRandom(unsigned int key, unsigned int counter)
+{
+    unsigned int h = key * 0x9E3779B9u ^ counter * 0x85EBCA6Bu;
+    h ^= h >> 16;
+    h *= 0x7FEB352Du;
+    h ^= h >> 15;
+    h *= 0x846CA68Bu;
+    h ^= h >> 16;
+    return h;
+}
+
+typedef struct {
+    const Color *src;
+    int srcW;
+    const int *srcX;     // source column for every output column
+    Color *dst;
+    int size;
+    int srcH;
+    unsigned int key;
+} UpscaleJitterJob;
+
+static void UpscaleJitterRows(int y0, int y1, void *ctx)
+{
+    UpscaleJitterJob *job = (UpscaleJitterJob *)ctx;
+    int n = job->size;
+    const int *restrict srcX = job->srcX;
+    unsigned int key = job->key;
+    Color *restrict line = (Color *)malloc(sizeof(Color) * n);
+    for (int y = y0; y < y1; y++) {
+        //the column lookup is a gather, done on its own so the jitter loop only sees contiguous rows
+        const Color *restrict srcRow = &job->src[((y * job->srcH) / n) * job->srcW];
+        for (int x = 0; x < n; x++) line[x] = srcRow[srcX[x]];
+
+        Color *restrict dstRow = &job->dst[y * n];
+        unsigned int first = (unsigned int)(y * n);
+        for (int x = 0; x < n; x++) {
+            Color base = line[x];
+            // jitter brightness slightly to reduce banding, -5 to +4
+            int brightnessOffset = (int)(CounterRandom(key, first + (unsigned int)x) % 10u) - 5;
+            int r = base.r + brightnessOffset, g = base.g + brightnessOffset, b = base.b + brightnessOffset;
+            dstRow[x] = (Color){
+                (unsigned char)(r < 0 ? 0 : (r > 255 ? 255 : r)),
+                (unsigned char)(g < 0 ? 0 : (g > 255 ? 255 : g)),
+                (unsigned char)(b < 0 ? 0 : (b > 255 ? 255 : b)),
+                base.a
+            };
+        }
+    }
+    free(line);
+}
+
+// nearest upscale of an rgba8 image to size x size with the brightness jitter, straight on the pixel buffers
+// key picks the jitter pattern, same key same pixels
+Image UpscaleNearestJitter(Image src, int size, unsigned int key)
+{
+    Image out = GenImageColor(size, size, BLACK);
+    if (src.format != PIXELFORMAT_UNCOMPRESSED_R8G8B8A8) {
+        TraceLog(LOG_WARNING, "UpscaleNearestJitter wants rgba8, got format %d", src.format);
+        return out;
+    }
+    int *srcX = (int *)malloc(sizeof(int) * size);
+    for (int x = 0; x < size; x++) srcX[x] = (x * src.width) / size;
+    UpscaleJitterJob job = { (const Color *)src.data, src.width, srcX, (Color *)out.data, size, src.height, key };
+    ParallelFor(size, UpscaleJitterRows, &job);
+    free(srcX);
+    return out;
+}
+
 //song 2
 Image UpscaleImageBilinear(Image src, int newWidth, int newHeight) {
     Image img = GenImageColor(newWidth, newHeight, BLACK);
     Color *srcPixels = LoadImageColors(src);
     Color *newPixels = LoadImageColors(img);
+    UnloadImage(img); //newPixels is its own copy, this one was leaking every chunk
 
     for (int y = 0; y < newHeight; y++) {
         for (int x = 0; x < newWidth; x++) {
@@ -638,29 +811,34 @@ Image UpscaleImageBilinear(Image src, int newWidth, int newHeight) {
     return out;
 }
 
-void RebuildImageFromHeightData(Image *image, float *heightData, int width, int height)
+// gray from a known height range, the tiled export has to use the whole worlds range, not the chunks
+void RebuildImageFromHeightDataRange(Image *image, float *heightData, int width, int height, float min, float max)
 {
     Color *pixels = (Color *)image->data;
-
-    float min = FLT_MAX, max = -FLT_MAX;
-    for (int i = 0; i < width * height; i++) {
-        if (heightData[i] < min) min = heightData[i];
-        if (heightData[i] > max) max = heightData[i];
-    }
     float range = max - min;
-    printf("Height range: %.3f to %.3f\n", min, max);
     if (range <= 0.0001f) range = 1.0f; // prevent divide by zero
 
     for (int y = 0; y < height; y++) {
         for (int x = 0; x < width; x++) {
             float val = heightData[y * width + x];
-            float norm = (val - min) / range; // map to [0,1]
+            float norm = Clampf((val - min) / range, 0.0f, 1.0f); // map to [0,1]
             int gray = (int)(norm * 255.0f);
             pixels[y * width + x] = (Color){ gray, gray, gray, 255 };
         }
     }
 }
 
+void RebuildImageFromHeightData(Image *image, float *heightData, int width, int height)
+{
+    float min = FLT_MAX, max = -FLT_MAX;
+    for (int i = 0; i < width * height; i++) {
+        if (heightData[i] < min) min = heightData[i];
+        if (heightData[i] > max) max = heightData[i];
+    }
+    printf("Height range: %.3f to %.3f\n", min, max);
+    RebuildImageFromHeightDataRange(image, heightData, width, height, min, max);
+}
+
 void RebuildColorImageFromHeightData(Image *image, float *heightData, int width, int height)
 {
     Color *pixels = (Color *)image->data;
@@ -860,19 +1038,29 @@ void ApplyHeightAntiSigmoidFilter(float *heightData, int width, int height, floa
     }
 }
 
+// every step reads a snapshot of the step before, so the result does not depend on scan order and a cell only sees
+// cells 2 away (its neighbours, and their neighbours through what they give away), a window eroded with a 2*steps halo
+// gets the same middle as the whole map does (the tiled generation counts on that)
+// (the old in place scan let a step see cells it had already moved, so maps eroded before the snapshot come out a little different)
 void ApplyErosion(float *heightData, int width, int height, int steps, float erosionFactor)
 {
+    float *prev = (float *)malloc(sizeof(float) * width * height);
+    if (!prev) {
+        TraceLog(LOG_ERROR, "EROSION: out of memory for the step snapshot");
+        return;
+    }
     for (int s = 0; s < steps; s++) {
+        memcpy(prev, heightData, sizeof(float) * width * height);
         for (int y = 1; y < height - 1; y++) {
             for (int x = 1; x < width - 1; x++) {
                 int idx = y * width + x;
-                float current = heightData[idx];
+                float current = prev[idx];
                 float totalDiff = 0.0f;
                 float diffs[4];
                 int offsets[4] = { -width, +width, -1, +1 };
 
                 for (int i = 0; i < 4; i++) {
-                    float neighbor = heightData[idx + offsets[i]];
+                    float neighbor = prev[idx + offsets[i]];
                     float diff = current - neighbor;
                     diffs[i] = (diff > 0.0f) ? diff : 0.0f;
                     totalDiff += diffs[i];
@@ -889,13 +1077,21 @@ void ApplyErosion(float *heightData, int width, int height, int steps, float ero
             }
         }
     }
+    free(prev);
 }
 
-void ApplyErosionHydraulic(float *heightData, int width, int height)
+
+// droplets start inside the spawn rect, they can run anywhere in the map (up to EROSION_LIFETIME cells away) and stop 2 cells from its edge
+// rngKey 0 uses rand() like always, anything else draws the start points from CounterRandom(rngKey, ...)
+// (the interpolated height used to be called height and shadowed the map height in the edge check, so every droplet
+// stopped on its first step and this did next to nothing, maps made before that fix have almost no hydraulic erosion)
+void ApplyErosionHydraulicRegion(float *heightData, int width, int height, int spawnX, int spawnY, int spawnW, int spawnH, int droplets, unsigned int rngKey)
 {
-    for (int i = 0; i < EROSION_DROPLETS; i++) {
-        float posX = (float)(rand() % (width - 2)) + 1;
-        float posY = (float)(rand() % (height - 2)) + 1;
+    for (int i = 0; i < droplets; i++) {
+        unsigned int rx = rngKey ? CounterRandom(rngKey, 2u * i) : (unsigned int)rand();
+        unsigned int ry = rngKey ? CounterRandom(rngKey, 2u * i + 1u) : (unsigned int)rand();
+        float posX = (float)(rx % spawnW) + spawnX;
+        float posY = (float)(ry % spawnH) + spawnY;
 
         float dirX = 0.0f;
         float dirY = 0.0f;
@@ -916,10 +1112,10 @@ void ApplyErosionHydraulic(float *heightData, int width, int height)
             float h01 = heightData[idx + width];
             float h11 = heightData[idx + width + 1];
 
-            float height = (1 - fx) * (1 - fy) * h00 +
-                           fx * (1 - fy) * h10 +
-                           (1 - fx) * fy * h01 +
-                           fx * fy * h11;
+            float h = (1 - fx) * (1 - fy) * h00 +
+                      fx * (1 - fy) * h10 +
+                      (1 - fx) * fy * h01 +
+                      fx * fy * h11;
 
             // Gradient
             float gradX = (h10 - h00) * (1 - fy) + (h11 - h01) * fy;
@@ -942,7 +1138,7 @@ void ApplyErosionHydraulic(float *heightData, int width, int height)
 
             int newIdx = ((int)posY) * width + (int)posX;
             float newHeight = heightData[newIdx];
-            float deltaHeight = height - newHeight;
+            float deltaHeight = h - newHeight;
 
             float capacity = fmaxf(-deltaHeight * speed * water * CAPACITY_MULTIPLIER, 0.01f);
 
@@ -963,6 +1159,11 @@ void ApplyErosionHydraulic(float *heightData, int width, int height)
     }
 }
 
+void ApplyErosionHydraulic(float *heightData, int width, int height)
+{
+    ApplyErosionHydraulicRegion(heightData, width, height, 1, 1, width - 2, height - 2, EROSION_DROPLETS, 0);
+}
+
 void ApplyBorderFade(float *heightData, int width, int height, float edgeFadeStrength, float centerLift, float trenchDepth)
 {
     for (int y = 0; y < height; y++)
@@ -1192,130 +1393,164 @@ float GetTerrainHeightFromMeshXZ(Mesh mesh, Vector3 chnkPos, float x, float z)
     return -10000.0f; // Not found in any triangle
 }
 
-Image SampleImageDown(Image src, int targetSize)
-{
-    Image result = GenImageColor(targetSize, targetSize, BLACK);
-    Color *srcPixels = LoadImageColors(src);
-    Color *dstPixels = LoadImageColors(result);
+//chunk meshes are built straight from the float heights (no gray image in between, so no 256 level terracing)
+//and the color window is read straight out of the shared color map, no full map copies per chunk
+//the cpu side (meshes + color window) runs across chunks in parallel, the gl side (UploadMesh, the texture) stays on the main thread
+int meshHeightBits = 0; //0 keeps full float heights, --height-bits N quantizes them to 2^N levels of the height range
+//(only the values, there is no 16 bit height storage: vertices, obj files and memory stay the same size)
 
-    int srcW = src.width;
-    int srcH = src.height;
+typedef struct {
+    Mesh lods[WORLD_MAX_LODS]; // biggest lod first, cpu only until ChunkPartsBuild uploads them
+    Color *color;              // (chunkSize+1)^2 window of the color map, for the chunk texture
+} ChunkParts;
 
-    for (int y = 0; y < targetSize; y++) {
-        for (int x = 0; x < targetSize; x++) {
-            int srcX = (x * (srcW - 1)) / (targetSize - 1);
-            int srcY = (y * (srcH - 1)) / (targetSize - 1);
-            dstPixels[y * targetSize + x] = srcPixels[srcY * srcW + srcX];
-        }
+// a height map value to mesh y, 0..heightScale over the maps range (what the gray image did, minus the 8 bit step)
+static inline float HeightfieldY(float h, float minH, float invRange, float heightScale)
+{
+    float norm = (h - minH) * invRange;
+    norm = norm < 0.0f ? 0.0f : (norm > 1.0f ? 1.0f : norm);
+    if (meshHeightBits > 0) {
+        float levels = (float)((1 << meshHeightBits) - 1);
+        norm = roundf(norm * levels) / levels;
     }
-
-    UnloadImageColors(srcPixels);
-    Image dst = {
-        .data = dstPixels,
-        .width = targetSize,
-        .height = targetSize,
-        .format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8,
-        .mipmaps = 1
-    };
-    return dst;
+    return norm * heightScale;
 }
 
-///
-//This guy is barely hanging on for life
-///
-Model GenerateChunkModel(float *heightData, Image colorImage, Color *colorData, int mapSize, int chunkX, int chunkY, int chunkSize, float heightScale)
+// n x n vertices over the (span+1)^2 cells at x0, y0 of a mapSize square float map, same layout GenMeshHeightmap makes
+// (6 unindexed verts per cell, x/z 0..span, uv 0..1) so every reader of the exported meshes still works
+// normals are central differences on the map itself at this lods stride, so they read past the chunk and match the neighbours
+Mesh HeightfieldMesh(const float *heights, int mapSize, int x0, int y0, int span, int n, float minH, float maxH, float heightScale)
 {
-    int vertsPerChunk = chunkSize + 1;
-
-    // Prepare subset color image for this chunk
-    Color *chunkPixels = malloc(sizeof(Color) * vertsPerChunk * vertsPerChunk);
-    Color *chunkHeights = malloc(sizeof(Color) * vertsPerChunk * vertsPerChunk);
-    Color *fullPixels = LoadImageColors(colorImage);  // read from input image
-
-    for (int y = 0; y <= chunkSize; y++) {
-        for (int x = 0; x <= chunkSize; x++) {
-            int globalX = chunkX * chunkSize + x;
-            int globalY = chunkY * chunkSize + y;
-
-            int srcIndex = globalY * mapSize + globalX;
-            int dstIndex = y * vertsPerChunk + x;
+    Mesh mesh = { 0 };
+    int cells = n - 1;
+    mesh.vertexCount = cells * cells * 6;
+    mesh.triangleCount = cells * cells * 2;
+    mesh.vertices = (float *)RL_MALLOC(mesh.vertexCount * 3 * sizeof(float));
+    mesh.normals = (float *)RL_MALLOC(mesh.vertexCount * 3 * sizeof(float));
+    mesh.texcoords = (float *)RL_MALLOC(mesh.vertexCount * 2 * sizeof(float));
+    float *grid = (float *)malloc(sizeof(float) * n * n * 6); //y, then the normal, then x/z per grid point
+    if (!mesh.vertices || !mesh.normals || !mesh.texcoords || !grid) {
+        TraceLog(LOG_ERROR, "HeightfieldMesh: out of memory for %d verts", mesh.vertexCount);
+        RL_FREE(mesh.vertices); RL_FREE(mesh.normals); RL_FREE(mesh.texcoords); free(grid);
+        return (Mesh){ 0 };
+    }
 
-            chunkPixels[dstIndex] = fullPixels[srcIndex];
+    float invRange = maxH > minH ? 1.0f / (maxH - minH) : 0.0f;
+    int stride = span / cells > 0 ? span / cells : 1;
+    for (int j = 0; j < n; j++) {
+        int gy = MIN(y0 + (j * span) / cells, mapSize - 1);
+        int gyU = MAX(gy - stride, 0), gyD = MIN(gy + stride, mapSize - 1);
+        for (int i = 0; i < n; i++) {
+            int gx = MIN(x0 + (i * span) / cells, mapSize - 1);
+            int gxL = MAX(gx - stride, 0), gxR = MIN(gx + stride, mapSize - 1);
+            float *g = &grid[(j * n + i) * 6];
+            g[0] = HeightfieldY(heights[gy * mapSize + gx], minH, invRange, heightScale);
+            float dx = (HeightfieldY(heights[gy * mapSize + gxR], minH, invRange, heightScale) -
+                        HeightfieldY(heights[gy * mapSize + gxL], minH, invRange, heightScale)) / (float)MAX(gxR - gxL, 1);
+            float dz = (HeightfieldY(heights[gyD * mapSize + gx], minH, invRange, heightScale) -
+                        HeightfieldY(heights[gyU * mapSize + gx], minH, invRange, heightScale)) / (float)MAX(gyD - gyU, 1);
+            Vector3 nrm = Vector3Normalize((Vector3){ -dx, 1.0f, -dz });
+            g[1] = nrm.x; g[2] = nrm.y; g[3] = nrm.z;
+            g[4] = (float)(i * span) / cells;
+            g[5] = (float)(j * span) / cells;
         }
     }
 
-    UnloadImageColors(fullPixels); // done with full source pixels
+    //two triangles per cell in GenMeshHeightmaps order: (x,z) (x,z+1) (x+1,z) then (x+1,z) (x,z+1) (x+1,z+1)
+    static const int corner[6][2] = { {0,0}, {0,1}, {1,0}, {1,0}, {0,1}, {1,1} };
+    int v = 0;
+    for (int z = 0; z < cells; z++) {
+        for (int x = 0; x < cells; x++) {
+            for (int k = 0; k < 6; k++, v++) {
+                int ci = x + corner[k][0], cj = z + corner[k][1];
+                const float *g = &grid[(cj * n + ci) * 6];
+                mesh.vertices[v * 3 + 0] = g[4];
+                mesh.vertices[v * 3 + 1] = g[0];
+                mesh.vertices[v * 3 + 2] = g[5];
+                mesh.normals[v * 3 + 0] = g[1];
+                mesh.normals[v * 3 + 1] = g[2];
+                mesh.normals[v * 3 + 2] = g[3];
+                mesh.texcoords[v * 2 + 0] = (float)ci / cells;
+                mesh.texcoords[v * 2 + 1] = (float)cj / cells;
+            }
+        }
+    }
+    free(grid);
+    return mesh;
+}
 
-    for (int y = 0; y <= chunkSize; y++) {
-        for (int x = 0; x <= chunkSize; x++) {
-            int globalX = chunkX * chunkSize + x;
-            int globalY = chunkY * chunkSize + y;
+// target x target picks of a color window, same as the mesh vertices, cells past the map edge repeat the edge
+void ChunkSampleWindow(const Color *src, int mapSize, int x0, int y0, int span, int target, Color *out)
+{
+    for (int y = 0; y < target; y++) {
+        const Color *row = &src[MIN(y0 + (y * span) / (target - 1), mapSize - 1) * mapSize];
+        for (int x = 0; x < target; x++) out[y * target + x] = row[MIN(x0 + (x * span) / (target - 1), mapSize - 1)];
+    }
+}
 
-            int srcIndex = globalY * mapSize + globalX;
-            int dstIndex = y * vertsPerChunk + x;
+// every lod mesh plus the color window of the chunk at x0, y0 (cells), heights/colors are both mapSize square
+// plain cpu work, safe from any thread
+bool ChunkPartsPrepare(ChunkParts *p, const float *heights, const Color *colors, int mapSize, int x0, int y0, int chunkSize,
+                       float minH, float maxH, float heightScale)
+{
+    memset(p, 0, sizeof(ChunkParts));
+    for (int i = 0; i < world.lodCount; i++) {
+        p->lods[i] = HeightfieldMesh(heights, mapSize, x0, y0, chunkSize, world.lods[i] + 1, minH, maxH, heightScale);
+        if (!p->lods[i].vertices) return false;
+    }
+    p->color = (Color *)RL_MALLOC(sizeof(Color) * (chunkSize + 1) * (chunkSize + 1));
+    if (!p->color) return false;
+    ChunkSampleWindow(colors, mapSize, x0, y0, chunkSize, chunkSize + 1, p->color);
+    return true;
+}
 
-            chunkHeights[dstIndex] = colorData[srcIndex];
-        }
+void ChunkPartsFree(ChunkParts *p)
+{
+    for (int i = 0; i < WORLD_MAX_LODS; i++) {
+        if (p->lods[i].vertices) UnloadMesh(p->lods[i]);
     }
+    RL_FREE(p->color);
+    memset(p, 0, sizeof(ChunkParts));
+}
 
-    Image chunkImage = {
-        .data = chunkHeights,
-        .width = vertsPerChunk,
-        .height = vertsPerChunk,
-        .format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8,
-        .mipmaps = 1
-    };
+// main thread: upload the prepared meshes and the texture, the smaller three lods come back through out32/out16/out8
+Model ChunkPartsBuild(ChunkParts *p, int chunkSize, Model *out32, Model *out16, Model *out8)
+{
+    for (int i = 0; i < world.lodCount; i++) UploadMesh(&p->lods[i], false);
+    *out32 = LoadModelFromMesh(p->lods[1]);
+    *out16 = LoadModelFromMesh(p->lods[2]);
+    *out8 = LoadModelFromMesh(p->lods[3]);
 
-    Image chunkColorImage = {
-        .data = chunkPixels,
-        .width = vertsPerChunk,
-        .height = vertsPerChunk,
-        .format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8,
-        .mipmaps = 1
-    };
+    Image colorWindow = { .data = p->color, .width = chunkSize + 1, .height = chunkSize + 1,
+                          .format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8, .mipmaps = 1 };
+    Texture2D texture = LoadTextureFromImage(colorWindow);
+    RL_FREE(p->color);
 
-    // Generate mesh and texture
-    //LOD stuff
-    // Image img32 = ImageCopy(chunkImage); // make a copy for GenMeshHeightmap
-    // Image img16 = ImageCopy(chunkImage); // make a copy for GenMeshHeightmap
-    // Image img8 = ImageCopy(chunkImage); // make a copy for GenMeshHeightmap
-
-    // Image img32 = SubsampleHeightmap(chunkImage, 2);  // for 33x33
-    // Image img16 = SubsampleHeightmap(chunkImage, 4);  // for 33x33
-    // Image img8 = SubsampleHeightmap(chunkImage, 8);  // for 33x33
-
-    // ImageResize(&img32,33,33);
-    // ImageResize(&img16,17,17);
-    // ImageResize(&img8,9,9);
-    Image img32 = SampleImageDown(chunkImage, 33);
-    Image img16 = SampleImageDown(chunkImage, 17);
-    Image img8  = SampleImageDown(chunkImage, 9);
-
-    Mesh mesh32 = GenMeshHeightmap(img32, (Vector3){ (float)chunkSize, heightScale, (float)chunkSize});
-    Mesh mesh16 = GenMeshHeightmap(img16, (Vector3){ (float)chunkSize, heightScale, (float)chunkSize});
-    Mesh mesh8 = GenMeshHeightmap(img8, (Vector3){ (float)chunkSize, heightScale, (float)chunkSize});
-    Mesh mesh = GenMeshHeightmap(chunkImage, (Vector3){ (float)chunkSize, heightScale, (float)chunkSize });
-
-    Model model32 = LoadModelFromMesh(mesh32);
-    Model model16 = LoadModelFromMesh(mesh16);
-    Model model8 = LoadModelFromMesh(mesh8);
-    chunkModels32[chunkX][chunkY] = model32;
-    chunkModels16[chunkX][chunkY] = model16;
-    chunkModels8[chunkX][chunkY] = model8;
-
-    Texture2D texture = LoadTextureFromImage(chunkColorImage);
-    UnloadImage(img32); // unload metadata
-    UnloadImage(img16); // unload metadata
-    UnloadImage(img8); // unload metadata
-    UnloadImage(chunkImage); // unload metadata
-    UnloadImage(chunkColorImage); // unload metadata
-
-    Model model = LoadModelFromMesh(mesh);
+    Model model = LoadModelFromMesh(p->lods[0]);
     model.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = texture;
-
+    memset(p, 0, sizeof(ChunkParts)); //the models own the meshes now
     return model;
 }
 
+///
+//This guy is barely hanging on for life
+///
+// all 4 lods of one chunk at x0, y0 (cells), the smaller three come back through out32/out16/out8
+// heightData is mapSize square, minH..maxH is the range that maps to 0..heightScale, colorImage the rgba8 color map
+Model GenerateChunkLods(const float *heightData, float minH, float maxH, Image colorImage, int mapSize, int x0, int y0, int chunkSize, float heightScale,
+                        Model *out32, Model *out16, Model *out8)
+{
+    ChunkParts parts = { 0 };
+    if (colorImage.format != PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 ||
+        !ChunkPartsPrepare(&parts, heightData, (const Color *)colorImage.data, mapSize, x0, y0, chunkSize, minH, maxH, heightScale)) {
+        TraceLog(LOG_ERROR, "chunk at %d,%d: could not build the meshes", x0, y0);
+        ChunkPartsFree(&parts);
+        *out32 = *out16 = *out8 = (Model){ 0 };
+        return (Model){ 0 };
+    }
+    return ChunkPartsBuild(&parts, chunkSize, out32, out16, out8);
+}
+
 void SaveTreePositions(int cx, int cy, StaticGameObject *props, int propsCount)
 {
     char outPath[256];
@@ -1524,7 +1759,7 @@ void SaveChunkVegetationImage(int chunkX, int chunkY, float *heightData, Color *
     //todo: remove this if it doesnt look cool anymore
     char fname[64];
     snprintf(fname, sizeof(fname), "map/chunk_%02d_%02d/vegetation.png", chunkX, chunkY);
-    ExportImage(vegImage, fname);
+    TimedExportImage(vegImage, fname);
     UnloadImage(vegImage);
 }
 
@@ -1532,109 +1767,166 @@ void SaveChunkVegetationImage(int chunkX, int chunkY, float *heightData, Color *
 ///WATER!
 
 #define PATCH_MAX 4096
-#define MAX_REGION_SIZE (CHUNK_SIZE * CHUNK_SIZE)
 #define WATER_TILE_SIZE 16.0f
-#define ORIGIN_CHUNK_X 8
-#define ORIGIN_CHUNK_Y 8
+#define ORIGIN_CHUNK_X (CHUNK_COUNT / 2)
+#define ORIGIN_CHUNK_Y (CHUNK_COUNT / 2)
 
-void ExportOBJMeshSplit(bool *regionMask, float originX, float originZ, int w, int h, int cx, int cy) {
-    int maxTiles = w * h;
-    int maxQuads = 0;
-    for (int i = 0; i < maxTiles; i++) if (regionMask[i]) maxQuads++;
+typedef struct {
+    int x, y; //first cell
+    int w, h; //in cells
+} WaterRect;
+
+// Greedy mesher: merge the set cells of mask (w x h) into rectangles, maxSpan caps each side in cells (0 = no cap)
+// out needs room for w*h rects (checkerboard worst case), returns how many were written
+int GreedyWaterRects(const bool *mask, int w, int h, int maxSpan, WaterRect *out) {
+    bool *used = (bool *)calloc(w * h, sizeof(bool));
+    if (!used) {
+        TraceLog(LOG_ERROR, "[Water] Memory allocation failed (greedy mask)");
+        return 0;
+    }
+    int capW = (maxSpan > 0) ? maxSpan : w;
+    int capH = (maxSpan > 0) ? maxSpan : h;
+    int count = 0;
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            int idx = y * w + x;
+            if (!mask[idx] || used[idx]) continue;
+            //grow right as far as the row allows
+            int rw = 1;
+            while (x + rw < w && rw < capW && mask[idx + rw] && !used[idx + rw]) rw++;
+            //then grow down while the whole span is still water
+            int rh = 1;
+            while (y + rh < h && rh < capH) {
+                bool rowOk = true;
+                for (int i = 0; i < rw; i++) {
+                    int j = (y + rh) * w + x + i;
+                    if (!mask[j] || used[j]) { rowOk = false; break; }
+                }
+                if (!rowOk) break;
+                rh++;
+            }
+            for (int j = 0; j < rh; j++) memset(&used[(y + j) * w + x], 1, sizeof(bool) * rw);
+            out[count++] = (WaterRect){ x, y, rw, rh };
+        }
+    }
+    free(used);
+    return count;
+}
+
+//outline of rect r walked from the top left corner (top, right, bottom, left edge), edges lying on the piece border
+//(w x h) get a vertex at every cell so the next piece, near or far, meets them vertex to vertex, returns the count
+static int WaterRectOutline(WaterRect r, int w, int h, int *ox, int *oy) {
+    int x0 = r.x, y0 = r.y, x1 = r.x + r.w, y1 = r.y + r.h;
+    int n = 0;
+    int stepTop = (y0 == 0) ? 1 : r.w;
+    int stepRight = (x1 == w) ? 1 : r.h;
+    int stepBottom = (y1 == h) ? 1 : r.w;
+    int stepLeft = (x0 == 0) ? 1 : r.h;
+    for (int x = x0; x < x1; x += stepTop) { ox[n] = x; oy[n] = y0; n++; }
+    for (int y = y0; y < y1; y += stepRight) { ox[n] = x1; oy[n] = y; n++; }
+    for (int x = x1; x > x0; x -= stepBottom) { ox[n] = x; oy[n] = y1; n++; }
+    for (int y = y1; y > y0; y -= stepLeft) { ox[n] = x0; oy[n] = y; n++; }
+    return n;
+}
+
+//near water is one quad per cell on a shared vertex grid, water.vs moves every vertex so a long rect edge next to a
+//row of small quads would crack open (t-junction), far water is past the wave fade, stays flat, and gets greedy rects
+//both are written as OBJ parts of at most PATCH_MAX quads, cellX/cellY is the global cell of mask[0], every part gets
+//a manifest line with the piece bounds, near and far parts of one piece share them so play can pick one set per piece by distance
+//a far rect on the piece border is a fan around its center, its border edge split at every cell like the near grid there
+void ExportWaterBodyMesh(const bool *mask, int w, int h, int cellX, int cellY, int bodyId, int pieceId, int *partIndex, bool far, FILE *manifest) {
+    WaterRect *rects = (WaterRect *)malloc(sizeof(WaterRect) * w * h);
+    int *cornerVertex = (int *)malloc(sizeof(int) * (w + 1) * (h + 1)); //vertex of each grid corner in the current part, -1 = not yet
+    int *outlineX = (int *)malloc(sizeof(int) * 2 * (w + h));
+    int *outlineY = (int *)malloc(sizeof(int) * 2 * (w + h));
+    if (!rects || !cornerVertex || !outlineX || !outlineY) {
+        TraceLog(LOG_ERROR, "[Water] Memory allocation failed");
+        free(rects); free(cornerVertex); free(outlineX); free(outlineY);
+        return;
+    }
+    int maxQuads = GreedyWaterRects(mask, w, h, far ? 0 : 1, rects);
+    float originX = (cellX - ORIGIN_CHUNK_X * CHUNK_SIZE) * WATER_TILE_SIZE;
+    float originZ = (cellY - ORIGIN_CHUNK_Y * CHUNK_SIZE) * WATER_TILE_SIZE;
+    float wy = 295.0f;
 
     int patchCount = (maxQuads + PATCH_MAX - 1) / PATCH_MAX;
     int quadIndex = 0;
-    int patchIndex = 0;
 
     for (int p = 0; p < patchCount; p++) {
         int quadsThisPatch = ((quadIndex + PATCH_MAX) > maxQuads) ? (maxQuads - quadIndex) : PATCH_MAX;
 
-        int numVerts = quadsThisPatch * 4;
-        int numTris  = quadsThisPatch * 2;
+        //no corner shared, the real count is usually close to one vertex per quad
+        int maxVerts = 0;
+        int numTris = 0;
+        for (int q = quadIndex; q < quadIndex + quadsThisPatch; q++) {
+            int n = WaterRectOutline(rects[q], w, h, outlineX, outlineY);
+            maxVerts += (n > 4) ? n + 1 : 4;
+            numTris += (n > 4) ? n : 2;
+        }
 
-        float *vertices = (float *)malloc(sizeof(float) * 3 * numVerts);
-        float *normals = (float *)malloc(sizeof(float) * 3 * numVerts);
-        float *texcoords = (float *)malloc(sizeof(float) * 2 * numVerts);
+        float *vertices = (float *)malloc(sizeof(float) * 3 * maxVerts);
+        float *normals = (float *)malloc(sizeof(float) * 3 * maxVerts);
+        float *texcoords = (float *)malloc(sizeof(float) * 2 * maxVerts);
         unsigned short *indices = (unsigned short *)malloc(sizeof(unsigned short) * 3 * numTris);
 
         if (!vertices || !normals || !texcoords || !indices) {
             TraceLog(LOG_ERROR, "[Water] Memory allocation failed");
             free(vertices); free(normals); free(texcoords); free(indices);
+            free(rects); free(cornerVertex); free(outlineX); free(outlineY);
             return;
         }
-
-        int vi = 0, ti = 0, ii = 0;
-        int tilesProcessed = 0;
-
-        for (int y = 0; y < h; y++) {
-            for (int x = 0; x < w; x++) {
-                int idx = y * w + x;
-                if (!regionMask[idx]) continue;
-                if (tilesProcessed < quadIndex) { tilesProcessed++; continue; }
-                if (tilesProcessed >= quadIndex + quadsThisPatch) break;
-
-                float wx = originX + x * WATER_TILE_SIZE;
-                float wz = originZ + y * WATER_TILE_SIZE;
-                float wy = 295.0f;
-
-                // Top Left
-                vertices[vi*3+0] = wx;
-                vertices[vi*3+1] = wy;
-                vertices[vi*3+2] = wz;
-                texcoords[vi*2+0] = 0.0f;
-                texcoords[vi*2+1] = 0.0f;
-                normals[vi*3+0] = 0.0f;
-                normals[vi*3+1] = 1.0f;
-                normals[vi*3+2] = 0.0f;
-                vi++;
-
-                // Top Right
-                vertices[vi*3+0] = wx + WATER_TILE_SIZE;
-                vertices[vi*3+1] = wy;
-                vertices[vi*3+2] = wz;
-                texcoords[vi*2+0] = 1.0f;
-                texcoords[vi*2+1] = 0.0f;
-                normals[vi*3+0] = 0.0f;
-                normals[vi*3+1] = 1.0f;
-                normals[vi*3+2] = 0.0f;
-                vi++;
-
-                // Bottom Left
-                vertices[vi*3+0] = wx;
-                vertices[vi*3+1] = wy;
-                vertices[vi*3+2] = wz + WATER_TILE_SIZE;
-                texcoords[vi*2+0] = 0.0f;
-                texcoords[vi*2+1] = 1.0f;
-                normals[vi*3+0] = 0.0f;
-                normals[vi*3+1] = 1.0f;
-                normals[vi*3+2] = 0.0f;
-                vi++;
-
-                // Bottom Right
-                vertices[vi*3+0] = wx + WATER_TILE_SIZE;
-                vertices[vi*3+1] = wy;
-                vertices[vi*3+2] = wz + WATER_TILE_SIZE;
-                texcoords[vi*2+0] = 1.0f;
-                texcoords[vi*2+1] = 1.0f;
-                normals[vi*3+0] = 0.0f;
-                normals[vi*3+1] = 1.0f;
-                normals[vi*3+2] = 0.0f;
-                vi++;
-
-                int base = (vi - 4);
-                indices[ii++] = base + 0;
-                indices[ii++] = base + 1;
-                indices[ii++] = base + 2;
-                indices[ii++] = base + 1;
-                indices[ii++] = base + 3;
-                indices[ii++] = base + 2;
-
-                tilesProcessed++;
+        for (int i = 0; i < (w + 1) * (h + 1); i++) cornerVertex[i] = -1;
+
+        int vi = 0, ii = 0;
+        for (int q = quadIndex; q < quadIndex + quadsThisPatch; q++) {
+            int n = WaterRectOutline(rects[q], w, h, outlineX, outlineY);
+            //grid corners (x, y) of the piece, uv is the global cell so it repeats once per cell and lines up across rects and pieces
+            int v[4] = { 0 };
+            for (int c = 0; c < n; c++) {
+                int *slot = &cornerVertex[outlineY[c] * (w + 1) + outlineX[c]];
+                if (*slot < 0) {
+                    vertices[vi*3+0] = originX + outlineX[c] * WATER_TILE_SIZE;
+                    vertices[vi*3+1] = wy;
+                    vertices[vi*3+2] = originZ + outlineY[c] * WATER_TILE_SIZE;
+                    texcoords[vi*2+0] = (float)(cellX + outlineX[c]);
+                    texcoords[vi*2+1] = (float)(cellY + outlineY[c]);
+                    normals[vi*3+0] = 0.0f;
+                    normals[vi*3+1] = 1.0f;
+                    normals[vi*3+2] = 0.0f;
+                    *slot = vi++;
+                }
+                outlineX[c] = *slot; //outline becomes vertex indices
+                if (c < 4) v[c] = *slot;
+            }
+            if (n == 4) {
+                //top left, top right, bottom right, bottom left
+                indices[ii++] = v[0];
+                indices[ii++] = v[1];
+                indices[ii++] = v[3];
+                indices[ii++] = v[1];
+                indices[ii++] = v[2];
+                indices[ii++] = v[3];
+                continue;
+            }
+            WaterRect r = rects[q];
+            vertices[vi*3+0] = originX + (r.x + r.w * 0.5f) * WATER_TILE_SIZE;
+            vertices[vi*3+1] = wy;
+            vertices[vi*3+2] = originZ + (r.y + r.h * 0.5f) * WATER_TILE_SIZE;
+            texcoords[vi*2+0] = cellX + r.x + r.w * 0.5f;
+            texcoords[vi*2+1] = cellY + r.y + r.h * 0.5f;
+            normals[vi*3+0] = 0.0f;
+            normals[vi*3+1] = 1.0f;
+            normals[vi*3+2] = 0.0f;
+            int center = vi++;
+            for (int c = 0; c < n; c++) {
+                indices[ii++] = center;
+                indices[ii++] = outlineX[c];
+                indices[ii++] = outlineX[(c + 1) % n];
             }
         }
 
         Mesh mesh = { 0 };
-        mesh.vertexCount = numVerts;
+        mesh.vertexCount = vi;
         mesh.triangleCount = numTris;
         mesh.vertices = vertices;
         mesh.normals = normals;
@@ -1642,117 +1934,295 @@ void ExportOBJMeshSplit(bool *regionMask, float originX, float originZ, int w, i
         mesh.indices = indices;
         UploadMesh(&mesh, false);
 
-        char filename[256];//todo: guard folder not existing here!
-        snprintf(filename, sizeof(filename), "map/chunk_%02d_%02d/water/patch_%d.obj", cx, cy, patchIndex);
-        ExportMesh(mesh, filename);
+        char filename[256];
+        snprintf(filename, sizeof(filename), "map/water/body_%d_%d%s.obj", bodyId, *partIndex, far ? "_far" : "");
+        TimedExportMesh(mesh, filename);
         UnloadMesh(mesh);
 
-        FILE *fp = fopen("map/water_manifest.txt", "a");
-        if (fp) {
-            fprintf(fp, "%d %d %d\n", cx, cy, patchIndex);
-            fclose(fp);
+        if (manifest) {
+            fprintf(manifest, "%d %d %d %s %.2f %.2f %.2f %.2f %.2f %.2f\n", bodyId, pieceId, *partIndex, far ? "far" : "near",
+                originX, wy, originZ, originX + w * WATER_TILE_SIZE, wy, originZ + h * WATER_TILE_SIZE);
         }
 
-        patchIndex++;
+        (*partIndex)++;
         quadIndex += quadsThisPatch;
     }
+    free(rects);
+    free(cornerVertex);
+    free(outlineX);
+    free(outlineY);
 }
 
-// Basic 4-connected flood fill, now records region into regionMap and bounding box
-void FloodFillRegion(bool *visited, bool *waterMask, bool *regionMap, int x, int y, int width, int height,
-                     int *minX, int *minY, int *maxX, int *maxY) {
-    if (x < 0 || x >= width || y < 0 || y >= height) return;
-    int idx = y * width + x;
-    if (visited[idx] || !waterMask[idx]) return;
+// Scratch buffers for water detection, grown on demand and reused by every chunk (no stack VLAs, no recursion)
+typedef struct {
+    int capacity;      //cells the per cell buffers can hold
+    bool *waterMask;
+    bool *visited;
+    bool *regionTiles; //compact region mask, bounds sized
+    int *cells;        //cell list of the current region
+    int *stack;        //scanline seeds, x,y pairs
+    int stackCap;      //in seeds
+} WaterScratch;
+WaterScratch waterScratch = { 0 };
+
+bool EnsureWaterScratch(WaterScratch *ws, int cells) {
+    if (ws->capacity >= cells) return true;
+    free(ws->waterMask); free(ws->visited); free(ws->regionTiles); free(ws->cells); free(ws->stack);
+    memset(ws, 0, sizeof(WaterScratch));
+    ws->waterMask = (bool *)malloc(sizeof(bool) * cells);
+    ws->visited = (bool *)malloc(sizeof(bool) * cells);
+    ws->regionTiles = (bool *)malloc(sizeof(bool) * cells);
+    ws->cells = (int *)malloc(sizeof(int) * cells);
+    ws->stackCap = cells;
+    ws->stack = (int *)malloc(sizeof(int) * 2 * ws->stackCap);
+    if (!ws->waterMask || !ws->visited || !ws->regionTiles || !ws->cells || !ws->stack) {
+        TraceLog(LOG_ERROR, "[Water] Failed to allocate %d cell scratch buffers", cells);
+        free(ws->waterMask); free(ws->visited); free(ws->regionTiles); free(ws->cells); free(ws->stack);
+        memset(ws, 0, sizeof(WaterScratch));
+        return false;
+    }
+    ws->capacity = cells;
+    return true;
+}
 
-    visited[idx] = true;
-    regionMap[idx] = true;
+void FreeWaterScratch(WaterScratch *ws) {
+    free(ws->waterMask); free(ws->visited); free(ws->regionTiles); free(ws->cells); free(ws->stack);
+    memset(ws, 0, sizeof(WaterScratch));
+}
 
-    if (x < *minX) *minX = x;
-    if (y < *minY) *minY = y;
-    if (x > *maxX) *maxX = x;
-    if (y > *maxY) *maxY = y;
+static bool PushWaterSeed(WaterScratch *ws, int *top, int x, int y) {
+    if (*top >= ws->stackCap) {
+        int *grown = (int *)realloc(ws->stack, sizeof(int) * 2 * ws->stackCap * 2);
+        if (!grown) return false;
+        ws->stack = grown;
+        ws->stackCap *= 2;
+    }
+    ws->stack[(*top) * 2 + 0] = x;
+    ws->stack[(*top) * 2 + 1] = y;
+    (*top)++;
+    return true;
+}
 
-    FloodFillRegion(visited, waterMask, regionMap, x + 1, y, width, height, minX, minY, maxX, maxY);
-    FloodFillRegion(visited, waterMask, regionMap, x - 1, y, width, height, minX, minY, maxX, maxY);
-    FloodFillRegion(visited, waterMask, regionMap, x, y + 1, width, height, minX, minY, maxX, maxY);
-    FloodFillRegion(visited, waterMask, regionMap, x, y - 1, width, height, minX, minY, maxX, maxY);
+// Iterative 4-connected scanline flood fill over ws->waterMask, marks ws->visited,
+// writes the region's cells (y * width + x) to ws->cells and its bounding box, returns the cell count
+int FloodFillRegionScanline(WaterScratch *ws, int sx, int sy, int width, int height,
+                            int *minX, int *minY, int *maxX, int *maxY) {
+    int count = 0;
+    int top = 0;
+    *minX = *maxX = sx;
+    *minY = *maxY = sy;
+    if (!PushWaterSeed(ws, &top, sx, sy)) return 0;
+    while (top > 0) {
+        top--;
+        int x = ws->stack[top * 2 + 0];
+        int y = ws->stack[top * 2 + 1];
+        int row = y * width;
+        if (ws->visited[row + x] || !ws->waterMask[row + x]) continue;
+        //walk out to both ends of this run
+        int lx = x, rx = x;
+        while (lx > 0 && ws->waterMask[row + lx - 1] && !ws->visited[row + lx - 1]) lx--;
+        while (rx < width - 1 && ws->waterMask[row + rx + 1] && !ws->visited[row + rx + 1]) rx++;
+        for (int i = lx; i <= rx; i++) {
+            ws->visited[row + i] = true;
+            ws->cells[count++] = row + i;
+        }
+        if (lx < *minX) *minX = lx;
+        if (rx > *maxX) *maxX = rx;
+        if (y < *minY) *minY = y;
+        if (y > *maxY) *maxY = y;
+        //one seed per unvisited run in the rows above and below
+        for (int ny = y - 1; ny <= y + 1; ny += 2) {
+            if (ny < 0 || ny >= height) continue;
+            int nrow = ny * width;
+            bool inRun = false;
+            for (int i = lx; i <= rx; i++) {
+                bool open = ws->waterMask[nrow + i] && !ws->visited[nrow + i];
+                if (open && !inRun) {
+                    if (!PushWaterSeed(ws, &top, i, ny)) {
+                        TraceLog(LOG_ERROR, "[Water] Flood fill stack allocation failed");
+                        return count;
+                    }
+                }
+                inRun = open;
+            }
+        }
+    }
+    return count;
 }
 
-void CreateWaterPlanes(int chunkX, int chunkY, float *heightData, int mapSize, float heightThreshold) {
-    const int size = CHUNK_SIZE;
-    const int offsetX = chunkX * size;
-    const int offsetY = chunkY * size;
+#define WATER_BODY_PIECE_CELLS 128 //size budget, a body is only cut into pieces this many cells a side (2x2 chunks)
 
-    bool waterMask[size * size];
-    bool visited[size * size];
-    memset(waterMask, 0, sizeof(bool) * size * size);
-    memset(visited, 0, sizeof(bool) * size * size);
+static int FindWaterRoot(int *parent, int a) {
+    while (parent[a] != a) {
+        parent[a] = parent[parent[a]]; //path halving
+        a = parent[a];
+    }
+    return a;
+}
 
-    //printf("------WATERGRID (%d,%d)------\n", chunkX, chunkY);
-    for (int y = 0; y < size; y++) {
-        //printf("WATERGRID ROW - ");
-        for (int x = 0; x < size; x++) {
-            int globalX = offsetX + x;
-            int globalY = offsetY + y;
-            float h = heightData[globalY * mapSize + globalX];
-            waterMask[y * size + x] = (h < heightThreshold);
-            //printf(h<heightThreshold?"1":"0");
+static void UnionWaterLabels(int *parent, int a, int b) {
+    a = FindWaterRoot(parent, a);
+    b = FindWaterRoot(parent, b);
+    if (a == b) return;
+    if (a < b) parent[b] = a; else parent[a] = b; //smaller label wins, keeps body ids stable
+}
+
+typedef struct {
+    int minX, minY, maxX, maxY; //global cells
+    int cells;
+} WaterBodyInfo;
+
+// One pass over the whole map: label water per chunk (scanline fill), union the labels across chunk seams,
+// then write every connected body as greedy meshes cut only by WATER_BODY_PIECE_CELLS, plus map/water_bodies.txt
+void CreateWorldWaterBodies(float *heightData, int mapSize, float heightThreshold) {
+    const int size = CHUNK_SIZE;
+    const int chunkCount = mapSize / size;
+    int total = mapSize * mapSize;
+    int *labels = (int *)malloc(sizeof(int) * total);
+    int parentCap = 1024;
+    int *parent = (int *)malloc(sizeof(int) * parentCap);
+    WaterScratch *ws = &waterScratch;
+    if (!labels || !parent || !EnsureWaterScratch(ws, size * size)) {
+        TraceLog(LOG_ERROR, "[Water] Failed to allocate world labels");
+        free(labels); free(parent);
+        return;
+    }
+    for (int i = 0; i < total; i++) labels[i] = -1;
+
+    //1) per chunk labels, the same fill the per chunk export used
+    int labelCount = 0;
+    for (int chunkY = 0; chunkY < chunkCount; chunkY++) {
+        for (int chunkX = 0; chunkX < chunkCount; chunkX++) {
+            const int offsetX = chunkX * size;
+            const int offsetY = chunkY * size;
+            memset(ws->visited, 0, sizeof(bool) * size * size);
+            for (int y = 0; y < size; y++) {
+                for (int x = 0; x < size; x++) {
+                    ws->waterMask[y * size + x] = heightData[(offsetY + y) * mapSize + offsetX + x] < heightThreshold;
+                }
+            }
+            for (int y = 0; y < size; y++) {
+                for (int x = 0; x < size; x++) {
+                    int idx = y * size + x;
+                    if (ws->visited[idx] || !ws->waterMask[idx]) continue;
+                    int minX, minY, maxX, maxY;
+                    int cellCount = FloodFillRegionScanline(ws, x, y, size, size, &minX, &minY, &maxX, &maxY);
+                    if (cellCount == 0) continue;
+                    if (labelCount >= parentCap) {
+                        int *grown = (int *)realloc(parent, sizeof(int) * parentCap * 2);
+                        if (!grown) {
+                            TraceLog(LOG_ERROR, "[Water] Failed to grow label table");
+                            free(labels); free(parent);
+                            return;
+                        }
+                        parent = grown;
+                        parentCap *= 2;
+                    }
+                    parent[labelCount] = labelCount;
+                    for (int c = 0; c < cellCount; c++) {
+                        int gx = offsetX + ws->cells[c] % size;
+                        int gy = offsetY + ws->cells[c] / size;
+                        labels[gy * mapSize + gx] = labelCount;
+                    }
+                    labelCount++;
+                }
+            }
         }
-        //printf("\n");
     }
-    //printf("-----WATERGRID END (%d,%d)------\n", chunkX, chunkY);
 
-    int patchCount = 0;
-    for (int y = 0; y < size; y++) {
-        for (int x = 0; x < size; x++) {
-            int idx = y * size + x;
-            if (!visited[idx] && waterMask[idx]) {
-                int minX = x, minY = y, maxX = x, maxY = y;
-                bool regionMap[size * size];
-                memset(regionMap, 0, sizeof(bool) * size * size);
-
-                FloodFillRegion(visited, waterMask, regionMap, x, y, size, size, &minX, &minY, &maxX, &maxY);
-
-                int regionWidth = maxX - minX + 1;
-                int regionHeight = maxY - minY + 1;
-
-                if (regionWidth > 0 && regionHeight > 0) {
-                    // Allocate a compact region array
-                    // bool *regionTiles = malloc(sizeof(bool) * regionWidth * regionHeight);
-                    // if (!regionTiles) {
-                    //     TraceLog(LOG_ERROR, "Failed to allocate region tile buffer");
-                    //     continue;
-                    // }
-
-                    // for (int j = 0; j < regionHeight; j++) {
-                    //     for (int i = 0; i < regionWidth; i++) {
-                    //         int gx = minX + i;
-                    //         int gy = minY + j;
-                    //         regionTiles[j * regionWidth + i] = regionMap[gy * size + gx];
-                    //     }
-                    // }
-
-                    // At this point we have:
-                    // regionTiles: regionHeight x regionWidth bool array
-                    // minX, minY: local chunk tile offset
-                    // pass these to ExportOBJMeshSplit in next refactor step
-                    float originX = (chunkX - ORIGIN_CHUNK_X) * 1024; //WATER_TILE_SIZE;
-                    float originZ = (chunkY - ORIGIN_CHUNK_Y) * 1024; //WATER_TILE_SIZE;
-                    ///float worldX = (offsetX + minX - mapSize / 2.0f) * WATER_TILE_SIZE;
-                    ///float worldZ = (offsetY + minY - mapSize / 2.0f) * WATER_TILE_SIZE;
-
-                    //ExportOBJMeshSplit(regionTiles,regionWidth,regionHeight, originX, originZ, chunkX, chunkY);
-                    ExportOBJMeshSplit(regionMap, originX, originZ, size,size, chunkX, chunkY);
-
-                    TraceLog(LOG_INFO, "Detected water patch (%d,%d) size %dx%d", chunkX, chunkY, regionWidth, regionHeight);
-
-                    //free(regionTiles);
-                    patchCount++;
+    //2) stitch the seams, only the first column/row of every chunk has to look back over the border
+    for (int gy = 0; gy < mapSize; gy++) {
+        for (int gx = size; gx < mapSize; gx += size) {
+            int a = labels[gy * mapSize + gx - 1];
+            int b = labels[gy * mapSize + gx];
+            if (a >= 0 && b >= 0) UnionWaterLabels(parent, a, b);
+        }
+    }
+    for (int gy = size; gy < mapSize; gy += size) {
+        for (int gx = 0; gx < mapSize; gx++) {
+            int a = labels[(gy - 1) * mapSize + gx];
+            int b = labels[gy * mapSize + gx];
+            if (a >= 0 && b >= 0) UnionWaterLabels(parent, a, b);
+        }
+    }
+
+    //3) roots become compact body ids, labels[] is rewritten to body ids
+    int *bodyOfRoot = (int *)malloc(sizeof(int) * (labelCount > 0 ? labelCount : 1));
+    WaterBodyInfo *bodies = (WaterBodyInfo *)malloc(sizeof(WaterBodyInfo) * (labelCount > 0 ? labelCount : 1));
+    if (!bodyOfRoot || !bodies) {
+        TraceLog(LOG_ERROR, "[Water] Failed to allocate body table");
+        free(labels); free(parent); free(bodyOfRoot); free(bodies);
+        return;
+    }
+    int bodyCount = 0;
+    for (int l = 0; l < labelCount; l++) bodyOfRoot[l] = -1;
+    for (int l = 0; l < labelCount; l++) {
+        int root = FindWaterRoot(parent, l);
+        if (bodyOfRoot[root] < 0) {
+            bodyOfRoot[root] = bodyCount;
+            bodies[bodyCount] = (WaterBodyInfo){ mapSize, mapSize, -1, -1, 0 };
+            bodyCount++;
+        }
+    }
+    for (int gy = 0; gy < mapSize; gy++) {
+        for (int gx = 0; gx < mapSize; gx++) {
+            int i = gy * mapSize + gx;
+            if (labels[i] < 0) continue;
+            int b = bodyOfRoot[FindWaterRoot(parent, labels[i])];
+            labels[i] = b;
+            WaterBodyInfo *body = &bodies[b];
+            if (gx < body->minX) body->minX = gx;
+            if (gy < body->minY) body->minY = gy;
+            if (gx > body->maxX) body->maxX = gx;
+            if (gy > body->maxY) body->maxY = gy;
+            body->cells++;
+        }
+    }
+    free(parent);
+    free(bodyOfRoot);
+
+    //4) meshes, one piece per WATER_BODY_PIECE_CELLS square of the body bounds
+    EnsureDirectoryExists("map/water");
+    FILE *manifest = AtomicFileOpen("map/water_bodies.txt", "w"); //play keeps reading the old one until this is done
+    if (!manifest) TraceLog(LOG_WARNING, "[Water] Could not open map/water_bodies.txt");
+    bool *pieceMask = (bool *)malloc(sizeof(bool) * WATER_BODY_PIECE_CELLS * WATER_BODY_PIECE_CELLS);
+    if (pieceMask) {
+        for (int b = 0; b < bodyCount; b++) {
+            WaterBodyInfo *body = &bodies[b];
+            int nearPart = 0;
+            int farPart = 0;
+            int piece = 0;
+            for (int py = body->minY; py <= body->maxY; py += WATER_BODY_PIECE_CELLS) {
+                for (int px = body->minX; px <= body->maxX; px += WATER_BODY_PIECE_CELLS) {
+                    int pw = MIN(WATER_BODY_PIECE_CELLS, body->maxX - px + 1);
+                    int ph = MIN(WATER_BODY_PIECE_CELLS, body->maxY - py + 1);
+                    bool any = false;
+                    for (int y = 0; y < ph; y++) {
+                        for (int x = 0; x < pw; x++) {
+                            bool inBody = labels[(py + y) * mapSize + px + x] == b;
+                            pieceMask[y * pw + x] = inBody;
+                            any |= inBody;
+                        }
+                    }
+                    if (!any) continue;
+                    ExportWaterBodyMesh(pieceMask, pw, ph, px, py, b, piece, &nearPart, false, manifest);
+                    ExportWaterBodyMesh(pieceMask, pw, ph, px, py, b, piece, &farPart, true, manifest);
+                    piece++;
                 }
             }
+            TraceLog(LOG_INFO, "Water body %d: %d cells, bounds (%d,%d)-(%d,%d), %d parts", b, body->cells,
+                body->minX, body->minY, body->maxX, body->maxY, nearPart);
         }
+        free(pieceMask);
+    } else {
+        TraceLog(LOG_ERROR, "[Water] Failed to allocate piece mask");
     }
+    if (manifest) AtomicFileCommit(manifest, "map/water_bodies.txt");
+    TraceLog(LOG_INFO, "Water: %d per chunk regions joined into %d bodies", labelCount, bodyCount);
+
+    free(bodies);
+    free(labels);
+    FreeWaterScratch(ws);
 }
 
 // void CreateWaterPlanes(int chunkX, int chunkY, float *heightData, Color *colorData, int mapSize, float heightScale)
@@ -1857,12 +2327,1169 @@ void CreateWaterPlanes(int chunkX, int chunkY, float *heightData, int mapSize, f
 //     }
 // } //water
 
+//------------------------------------------------------------------road flattening
+//every pass reads one buffer and writes another, so the result does not depend on scan order or thread count
+//a road cell wants the cells around it no higher than its box average minus FLATTEN_STRENGTH,
+//each cell takes the lowest of those wishes and lerps toward it once per road cell that reaches it (what the old in place scan did, roughly)
+//the inner loops have no branches or gathers: rows are copied into a line padded with a value that does nothing (0 for sums,
+//FLT_MAX for mins, 1 for the keep products) and the lerp counts are a running product, so gcc -O3 vectorizes every x loop but the mask lookup
+#define FLATTEN_WINDOW (2 * FLATTEN_RADIUS + 1)
+
+typedef struct {
+    float *height;       // in: original heights, out: flattened
+    int size;
+    const BitMask *road; // road map resolution
+    float *rowSum;       // box sums along x, reused for the row minimums
+    float *flat;         // road cells: avg - FLATTEN_STRENGTH, others FLT_MAX
+    float *rowKeep;      // 1-f on road cells, then (1-f)^n along x for n road cells, what the lerps leave of the height
+    float *spanX;        // cells in the box along x, smaller at the edges
+} FlattenJob;
+
+static inline int FlattenSpan(int v, int size)
+{
+    int a = v - FLATTEN_RADIUS < 0 ? 0 : v - FLATTEN_RADIUS;
+    int b = v + FLATTEN_RADIUS >= size ? size - 1 : v + FLATTEN_RADIUS;
+    return b - a + 1;
+}
+
+// src into line[FLATTEN_RADIUS..], pad on both ends
+static void FlattenPadLine(float *line, const float *src, int n, float pad)
+{
+    for (int i = 0; i < FLATTEN_RADIUS; i++) {
+        line[i] = pad;
+        line[FLATTEN_RADIUS + n + i] = pad;
+    }
+    memcpy(&line[FLATTEN_RADIUS], src, sizeof(float) * n);
+}
+
+static void FlattenRowSums(int y0, int y1, void *ctx)
+{
+    FlattenJob *job = (FlattenJob *)ctx;
+    int n = job->size;
+    float *line = (float *)malloc(sizeof(float) * (n + 2 * FLATTEN_RADIUS));
+    for (int y = y0; y < y1; y++) {
+        FlattenPadLine(line, &job->height[y * n], n, 0.0f);
+        const float *restrict in = line;
+        float *restrict dst = &job->rowSum[y * n];
+        for (int x = 0; x < n; x++) {
+            float sum = 0.0f;
+            for (int ox = 0; ox < FLATTEN_WINDOW; ox++) sum += in[x + ox];
+            dst[x] = sum;
+        }
+    }
+    free(line);
+}
+
+static void FlattenTargets(int y0, int y1, void *ctx)
+{
+    FlattenJob *job = (FlattenJob *)ctx;
+    int n = job->size;
+    float *restrict sum = (float *)malloc(sizeof(float) * n);
+    float *restrict offRoad = (float *)malloc(sizeof(float) * n);
+    const float *restrict spanX = job->spanX;
+    for (int y = y0; y < y1; y++) {
+        //the mask lookups stay scalar, road cells get an offRoad of -FLT_MAX (the target wins) and the rest FLT_MAX,
+        //each cell's lerp factor goes in rowKeep for FlattenRowMins to multiply up
+        int ry = y * job->road->height / n;
+        float *restrict keep = &job->rowKeep[y * n];
+        for (int x = 0; x < n; x++) {
+            bool road = BitMaskGet(job->road, x * job->road->width / n, ry);
+            offRoad[x] = road ? -FLT_MAX : FLT_MAX;
+            keep[x] = road ? 1.0f - FLATTEN_LERP_FACT : 1.0f;
+        }
+
+        //rows outside the map are not in the box, the y range is the same for the whole row so its not a branch per cell
+        int ya = y - FLATTEN_RADIUS < 0 ? 0 : y - FLATTEN_RADIUS;
+        int yb = y + FLATTEN_RADIUS >= n ? n - 1 : y + FLATTEN_RADIUS;
+        for (int x = 0; x < n; x++) sum[x] = 0.0f;
+        for (int ny = ya; ny <= yb; ny++) {
+            const float *restrict src = &job->rowSum[ny * n];
+            for (int x = 0; x < n; x++) sum[x] += src[x];
+        }
+        float spanY = (float)(yb - ya + 1);
+        float *restrict dst = &job->flat[y * n];
+        for (int x = 0; x < n; x++) {
+            float target = sum[x] / (spanY * spanX[x]) - FLATTEN_STRENGTH;
+            dst[x] = offRoad[x] > target ? offRoad[x] : target;
+        }
+    }
+    free(sum);
+    free(offRoad);
+}
+
+static void FlattenRowMins(int y0, int y1, void *ctx)
+{
+    FlattenJob *job = (FlattenJob *)ctx;
+    int n = job->size;
+    float *lowestLine = (float *)malloc(sizeof(float) * (n + 2 * FLATTEN_RADIUS));
+    float *keepLine = (float *)malloc(sizeof(float) * (n + 2 * FLATTEN_RADIUS));
+    for (int y = y0; y < y1; y++) {
+        //rowKeep comes in per cell and goes out per window, the padded copy lets it be overwritten in place
+        FlattenPadLine(lowestLine, &job->flat[y * n], n, FLT_MAX);
+        FlattenPadLine(keepLine, &job->rowKeep[y * n], n, 1.0f);
+        const float *restrict lowestIn = lowestLine;
+        const float *restrict keepIn = keepLine;
+        float *restrict lowestOut = &job->rowSum[y * n];
+        float *restrict keepOut = &job->rowKeep[y * n];
+        for (int x = 0; x < n; x++) {
+            float lowest = FLT_MAX;
+            float keep = 1.0f;
+            for (int ox = 0; ox < FLATTEN_WINDOW; ox++) {
+                float f = lowestIn[x + ox];
+                lowest = f < lowest ? f : lowest;
+                keep *= keepIn[x + ox];
+            }
+            lowestOut[x] = lowest;
+            keepOut[x] = keep;
+        }
+    }
+    free(lowestLine);
+    free(keepLine);
+}
+
+static void FlattenApply(int y0, int y1, void *ctx)
+{
+    FlattenJob *job = (FlattenJob *)ctx;
+    int n = job->size;
+    float *restrict target = (float *)malloc(sizeof(float) * n);
+    float *restrict keep = (float *)malloc(sizeof(float) * n);
+    for (int y = y0; y < y1; y++) {
+        int ya = y - FLATTEN_RADIUS < 0 ? 0 : y - FLATTEN_RADIUS;
+        int yb = y + FLATTEN_RADIUS >= n ? n - 1 : y + FLATTEN_RADIUS;
+        for (int x = 0; x < n; x++) {
+            target[x] = FLT_MAX;
+            keep[x] = 1.0f;
+        }
+        for (int ny = ya; ny <= yb; ny++) {
+            const float *restrict lowest = &job->rowSum[ny * n];
+            const float *restrict rowKeep = &job->rowKeep[ny * n];
+            for (int x = 0; x < n; x++) {
+                target[x] = lowest[x] < target[x] ? lowest[x] : target[x];
+                keep[x] *= rowKeep[x];
+            }
+        }
+        //no road in reach leaves keep at 1 and target at FLT_MAX, so h comes back exactly
+        float *restrict h = &job->height[y * n];
+        for (int x = 0; x < n; x++) {
+            float to = h[x] > target[x] ? target[x] : h[x];
+            h[x] += (1.0f - keep[x]) * (to - h[x]);
+        }
+    }
+    free(target);
+    free(keep);
+}
+
+// Lower the terrain under and around the roads in road (any size mask, scaled over the size x size height map)
+void FlattenRoads(float *heightData, int size, const BitMask *road)
+{
+    FlattenJob job = { 0 };
+    job.height = heightData;
+    job.size = size;
+    job.road = road;
+    job.rowSum = (float *)malloc(sizeof(float) * size * size);
+    job.flat = (float *)malloc(sizeof(float) * size * size);
+    job.rowKeep = (float *)malloc(sizeof(float) * size * size);
+    job.spanX = (float *)malloc(sizeof(float) * size);
+    if (!job.rowSum || !job.flat || !job.rowKeep || !job.spanX) {
+        TraceLog(LOG_ERROR, "ROADS: out of memory flattening");
+        free(job.rowSum); free(job.flat); free(job.rowKeep); free(job.spanX);
+        return;
+    }
+    for (int x = 0; x < size; x++) job.spanX[x] = (float)FlattenSpan(x, size);
+
+    ParallelFor(size, FlattenRowSums, &job);
+    ParallelFor(size, FlattenTargets, &job);
+    ParallelFor(size, FlattenRowMins, &job);
+    ParallelFor(size, FlattenApply, &job);
+
+    free(job.rowSum);
+    free(job.flat);
+    free(job.rowKeep);
+    free(job.spanX);
+}
+
+// ENTER in create: feature points, worley roads, cleanup, then flatten the terrain under the roads
+void GenerateRoads(float *heightData, Image *image, Image colorImage)
+{
+    TraceLog(LOG_INFO, "Road Stuff ...");
+    TraceLog(LOG_INFO, "Feature Points for Roads ...");
+    StageTimer stage = StageBegin("road feature points");
+    // Generate feature points ... for roods! as many per cell as the 1024 map had, so bigger worlds are not all one road cell
+    int featureCount = MAX(ROAD_MAP_SIZE * ROAD_MAP_SIZE / FEATURE_POINT_AREA, 2);
+    Vector2 *featurePoints = (Vector2 *)malloc(sizeof(Vector2) * featureCount);
+    if (!featurePoints) {
+        TraceLog(LOG_ERROR, "ROADS: out of memory for %d feature points", featureCount);
+        StageEnd(stage, 0, 0, 0);
+        return;
+    }
+    int found = 0;
+    int stride = 16; // space between sample attempts
+
+    for (int y = stride; y < MAP_SIZE - stride; y += stride) {
+        for (int x = stride; x < MAP_SIZE - stride; x += stride) {
+            int idx = y * MAP_SIZE + x;
+            float h = heightData[idx];
+
+            // Local slope check (less than 15 degrees-ish)
+            float hL = heightData[y * MAP_SIZE + (x - 1)];
+            float hR = heightData[y * MAP_SIZE + (x + 1)];
+            float hU = heightData[(y + 1) * MAP_SIZE + x];
+            float hD = heightData[(y - 1) * MAP_SIZE + x];
+
+            float dhdx = (hR - hL) * HEIGHT_SCALE / 2.0f;
+            float dhdy = (hU - hD) * HEIGHT_SCALE / 2.0f;
+            float slope = sqrtf(dhdx * dhdx + dhdy * dhdy);
+
+            if (slope > 0.6f) continue; // skip steep regions
+
+            // Check 3x3 neighborhood for local max
+            bool isMax = true;
+            for (int oy = -1; oy <= 1 && isMax; oy++) {
+                for (int ox = -1; ox <= 1 && isMax; ox++) {
+                    if (ox == 0 && oy == 0) continue;
+                    int ni = (y + oy) * MAP_SIZE + (x + ox);
+                    if (heightData[ni] >= h) isMax = false;
+                }
+            }
+
+            if (isMax && found < featureCount) {
+                featurePoints[found++] = (Vector2){ x, y };
+            }
+        }
+    }
+
+    TraceLog(LOG_INFO, "found (%d), starting random sampling for features if needed ...?", found);
+    if (found < featureCount / 2) {
+        TraceLog(LOG_WARNING, "Only found %d good points, adding random extras", found);
+        while (found < featureCount) {
+            featurePoints[found++] = (Vector2){
+                GetRandomValue(0, MAP_SIZE - 1),
+                GetRandomValue(0, MAP_SIZE - 1)
+            };
+        }
+    }
+
+    StageEnd(stage, (MAP_SIZE / stride) * (MAP_SIZE / stride), 0, 0);
+
+    // Create road map image
+    roadImage = GenImageColor(ROAD_MAP_SIZE, ROAD_MAP_SIZE, DARKGREEN); // base
+    hardRoadMap = GenImageColor(ROAD_MAP_SIZE, ROAD_MAP_SIZE, BLACK); // hard lines, atleast its supposed to be
+
+    Color *height_Data = LoadImageColors(*image);
+    Color *color_data = LoadImageColors(colorImage);//yep, I screwed up the names, and its getting confusing
+    stage = StageBegin("GenerateWorleyRoadMap");
+    GenerateWorleyRoadMap(&roadImage, &hardRoadMap, color_data, height_Data, featurePoints, found);
+    free(featurePoints);
+    StageEnd(stage, ROAD_MAP_SIZE * ROAD_MAP_SIZE, 0, 0);
+    TraceLog(LOG_INFO, "Road map gen - smoothing artifacts ... ");
+    //the mask is 1 bit, so the cleanup runs on a packed copy and goes back into the image after
+    BitMask roadMask = { 0 };
+    if (BitMaskFromImage(&roadMask, hardRoadMap, 200)) {
+        stage = StageBegin("ExpandRoadPaths");
+        BitMaskDilate(&roadMask, 1);
+        StageEnd(stage, ROAD_MAP_SIZE * ROAD_MAP_SIZE, 0, 0);
+        stage = StageBegin("FilterSmallRoadBlobs");
+        int blobs = BitMaskRemoveSmallComponents(&roadMask, 10);  // kill all blobs smaller than 10 pixels
+        StageEnd(stage, ROAD_MAP_SIZE * ROAD_MAP_SIZE, 0, 0);
+        TraceLog(LOG_INFO, "Road map gen - removed %d small blobs", blobs);
+        BitMaskToImage(&roadMask, &hardRoadMap, WHITE, BLACK);
+    }
+    TraceLog(LOG_INFO, "Road map gen - flattening ... ");
+    stage = StageBegin("road flatten");
+    if (roadMask.bits) FlattenRoads(heightData, MAP_SIZE, &roadMask);
+    StageEnd(stage, MAP_SIZE * MAP_SIZE, 0, 0);
+    BitMaskFree(&roadMask);
+    stage = StageBegin("RebuildImageFromHeightData");
+    RebuildImageFromHeightData(image, heightData, MAP_SIZE, MAP_SIZE);
+    StageEnd(stage, MAP_SIZE * MAP_SIZE, 0, 0);
+}
+
+typedef struct {
+    ChunkParts *parts; // CHUNK_COUNT, one per cx
+    bool *ok;
+    const float *heights;
+    const Color *colors;
+    float minH, maxH;
+    int cy;
+} ChunkRowJob;
+
+static void ChunkRowPrepare(int cx0, int cx1, void *ctx)
+{
+    ChunkRowJob *job = (ChunkRowJob *)ctx;
+    for (int cx = cx0; cx < cx1; cx++) {
+        job->ok[cx] = ChunkPartsPrepare(&job->parts[cx], job->heights, job->colors, MAP_SIZE, cx * CHUNK_SIZE, job->cy * CHUNK_SIZE,
+                                        CHUNK_SIZE, job->minH, job->maxH, HEIGHT_SCALE);
+    }
+}
+
+static inline int ModelTriangles(Model m)
+{
+    return m.meshCount > 0 ? m.meshes[0].triangleCount : 0;
+}
+
+// the range the chunk meshes map to 0..HEIGHT_SCALE, same one the gray image was normalized with (the meshes used to be built from it)
+void ChunkHeightRange(const float *heightData, float *minH, float *maxH)
+{
+    *minH = FLT_MAX;
+    *maxH = -FLT_MAX;
+    for (int i = 0; i < MAP_SIZE * MAP_SIZE; i++) {
+        *minH = fminf(*minH, heightData[i]);
+        *maxH = fmaxf(*maxH, heightData[i]);
+    }
+}
+
+// Build all 256 chunk models (every LOD)
+void GenerateChunkModels(float *heightData, Image image, Image colorImage)
+{
+    TraceLog(LOG_INFO, "Chunk Stuff ...");
+    float minH, maxH;
+    ChunkHeightRange(heightData, &minH, &maxH);
+    //a row of chunks at a time: meshes built in parallel, then uploaded here (gl), keeps the cpu side to one row
+    ChunkParts *rowParts = (ChunkParts *)calloc(CHUNK_COUNT, sizeof(ChunkParts));
+    bool *rowOk = (bool *)calloc(CHUNK_COUNT, sizeof(bool));
+    ChunkRowJob job = { rowParts, rowOk, heightData, (const Color *)colorImage.data, minH, maxH, 0 };
+    //models
+    for (int cy = 0; cy < CHUNK_COUNT; cy++) {
+        job.cy = cy;
+        StageTimer stage = StageBegin("HeightfieldMesh (chunk row)");
+        ParallelFor(CHUNK_COUNT, ChunkRowPrepare, &job);
+        StageEnd(stage, CHUNK_COUNT * (CHUNK_SIZE + 1) * (CHUNK_SIZE + 1), 0, 0);
+        for (int cx = 0; cx < CHUNK_COUNT; cx++) {
+            stage = StageBegin("GenerateChunkModel");
+            if (rowOk[cx]) {
+                chunkModels[cx][cy] = ChunkPartsBuild(&rowParts[cx], CHUNK_SIZE,
+                                                      &chunkModels32[cx][cy], &chunkModels16[cx][cy], &chunkModels8[cx][cy]);
+            }
+            else {
+                TraceLog(LOG_ERROR, "chunk %d,%d: could not build the meshes", cx, cy);
+                ChunkPartsFree(&rowParts[cx]);
+            }
+            StageEnd(stage, (CHUNK_SIZE + 1) * (CHUNK_SIZE + 1),
+                     ModelTriangles(chunkModels[cx][cy]) + ModelTriangles(chunkModels32[cx][cy]) +
+                     ModelTriangles(chunkModels16[cx][cy]) + ModelTriangles(chunkModels8[cx][cy]), 0);
+        }
+    }
+    free(rowParts);
+    free(rowOk);
+}
+
+#define EXPORT_VERSION 6 //bump when ExportMap changes what a chunk gets, then every chunk is redone once
+#define WATER_EXPORT_VERSION 3 //same for the water body meshes, only the water is redone
+
+// everything a chunks files are made from: its cells plus the 1 cell halo the slope/vegetation kernels read, in every map
+// that feeds it (the gray image is normalized to the whole maps range, so a range change redoes them all), plus the settings
+// the heights get a wider halo, the mesh normals read one lod stride past the chunk (CHUNK_SIZE / lod cells for the coarsest),
+// and the minH..maxH the meshes are mapped with goes in too, the gray image is only 8 bit so it misses small range changes
+ContentHash ChunkInputHash(int cx, int cy, float *heightData, float minH, float maxH, Image image, Image colorImage, Image slopeImage)
+{
+    int x0 = cx * CHUNK_SIZE - 1;
+    int y0 = cy * CHUNK_SIZE - 1;
+    int w = CHUNK_SIZE + 3;
+    int halo = 1;
+    for (int i = 0; i < world.lodCount; i++) halo = MAX(halo, CHUNK_SIZE / MAX(world.lods[i], 1));
+    ContentHash h = CONTENT_HASH_INIT;
+    h = HashInt(h, EXPORT_VERSION);
+    h = HashInt(h, CHUNK_COUNT);
+    h = HashInt(h, CHUNK_SIZE);
+    h = HashInt(h, TILE_GRID_SIZE);
+    h = HashInt(h, MAP_SCALE);
+    h = HashFloat(h, HEIGHT_SCALE);
+    h = HashInt(h, UPSCALED_TEXTURE_SIZE);
+    h = HashBytes(h, world.lods, sizeof(world.lods));
+    h = HashInt(h, ASSET_TWEAK_MOD);
+    h = HashInt(h, ASSET_TWEAK_THRESH);
+    h = HashInt(h, MAX_PROPS_ALLOWED);
+    h = HashInt(h, meshHeightBits);
+    h = HashFloat(h, minH);
+    h = HashFloat(h, maxH);
+    h = HashFloatWindow(h, heightData, MAP_SIZE, cx * CHUNK_SIZE - halo, cy * CHUNK_SIZE - halo, CHUNK_SIZE + 1 + 2 * halo, CHUNK_SIZE + 1 + 2 * halo);
+    h = HashImageWindow(h, image, x0, y0, w, w);
+    h = HashImageWindow(h, colorImage, x0, y0, w, w);
+    h = HashImageWindow(h, slopeImage, x0, y0, w, w);
+    h = HashImageWindow(h, hardRoadMap, x0, y0, w, w); //road tint and vegetation read it at cell coordinates
+    return h;
+}
+
+// map/manifest.txt from the per chunk manifests (BakeTileObjects), in chunk order, swapped in whole
+void AssembleTileManifest(void)
+{
+    FILE *out = AtomicFileOpen("map/manifest.txt", "w");
+    if (!out) return;
+    for (int cy = 0; cy < CHUNK_COUNT; cy++) {
+        for (int cx = 0; cx < CHUNK_COUNT; cx++) {
+            char path[64];
+            snprintf(path, sizeof(path), "map/chunk_%02d_%02d/manifest.txt", cx, cy);
+            FILE *in = fopen(path, "r");
+            if (!in) continue;
+            char line[512];
+            while (fgets(line, sizeof(line), in)) fputs(line, out);
+            fclose(in);
+        }
+    }
+    AtomicFileCommit(out, "map/manifest.txt");
+}
+
+// P in create: write everything play needs into map/ (images, water, chunk meshes, vegetation, tile batches, textures)
+// incremental skips chunks (and the water) whose inputs hash the same as the last export, --bench always does everything
+void ExportMap(float *heightData, Image image, Image colorImage, Image slopeImage, bool incremental)
+{
+    //for now, I dont want to clamp, to see if the seams and artifacts are better or worse or the same
+    //what I think is happening is screwing with the vertices causes problems with normals, and then distant rendering is a problem
+    //as Im writing this, Im not sure tho as I cant test yest (map gen takes a while and I have other things first)
+    //TraceLog(LOG_INFO, "Clamping LOD edges ...");
+    // ClampMeshEdges(chunkModels32, 33);//todo, should i remove these clamp functions, or change, them, I still see some very small seams?
+    // ClampMeshEdges(chunkModels16, 17);
+    // ClampMeshEdges(chunkModels8, 9);
+
+    TraceLog(LOG_INFO, "road stuff again ... (and in game map image)");
+    Image inGameMap = ImageCopy(colorImage);
+    TimedImageResize(&inGameMap,128,128);
+    remove("map/water_manifest.txt");//old per chunk water, bodies replace it
+    WorldSave(WORLD_PATH); //play/lod/validate_tiles size themselves from this
+    TimedExportImage(roadImage, "map/road_map.png");
+    TimedExportImage(hardRoadMap, "map/hard_road_map.png");
+    TimedExportImage(inGameMap, "map/elevation_color_map.png");
+    TimedExportImage(image, "map/map_height.png");
+    TimedExportImage(slopeImage, "map/map_slope.png");
+
+    //water bodies span chunks, so they hash the whole height map
+    ContentHash waterHash = HashFloatWindow(HashInt(HashInt(CONTENT_HASH_INIT, EXPORT_VERSION), WATER_EXPORT_VERSION), heightData, MAP_SIZE, 0, 0, MAP_SIZE, MAP_SIZE);
+    ContentHash oldWaterHash = 0;
+    FILE *wf = fopen("map/water/hash.txt", "r");
+    if (wf) {
+        unsigned long long v = 0;
+        if (fscanf(wf, "%llx", &v) == 1) oldWaterHash = (ContentHash)v;
+        fclose(wf);
+    }
+    StageTimer stage;
+    if (incremental && oldWaterHash == waterHash && FileExists("map/water_bodies.txt")) {
+        TraceLog(LOG_INFO, "water bodies unchanged, skipping");
+    }
+    else {
+        TraceLog(LOG_INFO, "water bodies (whole map)...");
+        stage = StageBegin("CreateWorldWaterBodies");
+        CreateWorldWaterBodies(heightData, MAP_SIZE, 0);
+        StageEnd(stage, MAP_SIZE * MAP_SIZE, 0, FileSizeBytes("map/water_bodies.txt"));
+        wf = AtomicFileOpen("map/water/hash.txt", "w");
+        if (wf) {
+            fprintf(wf, "%016llx\n", (unsigned long long)waterHash);
+            AtomicFileCommit(wf, "map/water/hash.txt");
+        }
+    }
+    TraceLog(LOG_INFO, "Exporting all chunks...");
+    float minH, maxH;
+    ChunkHeightRange(heightData, &minH, &maxH); //what the chunk meshes were built with
+    int skipped = 0;
+    for (int cy = 0; cy < CHUNK_COUNT; cy++) {
+        for (int cx = 0; cx < CHUNK_COUNT; cx++) {
+            //check directory first
+            TraceLog(LOG_INFO, "Checking Directory (%d,%d)...", cx, cy);
+            char fnameDir[64];
+            snprintf(fnameDir, sizeof(fnameDir), "map/chunk_%02d_%02d", cx, cy);
+            EnsureDirectoryExists(fnameDir);
+
+            //same inputs as the last export and the files are still there, nothing to do
+            ContentHash inputHash = ChunkInputHash(cx, cy, heightData, minH, maxH, image, colorImage, slopeImage);
+            ContentHash oldHash = 0;
+            char fnameLast[64];
+            snprintf(fnameLast, sizeof(fnameLast), "map/chunk_%02d_%02d/avg_big.png", cx, cy); //written last
+            if (incremental && ChunkHashRead(cx, cy, &oldHash) && oldHash == inputHash && FileExists(fnameLast)) {
+                skipped++;
+                continue;
+            }
+            char fnameManifest[64];
+            snprintf(fnameManifest, sizeof(fnameManifest), "map/chunk_%02d_%02d/manifest.txt", cx, cy);
+            remove(fnameManifest); //BakeTileObjects appends, start clean
+
+            TraceLog(LOG_INFO, "Exporting chunk (%d,%d)...", cx, cy);
+            int chunkSize = CHUNK_SIZE + 1; //to get 64 quads?
+
+            Image heightImage = GenImageColor(chunkSize, chunkSize, BLACK);
+            Image colorImage2 = GenImageColor(chunkSize, chunkSize, BLACK);
+            Image slopeImage2 = GenImageColor(chunkSize, chunkSize, BLACK);
+
+            Color *heightPixels = (Color *)heightImage.data;
+            Color *colorPixels = (Color *)colorImage2.data;
+            Color *colorData = (Color *)colorImage.data;
+            Color *slopeData = (Color *)slopeImage.data;
+            Color *slopePixels = (Color *)slopeImage2.data;
+
+            stage = StageBegin("chunk slice");
+            for (int y = 0; y < chunkSize; y++) {
+                for (int x = 0; x < chunkSize; x++) {
+                    int globalX = cx * CHUNK_SIZE + x;
+                    int globalY = cy * CHUNK_SIZE + y;
+                    int srcIndex = globalY * MAP_SIZE + globalX;
+                    int dstIndex = y * chunkSize + x;
+
+                    // Height to grayscale
+                    float h = heightData[srcIndex];
+                    unsigned char gray = (unsigned char)((h + 1.0f) * 127.5f); // Normalize -1..1 to 0..255
+                    heightPixels[dstIndex] = (Color){gray, gray, gray, 255};
+
+                    // Color already provided
+                    colorPixels[dstIndex] = colorData[srcIndex];
+                    slopePixels[dstIndex] = slopeData[srcIndex];
+                }
+            }
+            StageEnd(stage, chunkSize * chunkSize, 0, 0);
+            // Perlin vegetation noise (scale if needed)
+            TraceLog(LOG_INFO, "vegetation (%d,%d)...", cx, cy);
+            stage = StageBegin("SaveChunkVegetationImage");
+            SaveChunkVegetationImage(cx, cy, heightData, colorData, MAP_SIZE, HEIGHT_SCALE);
+            StageEnd(stage, CHUNK_SIZE * CHUNK_SIZE, 0, 0);
+            char fnameHeight[64];
+            char fnameColor[64];
+            char fnameSlope[64];
+            char fnameSlopeBig[64];
+            char fnameHeight64[64];
+
+            snprintf(fnameHeight, sizeof(fnameHeight), "map/chunk_%02d_%02d/height.png", cx, cy);
+            snprintf(fnameColor, sizeof(fnameColor), "map/chunk_%02d_%02d/color.png", cx, cy);
+            snprintf(fnameSlope, sizeof(fnameSlope), "map/chunk_%02d_%02d/slope.png", cx, cy);
+            snprintf(fnameSlopeBig, sizeof(fnameSlopeBig), "map/chunk_%02d_%02d/slope_big.png", cx, cy);
+            snprintf(fnameHeight64, sizeof(fnameHeight64), "map/chunk_%02d_%02d/height64.png", cx, cy);
+
+            // Rebuild mesh for this chunk using height and color image
+            Texture2D textureColors = LoadTextureFromImage(colorImage);
+            Model model = LoadModelFromMesh(chunkModels[cx][cy].meshes[0]);
+            model.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = textureColors;
+
+            TimedImageResize(&colorImage2, 64, 64); // Resize to power-of-two dimensions
+            TimedImageResize(&slopeImage2, 64, 64); // Resize to power-of-two dimensions
+            Image img = {
+                .data = colorImage2.data,
+                .width = 64,
+                .height = 64,
+                .mipmaps = 1,
+                .format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8
+            };
+            Image img2 = {
+                .data = slopeImage2.data,
+                .width = 64,
+                .height = 64,
+                .mipmaps = 1,
+                .format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8
+            };
+            Image img3 = ImageCopy(heightImage);
+            TimedImageResize(&img3,64,64);
+            TimedExportImage(img3, fnameHeight64);
+            //roads handle - this sets the colors for the textures
+            stage = StageBegin("chunk road tint");
+            for(int y=0; y<img.height; y++)
+            {
+                for(int x=0; x<img.width; x++)
+                {
+                    int globalX = cx * CHUNK_SIZE + x;
+                    int globalY = cy * CHUNK_SIZE + y;
+                    Color tp = GetImageColor(hardRoadMap, globalX, globalY);
+                    //Color roadPixel = GetImageColor(roadImage, globalX, globalY);
+                    Color imgPixel = GetImageColor(img, x, y);
+                    Color img2Pixel = GetImageColor(img2, x, y);
+                    if (tp.r > 200) {
+                        //average terrain color with road
+                        Color roadColor = (Color){ 100, 80, 50, 255 }; // visible dirt road brown
+                        Color c1 = AverageColor(roadColor, imgPixel);
+                        Color c2 = AverageColor(roadColor, img2Pixel);
+                        ImageDrawPixel(&img, x, y, c1);
+                        ImageDrawPixel(&img2, x, y, c2);
+                    }
+                }
+            }
+            StageEnd(stage, img.width * img.height, 0, 0);
+            //models gen
+            char fnameObj[64];
+            char fnameObj32[64];
+            char fnameObj16[64];
+            char fnameObj8[64];
+            snprintf(fnameObj, sizeof(fnameObj), "map/chunk_%02d_%02d/%d.%s", cx, cy, world.lods[0], world.meshFormat);
+            snprintf(fnameObj32, sizeof(fnameObj32), "map/chunk_%02d_%02d/%d.%s", cx, cy, world.lods[1], world.meshFormat);
+            snprintf(fnameObj16, sizeof(fnameObj16), "map/chunk_%02d_%02d/%d.%s", cx, cy, world.lods[2], world.meshFormat);
+            snprintf(fnameObj8, sizeof(fnameObj8), "map/chunk_%02d_%02d/%d.%s", cx, cy, world.lods[3], world.meshFormat);
+            TimedExportMesh(chunkModels[cx][cy].meshes[0], fnameObj);
+            TimedExportMesh(chunkModels32[cx][cy].meshes[0], fnameObj32);
+            TimedExportMesh(chunkModels16[cx][cy].meshes[0], fnameObj16);
+            TimedExportMesh(chunkModels8[cx][cy].meshes[0], fnameObj8);
+
+            UnloadModel(model); // also unloads mesh internally
+            UnloadTexture(textureColors);
+            TimedExportImage(heightImage, fnameHeight);
+            //ExportImage(img, fnameColor);
+            //ExportImage(img2, fnameSlope);
+            //big colors
+            stage = StageBegin("texture upscale (nearest+jitter)");
+            //jitter is keyed by chunk and image, so a chunk comes out the same whatever order (or which run) exports it
+            unsigned int chunkKey = (unsigned int)(cy * CHUNK_COUNT + cx) * 3u;
+            Image upscaled = UpscaleNearestJitter(img, UPSCALED_TEXTURE_SIZE, chunkKey + 1u);
+            char outName[256];
+            snprintf(outName, sizeof(outName), "map/chunk_%02d_%02d/color_big.png", cx, cy);
+            //ExportImage(upscaled, outName);
+            //big slope
+            Image upscaled2 = UpscaleNearestJitter(img2, UPSCALED_TEXTURE_SIZE, chunkKey + 2u);
+            Image upscaled3 = UpscaleNearestJitter(img3, UPSCALED_TEXTURE_SIZE, chunkKey + 3u);
+            //ExportImage(upscaled2, fnameSlopeBig);
+            StageEnd(stage, 3 * UPSCALED_TEXTURE_SIZE * UPSCALED_TEXTURE_SIZE, 0, 0);
+
+            stage = StageBegin("AverageImages");
+            Image average = AverageImages(img3,AverageImages(img,img2));
+            Image averageBig = AverageImages(upscaled3,AverageImages(upscaled,upscaled2));//here we are still 1024
+            StageEnd(stage, 2 * (img.width * img.height + UPSCALED_TEXTURE_SIZE * UPSCALED_TEXTURE_SIZE), 0, 0);
+            // TimedImageResize(&upscaled2, 128, 128); //todo: remove these if not needed
+            // TimedImageResize(&upscaled, 128, 128);
+
+            char avgName[256];
+            char avgBigName[256];
+            char avgFullName[256];
+            char avgDamnName[256];
+            snprintf(avgName, sizeof(avgName), "map/chunk_%02d_%02d/avg.png", cx, cy);
+            snprintf(avgBigName, sizeof(avgBigName), "map/chunk_%02d_%02d/avg_big.png", cx, cy);
+            snprintf(avgFullName, sizeof(avgFullName), "map/chunk_%02d_%02d/avg_full.png", cx, cy);
+            snprintf(avgDamnName, sizeof(avgDamnName), "map/chunk_%02d_%02d/avg_damn.png", cx, cy);
+            TimedExportImage(average, avgName);//far away we can cheat and just use the 64 which is small and very pixely
+            //damn!
+            TraceLog(LOG_INFO, "song2");
+            stage = StageBegin("UpscaleImageBilinear");
+            Image damn = UpscaleImageBilinear(averageBig, 2057, 2057);//damn! (actually the full size now but didnt want to swtich all the variable names)
+            StageEnd(stage, 2057 * 2057, 0, 0);
+            TimedImageResize(&damn, 1024, 1024);
+
+            //damn (1024), full (512) and big (256) are the top of one mip chain now, not three resizes
+            stage = StageBegin("ImageBuildMipChain");
+            ImageBuildMipChain(&damn);
+            StageEnd(stage, 1024 * 1024, 0, 0);
+            TimedExportImage(MipLevelView(damn, 0), avgDamnName); //damn!
+            TimedExportImage(MipLevelView(damn, 1), avgFullName);
+            TimedExportImage(MipLevelView(damn, 2), avgBigName);
+
+            UnloadImage(damn); //beaver? DAMN!
+            UnloadImage(average);
+            UnloadImage(averageBig);
+            UnloadImage(upscaled2);
+            UnloadImage(upscaled);
+            UnloadImage(heightImage);
+            UnloadImage(colorImage2);
+            UnloadImage(slopeImage2);
+            ChunkHashWrite(cx, cy, inputHash); //only once everything for the chunk is on disk
+        }
+    }
+    AssembleTileManifest();
+    TraceLog(LOG_INFO, "Exported %d chunks, %d unchanged", CHUNK_COUNT * CHUNK_COUNT - skipped, skipped);
+}
+
+//------------------------------------------------------------------tiled (out of core) generation
+//create --tiled: for worlds too big to hold in ram (4096x4096 cells and up), nothing full size is ever allocated
+//the height field lives in two TileStores on disk, each pass reads a tile plus a halo, works on that window,
+//and writes only the tile into the other store, the halo is as far as the pass can reach so tiles dont see their window edge
+//roads, water bodies and props still need the whole map in ram, so this mode exports terrain only (meshes, heights, textures)
+//--shard i/N splits the chunk rows into N bands, one process each, a shard recomputes the tiles its halos reach into
+//instead of waiting on its neighbours, every tile is a pure function of the seed and its window, so both copies match
+//create --merge N then checks all the bands are there and puts the in game map together from them
+#define GEN_TILE_SIZE 512
+#define GEN_DIR "map/gen"
+#define GEN_HYDRAULIC_HALO (EROSION_LIFETIME + 2) //a droplet moves at most one cell per step
+#define GEN_EROSION_STEPS 5
+#define GEN_EROSION_HALO (2 * GEN_EROSION_STEPS) //thermal erosion reaches 2 cells per step (see ApplyErosion)
+#define GEN_DROPLET_AREA (1024 * 1024) //EROSION_DROPLETS per this many cells, same density as the in ram map
+
+static inline int GenTileExtent(int t, int worldSize)
+{
+    int rest = worldSize - t * GEN_TILE_SIZE;
+    return rest < GEN_TILE_SIZE ? rest : GEN_TILE_SIZE;
+}
+
+static inline int GenTileRow(int cellY, int tilesPerSide)
+{
+    int ty = (cellY < 0 ? 0 : cellY) / GEN_TILE_SIZE;
+    return ty >= tilesPerSide ? tilesPerSide - 1 : ty;
+}
+
+// tile rows whose droplets can reach into tile rows ty0..ty1
+static inline void GenDropletRows(int ty0, int ty1, int tilesPerSide, int rows[2])
+{
+    rows[0] = GenTileRow(ty0 * GEN_TILE_SIZE - GEN_HYDRAULIC_HALO, tilesPerSide);
+    rows[1] = GenTileRow((ty1 + 1) * GEN_TILE_SIZE - 1 + GEN_HYDRAULIC_HALO, tilesPerSide);
+}
+
+// tile rows ty0..ty1 (inclusive) each pass has to produce so the chunk rows [cy0, cy1) can be exported
+void GenTiledRows(int cy0, int cy1, int tilesPerSide, int erosion[2], int hydraulic[2], int noise[2])
+{
+    //the chunk export reads one cell past the chunk on every side
+    erosion[0] = GenTileRow(cy0 * CHUNK_SIZE - 1, tilesPerSide);
+    erosion[1] = GenTileRow(cy1 * CHUNK_SIZE + 1, tilesPerSide);
+    hydraulic[0] = GenTileRow(erosion[0] * GEN_TILE_SIZE - GEN_EROSION_HALO, tilesPerSide);
+    hydraulic[1] = GenTileRow((erosion[1] + 1) * GEN_TILE_SIZE - 1 + GEN_EROSION_HALO, tilesPerSide);
+    //the hydraulic rows take droplets from the tile rows around them too, and those read their own halo of noise
+    int droplets[2];
+    GenDropletRows(hydraulic[0], hydraulic[1], tilesPerSide, droplets);
+    noise[0] = GenTileRow(droplets[0] * GEN_TILE_SIZE - GEN_HYDRAULIC_HALO, tilesPerSide);
+    noise[1] = GenTileRow((droplets[1] + 1) * GEN_TILE_SIZE - 1 + GEN_HYDRAULIC_HALO, tilesPerSide);
+}
+
+void GenTiledNoise(TileStore *dst, int ty0, int ty1, float scale, float frequency, int octaves, int seed, float lacunarity)
+{
+    float *buf = (float *)malloc(sizeof(float) * GEN_TILE_SIZE * GEN_TILE_SIZE);
+    for (int ty = ty0; ty <= ty1; ty++) {
+        for (int tx = 0; tx < dst->tilesPerSide; tx++) {
+            int w = GenTileExtent(tx, dst->worldSize);
+            int h = GenTileExtent(ty, dst->worldSize);
+            GenerateHeightmapRegion(buf, tx * GEN_TILE_SIZE, ty * GEN_TILE_SIZE, w, h, dst->worldSize, scale, frequency, octaves, seed, lacunarity);
+            TileStoreWriteWindow(dst, tx * GEN_TILE_SIZE, ty * GEN_TILE_SIZE, w, h, buf, w);
+        }
+    }
+    free(buf);
+}
+
+// droplets only start inside their tile, each tile has its own random key and runs on the untouched src window,
+// what it changes (in the tile and in the halo) is added into dst, so a cell near a seam gets what every neighbouring tile's
+// droplets did to it, tiles are added in row order so every shard that makes a tile row gets the same bits
+void GenTiledHydraulic(TileStore *src, TileStore *dst, int ty0, int ty1, int seed)
+{
+    const int halo = GEN_HYDRAULIC_HALO;
+    const int W = GEN_TILE_SIZE + 2 * halo;
+    float *win = (float *)malloc(sizeof(float) * W * W);
+    float *orig = (float *)malloc(sizeof(float) * W * W);
+    if (!win || !orig) {
+        TraceLog(LOG_ERROR, "TILED: out of memory for the hydraulic window");
+        free(win); free(orig);
+        return;
+    }
+    //dst starts as src over the rows being made
+    for (int ty = ty0; ty <= ty1; ty++) {
+        for (int tx = 0; tx < src->tilesPerSide; tx++) {
+            int w = GenTileExtent(tx, src->worldSize);
+            int h = GenTileExtent(ty, src->worldSize);
+            TileStoreReadWindow(src, tx * GEN_TILE_SIZE, ty * GEN_TILE_SIZE, w, h, win);
+            TileStoreWriteWindow(dst, tx * GEN_TILE_SIZE, ty * GEN_TILE_SIZE, w, h, win, w);
+        }
+    }
+    //then every tile whose droplets reach those rows adds its change, clipped to them
+    int rowMin = ty0 * GEN_TILE_SIZE;
+    int rowMax = (ty1 + 1) * GEN_TILE_SIZE;
+    int rows[2];
+    GenDropletRows(ty0, ty1, src->tilesPerSide, rows);
+    for (int ty = rows[0]; ty <= rows[1]; ty++) {
+        for (int tx = 0; tx < src->tilesPerSide; tx++) {
+            int w = GenTileExtent(tx, src->worldSize);
+            int h = GenTileExtent(ty, src->worldSize);
+            int x0 = tx * GEN_TILE_SIZE - halo;
+            int y0 = ty * GEN_TILE_SIZE - halo;
+            TileStoreReadWindow(src, x0, y0, W, W, win);
+            memcpy(orig, win, sizeof(float) * W * W);
+            unsigned int key = CounterRandom((unsigned int)seed, (unsigned int)(ty * src->tilesPerSide + tx)) | 1u; //never 0
+            int droplets = (int)((long long)EROSION_DROPLETS * w * h / GEN_DROPLET_AREA);
+            ApplyErosionHydraulicRegion(win, W, W, halo, halo, w, h, droplets, key);
+            for (int i = 0; i < W * W; i++) win[i] -= orig[i];
+            int wy0 = MAX(y0, rowMin);
+            int wy1 = MIN(y0 + W, rowMax);
+            if (wy1 > wy0) TileStoreAddWindow(dst, x0, wy0, W, wy1 - wy0, &win[(wy0 - y0) * W], W);
+        }
+    }
+    free(win);
+    free(orig);
+}
+
+// also finds the height range of the rows it did, for the log
+void GenTiledErosion(TileStore *src, TileStore *dst, int ty0, int ty1, float *outMin, float *outMax)
+{
+    const int halo = GEN_EROSION_HALO;
+    const int W = GEN_TILE_SIZE + 2 * halo;
+    float *win = (float *)malloc(sizeof(float) * W * W);
+    float min = FLT_MAX, max = -FLT_MAX;
+    for (int ty = ty0; ty <= ty1; ty++) {
+        for (int tx = 0; tx < src->tilesPerSide; tx++) {
+            int w = GenTileExtent(tx, src->worldSize);
+            int h = GenTileExtent(ty, src->worldSize);
+            TileStoreReadWindow(src, tx * GEN_TILE_SIZE - halo, ty * GEN_TILE_SIZE - halo, W, W, win);
+            ApplyErosion(win, W, W, GEN_EROSION_STEPS, 0.01f);
+            for (int y = 0; y < h; y++) {
+                for (int x = 0; x < w; x++) {
+                    float v = win[(y + halo) * W + x + halo];
+                    if (v < min) min = v;
+                    if (v > max) max = v;
+                }
+            }
+            TileStoreWriteWindow(dst, tx * GEN_TILE_SIZE, ty * GEN_TILE_SIZE, w, h, &win[halo * W + halo], W);
+        }
+    }
+    free(win);
+    *outMin = min;
+    *outMax = max;
+}
+
+// the small in game map play shows, point sampled straight from the tiles
+// only the pixels that land in cell rows [y0, y1) are filled, the rest stay transparent for --merge to fill from the other shards
+void GenTiledInGameMap(TileStore *store, int y0, int y1, const char *path)
+{
+    const int size = 128;
+    float *samples = (float *)malloc(sizeof(float) * size * size);
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            TileStoreReadWindow(store, x * store->worldSize / size, y * store->worldSize / size, 1, 1, &samples[y * size + x]);
+        }
+    }
+    Image map = GenImageColor(size, size, BLACK);
+    RebuildColorImageFromHeightData(&map, samples, size, size);
+    Color *pixels = (Color *)map.data;
+    for (int y = 0; y < size; y++) {
+        int cellY = y * store->worldSize / size;
+        if (cellY < y0 || cellY >= y1) {
+            for (int x = 0; x < size; x++) pixels[y * size + x] = BLANK;
+        }
+    }
+    TimedExportImage(map, path);
+    UnloadImage(map);
+    free(samples);
+}
+
+// one chunk from a window of the store with a 1 cell halo (for the slope), same files ExportMap writes for the terrain
+// the textures skip the road tint and the jittered 1024 upscale, there is no road map and the bilinear upscale of avg covers it
+// gray heights use the full -1..1 noise range (not the measured one) so shards that never see each other agree on it
+void GenTiledExportChunk(TileStore *store, int cx, int cy)
+{
+    const int N = CHUNK_SIZE + 1; //verts per side
+    const int W = N + 2;
+    float *win = (float *)malloc(sizeof(float) * W * W);
+    TileStoreReadWindow(store, cx * CHUNK_SIZE - 1, cy * CHUNK_SIZE - 1, W, W, win);
+
+    Image colorWin = GenImageColor(W, W, BLACK);
+    Image slopeWin = GenImageColor(W, W, BLACK);
+    RebuildColorImageFromHeightData(&colorWin, win, W, W);
+    RebuildSlopeImageFromHeightData(&slopeWin, win, W, W);
+    Rectangle inner = { 1, 1, (float)N, (float)N };
+    Image color = ImageFromImage(colorWin, inner);
+    Image slope = ImageFromImage(slopeWin, inner);
+    UnloadImage(slopeWin);
+
+    Image heightImage = GenImageColor(N, N, BLACK);
+    Color *heightPixels = (Color *)heightImage.data;
+    for (int y = 0; y < N; y++) {
+        for (int x = 0; x < N; x++) {
+            unsigned char g = (unsigned char)((win[(y + 1) * W + x + 1] + 1.0f) * 127.5f); // Normalize -1..1 to 0..255
+            heightPixels[y * N + x] = (Color){ g, g, g, 255 };
+        }
+    }
+
+    char path[256];
+    snprintf(path, sizeof(path), "map/chunk_%02d_%02d", cx, cy);
+    EnsureDirectoryExists(path);
+
+    //meshes
+    Model m32, m16, m8;
+    StageTimer stage = StageBegin("GenerateChunkModel");
+    //straight from the float window, the chunk starts at 1,1 and the halo gives the edge normals real neighbours
+    Model m64 = GenerateChunkLods(win, -1.0f, 1.0f, colorWin, W, 1, 1, CHUNK_SIZE, HEIGHT_SCALE, &m32, &m16, &m8);
+    StageEnd(stage, N * N, ModelTriangles(m64) + ModelTriangles(m32) + ModelTriangles(m16) + ModelTriangles(m8), 0);
+    free(win);
+    UnloadImage(colorWin);
+    Model *lods[4] = { &m64, &m32, &m16, &m8 };
+    for (int i = 0; i < 4; i++) {
+        if (lods[i]->meshCount == 0) continue;
+        snprintf(path, sizeof(path), "map/chunk_%02d_%02d/%d.%s", cx, cy, world.lods[i], world.meshFormat);
+        TimedExportMesh(lods[i]->meshes[0], path);
+    }
+    UnloadTexture(m64.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture);
+    for (int i = 0; i < 4; i++) UnloadModel(*lods[i]);
+
+    //heights
+    snprintf(path, sizeof(path), "map/chunk_%02d_%02d/height.png", cx, cy);
+    TimedExportImage(heightImage, path);
+    Image height64 = ImageCopy(heightImage);
+    TimedImageResize(&height64, 64, 64);
+    snprintf(path, sizeof(path), "map/chunk_%02d_%02d/height64.png", cx, cy);
+    TimedExportImage(height64, path);
+
+    //textures, same mix as ExportMap (height, color, slope averaged)
+    TimedImageResize(&color, 64, 64);
+    TimedImageResize(&slope, 64, 64);
+    Image colorSlope = AverageImages(color, slope);
+    Image average = AverageImages(height64, colorSlope);
+    snprintf(path, sizeof(path), "map/chunk_%02d_%02d/avg.png", cx, cy);
+    TimedExportImage(average, path);
+    stage = StageBegin("UpscaleImageBilinear");
+    Image damn = UpscaleImageBilinear(average, UPSCALED_TEXTURE_SIZE, UPSCALED_TEXTURE_SIZE);
+    StageEnd(stage, UPSCALED_TEXTURE_SIZE * UPSCALED_TEXTURE_SIZE, 0, 0);
+    ImageBuildMipChain(&damn);
+    snprintf(path, sizeof(path), "map/chunk_%02d_%02d/avg_damn.png", cx, cy);
+    TimedExportImage(MipLevelView(damn, 0), path);
+    snprintf(path, sizeof(path), "map/chunk_%02d_%02d/avg_full.png", cx, cy);
+    TimedExportImage(MipLevelView(damn, 1), path);
+    snprintf(path, sizeof(path), "map/chunk_%02d_%02d/avg_big.png", cx, cy);
+    TimedExportImage(MipLevelView(damn, 2), path);
+
+    UnloadImage(damn);
+    UnloadImage(average);
+    UnloadImage(colorSlope);
+    UnloadImage(height64);
+    UnloadImage(heightImage);
+    UnloadImage(color);
+    UnloadImage(slope);
+}
+
+// create --tiled [--shard i/N]: heightmap, hydraulic erosion, erosion, then every chunk in this shards band of chunk rows
+// ram is bounded by the tile cache (not the world size), unsharded runs are just shard 0 of 1
+int RunTiledGeneration(float scale, float frequency, int octaves, int seed, float lacunarity, int shard, int shardCount)
+{
+    if (shardCount < 1 || shard < 0 || shard >= shardCount || shardCount > CHUNK_COUNT) {
+        TraceLog(LOG_ERROR, "TILED: bad shard %d/%d for %d chunk rows", shard, shardCount, CHUNK_COUNT);
+        return -1;
+    }
+    int cy0 = shard * CHUNK_COUNT / shardCount;
+    int cy1 = (shard + 1) * CHUNK_COUNT / shardCount;
+    char shardDir[128], dirA[160], dirB[160];
+    snprintf(shardDir, sizeof(shardDir), GEN_DIR "/shard_%d", shard);
+    snprintf(dirA, sizeof(dirA), "%s/a", shardDir);
+    snprintf(dirB, sizeof(dirB), "%s/b", shardDir);
+    EnsureDirectoryExists("map/");
+    EnsureDirectoryExists(GEN_DIR);
+    EnsureDirectoryExists(shardDir);
+    EnsureDirectoryExists(dirA);
+    EnsureDirectoryExists(dirB);
+    char path[256];
+    snprintf(path, sizeof(path), "%s/done.txt", shardDir);
+    remove(path); //a stale one from an older run must not fool --merge
+    if (shard == 0) {WorldSave(WORLD_PATH);}
+    if (shardCount == 1) {
+        remove("map/manifest.txt");
+        remove("map/water_manifest.txt");
+        remove("map/water_bodies.txt");
+    }
+
+    TileStore a = { 0 }, b = { 0 };
+    if (!TileStoreInit(&a, dirA, MAP_SIZE, GEN_TILE_SIZE) || !TileStoreInit(&b, dirB, MAP_SIZE, GEN_TILE_SIZE)) {
+        TileStoreClose(&a);
+        TileStoreClose(&b);
+        return -1;
+    }
+    int erosionRows[2], hydraulicRows[2], noiseRows[2];
+    GenTiledRows(cy0, cy1, a.tilesPerSide, erosionRows, hydraulicRows, noiseRows);
+    TraceLog(LOG_INFO, "TILED: %dx%d cells in %dx%d tiles of %d, shard %d/%d does chunk rows %d-%d (tile rows %d-%d)",
+             MAP_SIZE, MAP_SIZE, a.tilesPerSide, a.tilesPerSide, GEN_TILE_SIZE, shard, shardCount, cy0, cy1 - 1, noiseRows[0], noiseRows[1]);
+    srand(seed);
+    SetRandomSeed(seed);
+    StageReset();
+    double t0 = StageClockMs(CLOCK_MONOTONIC);
+    int64_t rowCells = (int64_t)MAP_SIZE * GEN_TILE_SIZE;
+
+    StageTimer stage = StageBegin("GenerateHeightmap");
+    GenTiledNoise(&a, noiseRows[0], noiseRows[1], scale, frequency, octaves, seed, lacunarity);
+    TileStoreFlush(&a);
+    StageEnd(stage, (noiseRows[1] - noiseRows[0] + 1) * rowCells, 0, a.bytesWritten);
+
+    stage = StageBegin("ApplyErosionHydraulic");
+    long long before = b.bytesWritten;
+    GenTiledHydraulic(&a, &b, hydraulicRows[0], hydraulicRows[1], seed);
+    TileStoreFlush(&b);
+    StageEnd(stage, (hydraulicRows[1] - hydraulicRows[0] + 1) * rowCells, 0, b.bytesWritten - before);
+
+    float min = 0.0f, max = 0.0f;
+    stage = StageBegin("ApplyErosion");
+    before = a.bytesWritten;
+    GenTiledErosion(&b, &a, erosionRows[0], erosionRows[1], &min, &max);
+    TileStoreFlush(&a);
+    StageEnd(stage, GEN_EROSION_STEPS * (erosionRows[1] - erosionRows[0] + 1) * rowCells, 0, a.bytesWritten - before);
+    printf("Height range: %.3f to %.3f\n", min, max);
+
+    if (shardCount == 1) {snprintf(path, sizeof(path), "map/elevation_color_map.png");}
+    else {snprintf(path, sizeof(path), "%s/ingame.png", shardDir);}
+    GenTiledInGameMap(&a, cy0 * CHUNK_SIZE, cy1 * CHUNK_SIZE, path);
+    TraceLog(LOG_INFO, "Exporting chunks...");
+    for (int cy = cy0; cy < cy1; cy++) {
+        for (int cx = 0; cx < CHUNK_COUNT; cx++) {
+            TraceLog(LOG_INFO, "Exporting chunk (%d,%d)...", cx, cy);
+            GenTiledExportChunk(&a, cx, cy);
+        }
+    }
+    double totalMs = StageClockMs(CLOCK_MONOTONIC) - t0;
+    TraceLog(LOG_INFO, "TILED: %.1f MB read, %.1f MB written to %s", (a.bytesRead + b.bytesRead) / (1024.0 * 1024.0),
+             (a.bytesWritten + b.bytesWritten) / (1024.0 * 1024.0), shardDir);
+
+    TileStoreClose(&a);
+    TileStoreClose(&b);
+    TileStoreRemoveFiles(&a);
+    TileStoreRemoveFiles(&b);
+
+    //written last, --merge only trusts shards that got this far
+    snprintf(path, sizeof(path), "%s/done.txt", shardDir);
+    FILE *f = fopen(path, "w");
+    if (f) {
+        fprintf(f, "%d %d %d %d %d %d\n", shard, shardCount, cy0, cy1, CHUNK_COUNT, seed);
+        fclose(f);
+    }
+    StagePrintSummary();
+    TraceLog(LOG_INFO, "TILED: total %.1f s", totalMs / 1000.0);
+    return 0;
+}
+
+// create --merge N: after N --shard runs, check every chunk row was made once, then build the in game map from the shard bands
+int RunShardMerge(int shardCount)
+{
+    if (!WorldLoad(WORLD_PATH)) return -1;
+    bool *covered = (bool *)calloc(CHUNK_COUNT, sizeof(bool));
+    bool ok = true;
+    int seed = -1;
+    for (int i = 0; i < shardCount && ok; i++) {
+        char path[256];
+        snprintf(path, sizeof(path), GEN_DIR "/shard_%d/done.txt", i);
+        FILE *f = fopen(path, "r");
+        int s, n, cy0, cy1, chunks, shardSeed;
+        if (!f || fscanf(f, "%d %d %d %d %d %d", &s, &n, &cy0, &cy1, &chunks, &shardSeed) != 6) {
+            TraceLog(LOG_ERROR, "MERGE: shard %d/%d is missing or did not finish (%s)", i, shardCount, path);
+            ok = false;
+        }
+        else if (s != i || n != shardCount || chunks != CHUNK_COUNT || (seed >= 0 && shardSeed != seed)) {
+            TraceLog(LOG_ERROR, "MERGE: shard %d was made for a different run (%d/%d, %d chunks, seed %d)", i, s, n, chunks, shardSeed);
+            ok = false;
+        }
+        else {
+            seed = shardSeed;
+            for (int cy = cy0; cy < cy1; cy++) covered[cy] = true;
+        }
+        if (f) fclose(f);
+    }
+    for (int cy = 0; cy < CHUNK_COUNT && ok; cy++) {
+        if (!covered[cy]) {
+            TraceLog(LOG_ERROR, "MERGE: no shard made chunk row %d", cy);
+            ok = false;
+        }
+    }
+    free(covered);
+    if (!ok) return -1;
+
+    //in game map, each shard filled its own rows and left the rest transparent
+    Image map = GenImageColor(128, 128, BLANK);
+    for (int i = 0; i < shardCount; i++) {
+        char path[256];
+        snprintf(path, sizeof(path), GEN_DIR "/shard_%d/ingame.png", i);
+        Image part = LoadImage(path);
+        if (part.data == NULL) continue;
+        ImageFormat(&part, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+        ImageDraw(&map, part, (Rectangle){ 0, 0, 128, 128 }, (Rectangle){ 0, 0, 128, 128 }, WHITE);
+        UnloadImage(part);
+        remove(path);
+    }
+    TimedExportImage(map, "map/elevation_color_map.png");
+    UnloadImage(map);
+
+    //tiled worlds are terrain only, no tile batches or water, so nothing is left to merge, just drop what an older export left behind
+    remove("map/manifest.txt");
+    remove("map/water_manifest.txt");
+    remove("map/water_bodies.txt");
+    TraceLog(LOG_INFO, "MERGE: %d shards, %dx%d chunks, seed %d", shardCount, CHUNK_COUNT, CHUNK_COUNT, seed);
+    return 0;
+}
+
+// create --bench: the whole pipeline once, no keys, fixed seed, into benchDir/map so the real map is left alone
+// same recipe every time (heightmap, hydraulic erosion, erosion, roads, chunks, export) so runs can be compared
+int RunGenerationBench(float *heightData, Image *image, Image *colorImage, Image *slopeImage,
+                       float scale, float frequency, int octaves, int seed, float lacunarity,
+                       const char *outPath, const char *benchDir)
+{
+    char origDir[1024];
+    if (!getcwd(origDir, sizeof(origDir))) {
+        TraceLog(LOG_ERROR, "BENCH: getcwd failed");
+        return -1;
+    }
+    EnsureDirectoryExists(benchDir);
+    if (chdir(benchDir) != 0) {
+        TraceLog(LOG_ERROR, "BENCH: cant enter %s", benchDir);
+        return -1;
+    }
+    EnsureDirectoryExists("map/");
+    remove("map/manifest.txt");
+    srand(seed);
+    SetRandomSeed(seed);
+    StageReset();
+    double t0 = StageClockMs(CLOCK_MONOTONIC);
+
+    StageTimer stage = StageBegin("GenerateHeightmap");
+    GenerateHeightmap(heightData, MAP_SIZE, MAP_SIZE, scale, frequency, octaves, seed, lacunarity);
+    StageEnd(stage, MAP_SIZE * MAP_SIZE, 0, 0);
+    stage = StageBegin("ApplyErosionHydraulic");
+    ApplyErosionHydraulic(heightData, MAP_SIZE, MAP_SIZE);
+    StageEnd(stage, MAP_SIZE * MAP_SIZE, 0, 0);
+    stage = StageBegin("ApplyErosion");
+    ApplyErosion(heightData, MAP_SIZE, MAP_SIZE, 5, 0.01f);
+    StageEnd(stage, 5 * MAP_SIZE * MAP_SIZE, 0, 0);
+    stage = StageBegin("rebuild height/color/slope");
+    RebuildImageFromHeightData(image, heightData, MAP_SIZE, MAP_SIZE);
+    RebuildColorImageFromHeightData(colorImage, heightData, MAP_SIZE, MAP_SIZE);
+    RebuildSlopeImageFromHeightData(slopeImage, heightData, MAP_SIZE, MAP_SIZE);
+    StageEnd(stage, 3 * MAP_SIZE * MAP_SIZE, 0, 0);
+
+    GenerateRoads(heightData, image, *colorImage);
+    GenerateChunkModels(heightData, *image, *colorImage);
+    ExportMap(heightData, *image, *colorImage, *slopeImage, false);
+    double totalMs = StageClockMs(CLOCK_MONOTONIC) - t0;
+
+    if (chdir(origDir) != 0) {TraceLog(LOG_WARNING, "BENCH: cant go back to %s", origDir);}
+    StagePrintSummary();
+    TraceLog(LOG_INFO, "BENCH: total %.1f s", totalMs / 1000.0);
+    return StageWriteJSON(outPath, seed, MAP_SIZE, totalMs) ? 0 : -1;
+}
+
 //--MAIN--
-int main(void)
+int main(int argc, char **argv)
 {
+    //create --bench [--seed N] [--bench-out create_bench.json] [--bench-dir bench_map] [--trace [create_trace.json]]
+    //       [--chunks N] [--tile-grid N] (world size, written to map/world.txt for the other tools)
+    //create --tiled [--seed N] [--chunks N] [--shard i/N]: out of core terrain for big worlds, nothing full size in ram
+    //create --merge N: after N shards are done (see shard.sh)
+    bool bench = false;
+    bool tiled = false;
+    int shard = 0;
+    int shardCount = 1;
+    int mergeCount = 0;
+    int benchSeed = 0;
+    const char *benchOut = "create_bench.json";
+    const char *benchDir = "bench_map";
+    const char *traceOut = NULL;
+    TraceThreadName("main");
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--bench") == 0) {bench = true;}
+        else if (strcmp(argv[i], "--tiled") == 0) {tiled = true;}
+        else if (strcmp(argv[i], "--shard") == 0 && i + 1 < argc) {
+            if (sscanf(argv[++i], "%d/%d", &shard, &shardCount) != 2) {TraceLog(LOG_WARNING, "--shard wants i/N, got %s", argv[i]);}
+        }
+        else if (strcmp(argv[i], "--merge") == 0 && i + 1 < argc) {mergeCount = atoi(argv[++i]);}
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {benchSeed = atoi(argv[++i]);}
+        else if (strcmp(argv[i], "--bench-out") == 0 && i + 1 < argc) {benchOut = argv[++i];}
+        else if (strcmp(argv[i], "--bench-dir") == 0 && i + 1 < argc) {benchDir = argv[++i];}
+        else if (strcmp(argv[i], "--trace") == 0) {traceOut = (i + 1 < argc && argv[i + 1][0] != '-') ? argv[++i] : "create_trace.json";}
+        else if (strcmp(argv[i], "--chunks") == 0 && i + 1 < argc) {world.chunkCount = atoi(argv[++i]);}
+        else if (strcmp(argv[i], "--tile-grid") == 0 && i + 1 < argc) {world.tileGrid = atoi(argv[++i]);}
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {parallelThreads = atoi(argv[++i]);}
+        else if (strcmp(argv[i], "--height-bits") == 0 && i + 1 < argc) {int bits = atoi(argv[++i]); meshHeightBits = MIN(MAX(bits, 0), 24);} //24 bits is all a float holds exactly
+        else {TraceLog(LOG_WARNING, "unknown argument %s", argv[i]);}
+    }
+    if (!WorldValidate(&world)) {return 1;}
+    chunkModels = (ChunkModelRow *)calloc(CHUNK_COUNT, sizeof(ChunkModelRow));
+    chunkModels32 = (ChunkModelRow *)calloc(CHUNK_COUNT, sizeof(ChunkModelRow));
+    chunkModels16 = (ChunkModelRow *)calloc(CHUNK_COUNT, sizeof(ChunkModelRow));
+    chunkModels8 = (ChunkModelRow *)calloc(CHUNK_COUNT, sizeof(ChunkModelRow));
+    if (traceOut) {TraceStart();} //every StageBegin/StageEnd becomes a span
+
+    float scale = 4.0f;
+    float frequency = 2.0f;
+    float lacunarity = 1.0f;
+    int octaves = 7;
+    int seed = 0;
+
+    if (mergeCount > 0) {return RunShardMerge(mergeCount) == 0 ? 0 : 1;}
+    if (tiled)
+    {
+        SetConfigFlags(FLAG_WINDOW_HIDDEN); //gl context for the chunk models, nothing to look at
+        InitWindow(320, 200, "tiled generation");
+        int result = RunTiledGeneration(scale, frequency, octaves, benchSeed, lacunarity, shard, shardCount);
+        if (traceOut) {TraceWrite(traceOut);}
+        CloseWindow();
+        return result;
+    }
+
     // main character right here
     float *heightData = (float *)MemAlloc(MAP_SIZE * MAP_SIZE * sizeof(float));
 
+    if (bench) {SetConfigFlags(FLAG_WINDOW_HIDDEN);} //still need the gl context for the chunk models
     InitWindow(1200, 800, "Perlin Heightmap to Mesh Viewer");
     SetTargetFPS(60);
 
@@ -1877,12 +3504,6 @@ int main(void)
     // return -1;
     //-------------------------------------------------------------------------------
 
-    float scale = 4.0f;
-    float frequency = 2.0f;
-    float lacunarity = 1.0f;
-    int octaves = 7;
-    int seed = 0;
-
     Image image = {
         .data = MemAlloc(MAP_SIZE * MAP_SIZE * sizeof(Color)),
         .width = MAP_SIZE,
@@ -1913,12 +3534,19 @@ int main(void)
     RebuildSlopeImageFromHeightData(&slopeImage, heightData, MAP_SIZE, MAP_SIZE);
     texture = LoadTextureFromImage(image);
     colorTexture = LoadTextureFromImage(colorImage);
-    Color *colorData;
+    if (bench)
+    {
+        int result = RunGenerationBench(heightData, &image, &colorImage, &slopeImage,
+                                        scale, frequency, octaves, benchSeed, lacunarity, benchOut, benchDir);
+        if (traceOut) {TraceWrite(traceOut);}
+        CloseWindow();
+        return result;
+    }
 
     bool isViewing3D = false;
     Camera3D camera = {
-        .position = (Vector3){ 512, 80, 512 },
-        .target = (Vector3){ 512 + 1, 80, 512 },
+        .position = (Vector3){ MAP_SIZE * 0.5f, 80, MAP_SIZE * 0.5f }, //middle of the map, chunks are drawn at cx * CHUNK_SIZE
+        .target = (Vector3){ MAP_SIZE * 0.5f + 1, 80, MAP_SIZE * 0.5f },
         .up = (Vector3){ 0.0f, 1.0f, 0.0f },
         .fovy = 45.0f,
         .projection = CAMERA_PERSPECTIVE
@@ -2000,125 +3628,8 @@ int main(void)
 
 
             if (IsKeyPressed(KEY_ENTER)) {
-                TraceLog(LOG_INFO, "Road Stuff ...");
-                TraceLog(LOG_INFO, "Feature Points for Roads ...");
-                // Generate feature points ... for roods!
-                int found = 0;
-                int stride = 16; // space between sample attempts
-
-                for (int y = stride; y < MAP_SIZE - stride; y += stride) {
-                    for (int x = stride; x < MAP_SIZE - stride; x += stride) {
-                        int idx = y * CHUNK_SIZE + x;
-                        float h = heightData[idx];
-
-                        // Local slope check (less than 15 degrees-ish)
-                        float hL = heightData[y * CHUNK_SIZE + (x - 1)];
-                        float hR = heightData[y * CHUNK_SIZE + (x + 1)];
-                        float hU = heightData[(y + 1) * CHUNK_SIZE + x];
-                        float hD = heightData[(y - 1) * CHUNK_SIZE + x];
-
-                        float dhdx = (hR - hL) * HEIGHT_SCALE / 2.0f;
-                        float dhdy = (hU - hD) * HEIGHT_SCALE / 2.0f;
-                        float slope = sqrtf(dhdx * dhdx + dhdy * dhdy);
-
-                        if (slope > 0.6f) continue; // skip steep regions
-
-                        // Check 3x3 neighborhood for local max
-                        bool isMax = true;
-                        for (int oy = -1; oy <= 1 && isMax; oy++) {
-                            for (int ox = -1; ox <= 1 && isMax; ox++) {
-                                if (ox == 0 && oy == 0) continue;
-                                int ni = (y + oy) * MAP_SIZE + (x + ox);
-                                if (heightData[ni] >= h) isMax = false;
-                            }
-                        }
-
-                        if (isMax && found < NUM_FEATURE_POINTS) {
-                            featurePoints[found++] = (Vector2){ x, y };
-                        }
-                    }
-                }
-
-                TraceLog(LOG_INFO, "found (%d), starting random sampling for features if needed ...?", found);
-                if (found < NUM_FEATURE_POINTS / 2) {
-                    TraceLog(LOG_WARNING, "Only found %d good points, adding random extras", found);
-                    while (found < NUM_FEATURE_POINTS) {
-                        featurePoints[found++] = (Vector2){
-                            GetRandomValue(0, MAP_SIZE - 1),
-                            GetRandomValue(0, MAP_SIZE - 1)
-                        };
-                    }
-                }
-
-                // Create road map image
-                roadImage = GenImageColor(ROAD_MAP_SIZE, ROAD_MAP_SIZE, DARKGREEN); // base
-                hardRoadMap = GenImageColor(ROAD_MAP_SIZE, ROAD_MAP_SIZE, BLACK); // hard lines, atleast its supposed to be
-                
-                Color *height_Data = LoadImageColors(image);
-                Color *color_data = LoadImageColors(colorImage);//yep, I screwed up the names, and its getting confusing
-                GenerateWorleyRoadMap(&roadImage, &hardRoadMap, color_data, height_Data);
-                TraceLog(LOG_INFO, "Road map gen - smoothing artifacts ... ");
-                ExpandRoadPaths(&hardRoadMap, 1);
-                FilterSmallRoadBlobs(&hardRoadMap, 10);  // kill all blobs smaller than 10 pixels
-                TraceLog(LOG_INFO, "Road map gen - flattening ... ");
-                for (int y = 0; y < MAP_SIZE; y++) {
-                    for (int x = 0; x < MAP_SIZE; x++) {
-                        int rx = x * ROAD_MAP_SIZE / MAP_SIZE;
-                        int ry = y * ROAD_MAP_SIZE / MAP_SIZE;
-
-                        if (rx < 0 || ry < 0 || rx >= ROAD_MAP_SIZE || ry >= ROAD_MAP_SIZE) continue;
-
-                        Color road = GetImageColor(hardRoadMap, rx, ry);
-                        if (road.r > 200) {
-                            float avg = 0.0f;
-                            int count = 0;
-
-                            // Sample local neighborhood to get target flatten height
-                            for (int oy = -FLATTEN_RADIUS; oy <= FLATTEN_RADIUS; oy++) {
-                                for (int ox = -FLATTEN_RADIUS; ox <= FLATTEN_RADIUS; ox++) {
-                                    int nx = x + ox;
-                                    int ny = y + oy;
-                                    if (nx >= 0 && nx < MAP_SIZE && ny >= 0 && ny < MAP_SIZE) {
-                                        avg += heightData[ny * MAP_SIZE + nx];
-                                        count++;
-                                    }
-                                }
-                            }
-
-                            if (count > 0) avg /= count;
-                            float flattenHeight = avg - FLATTEN_STRENGTH;
-
-                            // Lower all neighbors in the area if they’re higher than the flattenHeight
-                            for (int oy = -FLATTEN_RADIUS; oy <= FLATTEN_RADIUS; oy++) {
-                                for (int ox = -FLATTEN_RADIUS; ox <= FLATTEN_RADIUS; ox++) {
-                                    int nx = x + ox;
-                                    int ny = y + oy;
-                                    if (nx >= 0 && nx < MAP_SIZE && ny >= 0 && ny < MAP_SIZE) {
-                                        float *h = &heightData[ny * MAP_SIZE + nx];
-                                        if (*h > flattenHeight) {
-                                            *h = Lerp(*h, flattenHeight, FLATTEN_LERP_FACT);
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-                RebuildImageFromHeightData(&image, heightData, MAP_SIZE, MAP_SIZE);
-                colorData = LoadImageColors(image);  // Allocates and returns a Color[], worst named thing ever
-                TraceLog(LOG_INFO, "Chunk Stuff ...");
-                //models
-                for (int cy = 0; cy < CHUNK_COUNT; cy++) {
-                    for (int cx = 0; cx < CHUNK_COUNT; cx++) {
-                        chunkModels[cx][cy] = GenerateChunkModel(
-                            heightData, colorImage, colorData,
-                            MAP_SIZE,         // full map size
-                            cx, cy,           // chunk coordinates
-                            CHUNK_SIZE,       // chunk size
-                            HEIGHT_SCALE      // vertical exaggeration
-                        );
-                    }
-                }
+                GenerateRoads(heightData, &image, colorImage);
+                GenerateChunkModels(heightData, image, colorImage);
                 UpdateTexture(colorTexture, colorImage.data);
                 isViewing3D = true;
                 DisableCursor();
@@ -2138,248 +3649,10 @@ int main(void)
             if (IsKeyPressed(KEY_P))
             {
                 EnableCursor();
-                //for now, I dont want to clamp, to see if the seams and artifacts are better or worse or the same
-                //what I think is happening is screwing with the vertices causes problems with normals, and then distant rendering is a problem
-                //as Im writing this, Im not sure tho as I cant test yest (map gen takes a while and I have other things first)
-                //TraceLog(LOG_INFO, "Clamping LOD edges ...");
-                // ClampMeshEdges(chunkModels32, 33);//todo, should i remove these clamp functions, or change, them, I still see some very small seams?
-                // ClampMeshEdges(chunkModels16, 17);
-                // ClampMeshEdges(chunkModels8, 9);
-                
-                TraceLog(LOG_INFO, "road stuff again ... (and in game map image)");
-                Color *colorData = LoadImageColors(colorImage);
-                Image inGameMap = ImageCopy(colorImage);
-                ImageResize(&inGameMap,128,128);
-                remove("map/manifest.txt");
-                remove("map/water_manifest.txt");
-                ExportImage(roadImage, "map/road_map.png");
-                ExportImage(hardRoadMap, "map/hard_road_map.png");
-                ExportImage(inGameMap, "map/elevation_color_map.png");
-                ExportImage(image, "map/map_height.png");
-                ExportImage(slopeImage, "map/map_slope.png");
-
-                TraceLog(LOG_INFO, "Exporting all chunks...");
-                for (int cy = 0; cy < CHUNK_COUNT; cy++) {
-                    for (int cx = 0; cx < CHUNK_COUNT; cx++) {
-                        //check directory first
-                        TraceLog(LOG_INFO, "Checking Directory (%d,%d)...", cx, cy);
-                        char fnameDir[64];
-                        snprintf(fnameDir, sizeof(fnameDir), "map/chunk_%02d_%02d", cx, cy);
-                        EnsureDirectoryExists(fnameDir);
-
-                        TraceLog(LOG_INFO, "Exporting chunk (%d,%d)...", cx, cy);
-                        int chunkSize = CHUNK_SIZE + 1; //to get 64 quads?
-
-                        Image heightImage = GenImageColor(chunkSize, chunkSize, BLACK);
-                        Image colorImage2 = GenImageColor(chunkSize, chunkSize, BLACK);
-                        Image slopeImage2 = GenImageColor(chunkSize, chunkSize, BLACK);
-
-                        Color *heightPixels = (Color *)heightImage.data;
-                        Color *colorPixels = (Color *)colorImage2.data;
-                        Color *colorData = (Color *)colorImage.data;
-                        Color *slopeData = (Color *)slopeImage.data;
-                        Color *slopePixels = (Color *)slopeImage2.data;
-
-                        for (int y = 0; y < chunkSize; y++) {
-                            for (int x = 0; x < chunkSize; x++) {
-                                int globalX = cx * CHUNK_SIZE + x;
-                                int globalY = cy * CHUNK_SIZE + y;
-                                int srcIndex = globalY * MAP_SIZE + globalX;
-                                int dstIndex = y * chunkSize + x;
-
-                                // Height to grayscale
-                                float h = heightData[srcIndex];
-                                unsigned char gray = (unsigned char)((h + 1.0f) * 127.5f); // Normalize -1..1 to 0..255
-                                heightPixels[dstIndex] = (Color){gray, gray, gray, 255};
-
-                                // Color already provided
-                                colorPixels[dstIndex] = colorData[srcIndex];
-                                slopePixels[dstIndex] = slopeData[srcIndex];
-                            }
-                        }
-                        // Perlin vegetation noise (scale if needed)
-                        TraceLog(LOG_INFO, "vegetation (%d,%d)...", cx, cy);
-                        SaveChunkVegetationImage(cx, cy, heightData, colorData, MAP_SIZE, HEIGHT_SCALE);
-                        TraceLog(LOG_INFO, "water (%d,%d)...", cx, cy);
-                        CreateWaterPlanes(cx, cy, heightData, MAP_SIZE, 0);
-                        char fnameHeight[64];
-                        char fnameColor[64];
-                        char fnameSlope[64];
-                        char fnameSlopeBig[64];
-                        char fnameHeight64[64];
-
-                        snprintf(fnameHeight, sizeof(fnameHeight), "map/chunk_%02d_%02d/height.png", cx, cy);
-                        snprintf(fnameColor, sizeof(fnameColor), "map/chunk_%02d_%02d/color.png", cx, cy);
-                        snprintf(fnameSlope, sizeof(fnameSlope), "map/chunk_%02d_%02d/slope.png", cx, cy);
-                        snprintf(fnameSlopeBig, sizeof(fnameSlopeBig), "map/chunk_%02d_%02d/slope_big.png", cx, cy);
-                        snprintf(fnameHeight64, sizeof(fnameHeight64), "map/chunk_%02d_%02d/height64.png", cx, cy);
-
-                        // Rebuild mesh for this chunk using height and color image
-                        Texture2D textureColors = LoadTextureFromImage(colorImage);
-                        Model model = LoadModelFromMesh(chunkModels[cx][cy].meshes[0]);
-                        model.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = textureColors;
-
-                        ImageResize(&colorImage2, 64, 64); // Resize to power-of-two dimensions
-                        ImageResize(&slopeImage2, 64, 64); // Resize to power-of-two dimensions
-                        Image img = {
-                            .data = colorImage2.data,
-                            .width = 64,
-                            .height = 64,
-                            .mipmaps = 1,
-                            .format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8
-                        };
-                        Image img2 = {
-                            .data = slopeImage2.data,
-                            .width = 64,
-                            .height = 64,
-                            .mipmaps = 1,
-                            .format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8
-                        };
-                        Image img3 = ImageCopy(heightImage);
-                        ImageResize(&img3,64,64);
-                        ExportImage(img3, fnameHeight64);
-                        //roads handle - this sets the colors for the textures
-                        for(int y=0; y<img.height; y++)
-                        {
-                            for(int x=0; x<img.width; x++)
-                            {
-                                int globalX = cx * CHUNK_SIZE + x;
-                                int globalY = cy * CHUNK_SIZE + y;
-                                Color tp = GetImageColor(hardRoadMap, globalX, globalY);
-                                //Color roadPixel = GetImageColor(roadImage, globalX, globalY);
-                                Color imgPixel = GetImageColor(img, x, y);
-                                Color img2Pixel = GetImageColor(img2, x, y);
-                                if (tp.r > 200) {
-                                    //average terrain color with road
-                                    Color roadColor = (Color){ 100, 80, 50, 255 }; // visible dirt road brown
-                                    Color c1 = AverageColor(roadColor, imgPixel);
-                                    Color c2 = AverageColor(roadColor, img2Pixel);
-                                    ImageDrawPixel(&img, x, y, c1);
-                                    ImageDrawPixel(&img2, x, y, c2);
-                                }
-                            }
-                        }
-                        //models gen
-                        char fnameObj[64];
-                        char fnameObj32[64];
-                        char fnameObj16[64];
-                        char fnameObj8[64];
-                        snprintf(fnameObj, sizeof(fnameObj), "map/chunk_%02d_%02d/64.obj", cx, cy);
-                        snprintf(fnameObj32, sizeof(fnameObj32), "map/chunk_%02d_%02d/32.obj", cx, cy);
-                        snprintf(fnameObj16, sizeof(fnameObj16), "map/chunk_%02d_%02d/16.obj", cx, cy);
-                        snprintf(fnameObj8, sizeof(fnameObj8), "map/chunk_%02d_%02d/8.obj", cx, cy);
-                        ExportMesh(chunkModels[cx][cy].meshes[0], fnameObj);
-                        ExportMesh(chunkModels32[cx][cy].meshes[0], fnameObj32);
-                        ExportMesh(chunkModels16[cx][cy].meshes[0], fnameObj16);
-                        ExportMesh(chunkModels8[cx][cy].meshes[0], fnameObj8);
-
-                        UnloadModel(model); // also unloads mesh internally
-                        UnloadTexture(textureColors);
-                        ExportImage(heightImage, fnameHeight);
-                        //ExportImage(img, fnameColor);
-                        //ExportImage(img2, fnameSlope);
-                        //big colors
-                        Image upscaled = GenImageColor(UPSCALED_TEXTURE_SIZE, UPSCALED_TEXTURE_SIZE, BLACK);
-                        for (int y = 0; y < UPSCALED_TEXTURE_SIZE; y++) {
-                            for (int x = 0; x < UPSCALED_TEXTURE_SIZE; x++) {
-                                // Get source pixel (mapped to 64x64)
-                                int srcX = (x * (img.width)) / (UPSCALED_TEXTURE_SIZE );
-                                int srcY = (y * (img.height)) / (UPSCALED_TEXTURE_SIZE );
-
-
-                                Color base = GetImageColor(img, srcX, srcY);
-
-                                // Optional: jitter brightness slightly to reduce banding
-                                int brightnessOffset = rand() % 10 - 5;  // Range -5 to +4
-                                base.r = (unsigned char)Clamp(base.r + brightnessOffset, 0, 255);
-                                base.g = (unsigned char)Clamp(base.g + brightnessOffset, 0, 255);
-                                base.b = (unsigned char)Clamp(base.b + brightnessOffset, 0, 255);
-
-                                ImageDrawPixel(&upscaled, x, y, base);
-                            }
-                        }
-
-                        
-                        char outName[256];
-                        snprintf(outName, sizeof(outName), "map/chunk_%02d_%02d/color_big.png", cx, cy);
-                        //ExportImage(upscaled, outName);
-                        //big slope
-                        Image upscaled2 = GenImageColor(UPSCALED_TEXTURE_SIZE, UPSCALED_TEXTURE_SIZE, BLACK);
-                        for (int y = 0; y < UPSCALED_TEXTURE_SIZE; y++) {
-                            for (int x = 0; x < UPSCALED_TEXTURE_SIZE; x++) {
-                                // Get source pixel (mapped to 64x64)
-                                int srcX = (x * (img2.width)) / (UPSCALED_TEXTURE_SIZE );
-                                int srcY = (y * (img2.height)) / (UPSCALED_TEXTURE_SIZE );
-
-                                Color base = GetImageColor(img2, srcX, srcY);
-
-                                // Optional: jitter brightness slightly to reduce banding
-                                int brightnessOffset = rand() % 10 - 5;  // Range -5 to +4
-                                base.r = (unsigned char)Clamp(base.r + brightnessOffset, 0, 255);
-                                base.g = (unsigned char)Clamp(base.g + brightnessOffset, 0, 255);
-                                base.b = (unsigned char)Clamp(base.b + brightnessOffset, 0, 255);
-
-                                ImageDrawPixel(&upscaled2, x, y, base);
-                            }
-                        }
-                        //
-                        Image upscaled3 = GenImageColor(UPSCALED_TEXTURE_SIZE, UPSCALED_TEXTURE_SIZE, BLACK);
-                        for (int y = 0; y < UPSCALED_TEXTURE_SIZE; y++) {
-                            for (int x = 0; x < UPSCALED_TEXTURE_SIZE; x++) {
-                                // Get source pixel (mapped to 64x64)
-                                int srcX = (x * (img3.width)) / (UPSCALED_TEXTURE_SIZE );
-                                int srcY = (y * (img3.height)) / (UPSCALED_TEXTURE_SIZE );
-
-                                Color base = GetImageColor(img3, srcX, srcY);
-
-                                // Optional: jitter brightness slightly to reduce banding
-                                int brightnessOffset = rand() % 10 - 5;  // Range -5 to +4
-                                base.r = (unsigned char)Clamp(base.r + brightnessOffset, 0, 255);
-                                base.g = (unsigned char)Clamp(base.g + brightnessOffset, 0, 255);
-                                base.b = (unsigned char)Clamp(base.b + brightnessOffset, 0, 255);
-
-                                ImageDrawPixel(&upscaled3, x, y, base);
-                            }
-                        }
-                        //ExportImage(upscaled2, fnameSlopeBig);
-
-                        Image average = AverageImages(img3,AverageImages(img,img2));
-                        Image averageBig = AverageImages(upscaled3,AverageImages(upscaled,upscaled2));//here we are still 1024
-                        // ImageResize(&upscaled2, 128, 128); //todo: remove these if not needed
-                        // ImageResize(&upscaled, 128, 128);
-
-                        char avgName[256];
-                        char avgBigName[256];
-                        char avgFullName[256];
-                        char avgDamnName[256];
-                        snprintf(avgName, sizeof(avgName), "map/chunk_%02d_%02d/avg.png", cx, cy);
-                        snprintf(avgBigName, sizeof(avgBigName), "map/chunk_%02d_%02d/avg_big.png", cx, cy);
-                        snprintf(avgFullName, sizeof(avgFullName), "map/chunk_%02d_%02d/avg_full.png", cx, cy);
-                        snprintf(avgDamnName, sizeof(avgDamnName), "map/chunk_%02d_%02d/avg_damn.png", cx, cy);
-                        ExportImage(average, avgName);//far away we can cheat and just use the 64 which is small and very pixely
-                        //damn!
-                        TraceLog(LOG_INFO, "song2");
-                        Image damn = UpscaleImageBilinear(averageBig, 2057, 2057);//damn! (actually the full size now but didnt want to swtich all the variable names)
-                        ImageResize(&damn, 1024, 1024);
-                        
-                        ExportImage(damn, avgDamnName); //damn!
-                        ImageResize(&damn, 512, 512);//now we are 512 for full
-
-                        ExportImage(damn, avgFullName);
-                        ImageResize(&damn, 256, 256);//256 for big
-                        ExportImage(damn, avgBigName);
-
-                        UnloadImage(damn); //beaver? DAMN!
-                        UnloadImage(average);
-                        UnloadImage(averageBig);
-                        UnloadImage(upscaled2);
-                        UnloadImage(upscaled);
-                        UnloadImage(heightImage);
-                        UnloadImage(colorImage2);
-                        UnloadImage(slopeImage2);
-                    }
-                }
+                ExportMap(heightData, image, colorImage, slopeImage, true);
                 TraceLog(LOG_INFO, "Done exporting.");
+                StagePrintSummary();
+                if (tracer.enabled) {TraceWrite(traceOut);}
                 CloseWindow(); // done
             }
 
@@ -2473,6 +3746,7 @@ int main(void)
     UnloadTexture(texture);
     UnloadImage(image);
     //MemFree(heightData);
+    if (tracer.enabled) {TraceWrite(traceOut);}
     CloseWindow();
 
     return 0;
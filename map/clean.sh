@@ -2,13 +2,14 @@
 
 echo "Cleaning chunk folders..."
 pwd
-ls -la chunk_*
-echo "WARNING: This will delete all chunk folders. Continue? (y/n)"
+ls -la chunk_* water
+echo "WARNING: This will delete all chunk folders (and water bodies). Continue? (y/n)"
 read -r confirm
 
 if [ "$confirm" = "y" ] || [ "$confirm" = "Y" ]; then
     echo "Deleting chunk folders..."
     rm -rfv chunk_*
+    rm -rfv water
     echo "Done."
 else
     echo "Aborted."
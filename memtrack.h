@@ -0,0 +1,251 @@
+#ifndef MEMTRACK_H
+#define MEMTRACK_H
+
+//real byte counters for ram and vram, per category, so streaming budgets can come from numbers instead of guesses
+//cpu: our own allocations go through MemTrackMalloc/MemTrackFree, raylib owned data (meshes, images) is registered by size
+//gpu: registered when we upload and when we unload, sizes are what raylib sends to gl (textures include the mip chain)
+#include "raylib.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+typedef enum {
+    MEM_TERRAIN = 0,  // chunk meshes, all 4 lods
+    MEM_TEXTURES,     // chunk images (cpu) and textures (gpu)
+    MEM_TILES,        // baked tile batches
+    MEM_WATER,
+    MEM_INSTANCING,   // high fi prop models + transform arrays
+    MEM_PARTICLES,    // fireflies and stars
+    MEM_PROPS,        // per chunk tree/rock positions
+    MEM_OTHER,
+    MEM_CATEGORY_COUNT
+} MemCategory;
+
+static const char *MemCategoryNames[MEM_CATEGORY_COUNT] = {
+    "terrain", "textures", "tiles", "water", "instancing", "particles", "props", "other"
+};
+
+typedef struct {
+    int64_t cpuBytes;
+    int64_t cpuPeak;
+    int cpuObjects;
+    int64_t gpuBytes;
+    int64_t gpuPeak;
+    int gpuObjects;
+} MemCounter;
+
+typedef struct {
+    MemCounter cat[MEM_CATEGORY_COUNT];
+    int64_t cpuTotal;
+    int64_t cpuPeak;
+    int64_t gpuTotal;
+    int64_t gpuPeak;
+    bool overlay;
+    pthread_mutex_t lock; // loader thread registers too
+} MemTracker;
+
+MemTracker memTracker = { .lock = PTHREAD_MUTEX_INITIALIZER };
+
+// objects < 0 means a release
+void MemTrackCpu(MemCategory cat, int64_t bytes, int objects)
+{
+    pthread_mutex_lock(&memTracker.lock);
+    MemCounter *c = &memTracker.cat[cat];
+    c->cpuBytes += bytes;
+    c->cpuObjects += objects;
+    if (c->cpuBytes > c->cpuPeak) c->cpuPeak = c->cpuBytes;
+    memTracker.cpuTotal += bytes;
+    if (memTracker.cpuTotal > memTracker.cpuPeak) memTracker.cpuPeak = memTracker.cpuTotal;
+    pthread_mutex_unlock(&memTracker.lock);
+}
+
+void MemTrackGpu(MemCategory cat, int64_t bytes, int objects)
+{
+    pthread_mutex_lock(&memTracker.lock);
+    MemCounter *c = &memTracker.cat[cat];
+    c->gpuBytes += bytes;
+    c->gpuObjects += objects;
+    if (c->gpuBytes > c->gpuPeak) c->gpuPeak = c->gpuBytes;
+    memTracker.gpuTotal += bytes;
+    if (memTracker.gpuTotal > memTracker.gpuPeak) memTracker.gpuPeak = memTracker.gpuTotal;
+    pthread_mutex_unlock(&memTracker.lock);
+}
+
+//------------------------------------------------------------------tracked allocations
+//size + category ride in front of the block so free does not need to be told
+typedef struct {
+    size_t size;
+    int cat;
+    int pad;
+} MemTrackHeader;
+
+void *MemTrackMalloc(MemCategory cat, size_t size)
+{
+    MemTrackHeader *h = (MemTrackHeader *)malloc(sizeof(MemTrackHeader) + size);
+    if (!h) return NULL;
+    h->size = size;
+    h->cat = cat;
+    MemTrackCpu(cat, (int64_t)size, 1);
+    return h + 1;
+}
+
+void *MemTrackCalloc(MemCategory cat, size_t count, size_t size)
+{
+    void *p = MemTrackMalloc(cat, count * size);
+    if (p) memset(p, 0, count * size);
+    return p;
+}
+
+void MemTrackFree(void *ptr)
+{
+    if (!ptr) return;
+    MemTrackHeader *h = (MemTrackHeader *)ptr - 1;
+    MemTrackCpu((MemCategory)h->cat, -(int64_t)h->size, -1);
+    free(h);
+}
+
+//------------------------------------------------------------------sizes
+size_t MeshCpuBytes(Mesh m)
+{
+    size_t bytes = 0;
+    if (m.vertices) bytes += (size_t)m.vertexCount * 3 * sizeof(float);
+    if (m.texcoords) bytes += (size_t)m.vertexCount * 2 * sizeof(float);
+    if (m.texcoords2) bytes += (size_t)m.vertexCount * 2 * sizeof(float);
+    if (m.normals) bytes += (size_t)m.vertexCount * 3 * sizeof(float);
+    if (m.tangents) bytes += (size_t)m.vertexCount * 4 * sizeof(float);
+    if (m.colors) bytes += (size_t)m.vertexCount * 4;
+    if (m.indices) bytes += (size_t)m.triangleCount * 3 * sizeof(unsigned short);
+    return bytes;
+}
+
+// same attributes go up as vbos, nothing if the mesh was never uploaded
+size_t MeshGpuBytes(Mesh m)
+{
+    if (m.vaoId == 0 && (m.vboId == NULL || m.vboId[0] == 0)) {return 0;}
+    return MeshCpuBytes(m);
+}
+
+size_t ModelCpuBytes(Model model)
+{
+    size_t bytes = 0;
+    for (int i = 0; i < model.meshCount; i++) bytes += MeshCpuBytes(model.meshes[i]);
+    return bytes;
+}
+
+size_t ModelGpuBytes(Model model)
+{
+    size_t bytes = 0;
+    for (int i = 0; i < model.meshCount; i++) bytes += MeshGpuBytes(model.meshes[i]);
+    return bytes;
+}
+
+// every mip level the image carries
+size_t ImageCpuBytes(Image img)
+{
+    if (img.data == NULL) {return 0;}
+    size_t bytes = 0;
+    int w = img.width, h = img.height;
+    for (int level = 0; level < (img.mipmaps > 0 ? img.mipmaps : 1); level++)
+    {
+        bytes += (size_t)GetPixelDataSize(w, h, img.format);
+        if (w > 1) w /= 2;
+        if (h > 1) h /= 2;
+    }
+    return bytes;
+}
+
+// every mip level, down to 1x1
+size_t TextureGpuBytes(Texture2D t)
+{
+    if (t.id == 0) {return 0;}
+    size_t bytes = 0;
+    int w = t.width, h = t.height;
+    for (int level = 0; level < (t.mipmaps > 0 ? t.mipmaps : 1); level++)
+    {
+        bytes += (size_t)GetPixelDataSize(w, h, t.format);
+        if (w > 1) w /= 2;
+        if (h > 1) h /= 2;
+    }
+    return bytes;
+}
+
+//------------------------------------------------------------------registry helpers, sign is +1 on load and -1 on unload
+void MemTrackModelCpu(MemCategory cat, Model model, int sign) { MemTrackCpu(cat, sign * (int64_t)ModelCpuBytes(model), sign); }
+void MemTrackMeshGpu(MemCategory cat, Mesh mesh, int sign) { MemTrackGpu(cat, sign * (int64_t)MeshGpuBytes(mesh), sign); }
+void MemTrackImage(MemCategory cat, Image img, int sign) { MemTrackCpu(cat, sign * (int64_t)ImageCpuBytes(img), sign); }
+void MemTrackTexture(MemCategory cat, Texture2D tex, int sign) { MemTrackGpu(cat, sign * (int64_t)TextureGpuBytes(tex), sign); }
+
+//------------------------------------------------------------------reporting
+static inline double MemMB(int64_t bytes) { return bytes / (1024.0 * 1024.0); }
+
+void MemTrackPrint(void)
+{
+    pthread_mutex_lock(&memTracker.lock);
+    printf("%-12s %10s %10s %7s %10s %10s %7s\n", "category", "ram MB", "peak MB", "objs", "vram MB", "peak MB", "objs");
+    for (int i = 0; i < MEM_CATEGORY_COUNT; i++)
+    {
+        MemCounter *c = &memTracker.cat[i];
+        printf("%-12s %10.2f %10.2f %7d %10.2f %10.2f %7d\n", MemCategoryNames[i],
+               MemMB(c->cpuBytes), MemMB(c->cpuPeak), c->cpuObjects, MemMB(c->gpuBytes), MemMB(c->gpuPeak), c->gpuObjects);
+    }
+    printf("%-12s %10.2f %10.2f %7s %10.2f %10.2f\n", "total",
+           MemMB(memTracker.cpuTotal), MemMB(memTracker.cpuPeak), "", MemMB(memTracker.gpuTotal), MemMB(memTracker.gpuPeak));
+    pthread_mutex_unlock(&memTracker.lock);
+}
+
+bool MemTrackDumpCSV(const char *path)
+{
+    FILE *f = fopen(path, "w");
+    if (!f)
+    {
+        TraceLog(LOG_WARNING, "MEMTRACK: could not open %s", path);
+        return false;
+    }
+    pthread_mutex_lock(&memTracker.lock);
+    fprintf(f, "category,ram_bytes,ram_peak_bytes,ram_objects,vram_bytes,vram_peak_bytes,vram_objects\n");
+    for (int i = 0; i < MEM_CATEGORY_COUNT; i++)
+    {
+        MemCounter *c = &memTracker.cat[i];
+        fprintf(f, "%s,%lld,%lld,%d,%lld,%lld,%d\n", MemCategoryNames[i],
+                (long long)c->cpuBytes, (long long)c->cpuPeak, c->cpuObjects,
+                (long long)c->gpuBytes, (long long)c->gpuPeak, c->gpuObjects);
+    }
+    fprintf(f, "total,%lld,%lld,,%lld,%lld,\n", (long long)memTracker.cpuTotal, (long long)memTracker.cpuPeak,
+            (long long)memTracker.gpuTotal, (long long)memTracker.gpuPeak);
+    pthread_mutex_unlock(&memTracker.lock);
+    fclose(f);
+    TraceLog(LOG_INFO, "MEMTRACK: wrote %s", path);
+    return true;
+}
+
+void MemTrackDumpCSVWithTimestamp(void)
+{
+    time_t now = time(NULL);
+    struct tm *t = localtime(&now);
+    char filename[128];
+    strftime(filename, sizeof(filename), "memory_%Y%m%d_%H%M%S.csv", t);
+    MemTrackDumpCSV(filename);
+}
+
+// live table, ram and vram per category
+void MemTrackDrawOverlay(int x, int y)
+{
+    int rowH = 12;
+    DrawRectangle(x, y, 320, (MEM_CATEGORY_COUNT + 2) * rowH + 8, (Color){ 0, 0, 0, 160 });
+    DrawText("            ram MB     vram MB", x + 4, y + 4, 10, RAYWHITE);
+    for (int i = 0; i < MEM_CATEGORY_COUNT; i++)
+    {
+        MemCounter *c = &memTracker.cat[i];
+        DrawText(TextFormat("%-10s %8.1f  %8.1f", MemCategoryNames[i], MemMB(c->cpuBytes), MemMB(c->gpuBytes)),
+                 x + 4, y + 4 + (i + 1) * rowH, 10, RAYWHITE);
+    }
+    DrawText(TextFormat("%-10s %8.1f  %8.1f   (peak %.1f / %.1f)", "total", MemMB(memTracker.cpuTotal), MemMB(memTracker.gpuTotal),
+                        MemMB(memTracker.cpuPeak), MemMB(memTracker.gpuPeak)),
+             x + 4, y + 4 + (MEM_CATEGORY_COUNT + 1) * rowH, 10, YELLOW);
+}
+
+#endif //MEMTRACK_H
@@ -0,0 +1,160 @@
+#ifndef MIPMAP_H
+#define MIPMAP_H
+
+//rgba8 mip chains built on the cpu with a 2x2 box, laid out the way raylib wants them (every level after the last in img.data)
+//so LoadTextureFromImage uploads the whole chain and nobody has to call GenTextureMipmaps on the gl thread
+//power of two images are done in one pass of 64x64 tiles (each tile goes all the way down while its still in cache),
+//the levels smaller than a tile, and odd sized images, are done a level at a time
+#include "raylib.h"
+#include "parallel.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define MIP_TILE 64
+
+// levels down to 1x1, same count raylib's ImageMipmaps gives
+int MipLevelCount(int width, int height)
+{
+    int levels = 1;
+    while (width > 1 || height > 1)
+    {
+        if (width > 1) width /= 2;
+        if (height > 1) height /= 2;
+        levels++;
+    }
+    return levels;
+}
+
+// byte offset of a level in the chain, and its size
+static size_t MipLevelOffset(int width, int height, int level, int *outW, int *outH)
+{
+    size_t offset = 0;
+    for (int l = 0; l < level; l++)
+    {
+        offset += (size_t)width * height * 4;
+        if (width > 1) width /= 2;
+        if (height > 1) height /= 2;
+    }
+    if (outW) *outW = width;
+    if (outH) *outH = height;
+    return offset;
+}
+
+size_t MipChainBytes(int width, int height)
+{
+    return MipLevelOffset(width, height, MipLevelCount(width, height), NULL, NULL);
+}
+
+// one level of a chain as its own image, shares the chains memory (do not unload it), for ExportImage and friends
+Image MipLevelView(Image chain, int level)
+{
+    int w, h;
+    size_t offset = MipLevelOffset(chain.width, chain.height, level, &w, &h);
+    return (Image){ (unsigned char *)chain.data + offset, w, h, 1, chain.format };
+}
+
+// a level and every level below it, that tail is a whole chain on its own (upload it as is), shares the chains memory too
+// an image without that level comes back as it is
+Image MipChainView(Image chain, int level)
+{
+    if (level <= 0 || level >= chain.mipmaps) return chain;
+    int w, h;
+    size_t offset = MipLevelOffset(chain.width, chain.height, level, &w, &h);
+    return (Image){ (unsigned char *)chain.data + offset, w, h, chain.mipmaps - level, chain.format };
+}
+
+// dst (dw x dh) from src (sw x sh), rows [y0, y1) and columns [x0, x1) of dst, odd edges reuse the last row/column
+static void MipDownsample(const Color *src, int sw, int sh, Color *dst, int dw, int x0, int x1, int y0, int y1)
+{
+    for (int y = y0; y < y1; y++)
+    {
+        int sy0 = 2 * y < sh ? 2 * y : sh - 1;
+        int sy1 = 2 * y + 1 < sh ? 2 * y + 1 : sh - 1;
+        const Color *r0 = &src[sy0 * sw];
+        const Color *r1 = &src[sy1 * sw];
+        for (int x = x0; x < x1; x++)
+        {
+            int sx0 = 2 * x < sw ? 2 * x : sw - 1;
+            int sx1 = 2 * x + 1 < sw ? 2 * x + 1 : sw - 1;
+            Color a = r0[sx0], b = r0[sx1], c = r1[sx0], d = r1[sx1];
+            dst[y * dw + x] = (Color){
+                (unsigned char)((a.r + b.r + c.r + d.r + 2) / 4),
+                (unsigned char)((a.g + b.g + c.g + d.g + 2) / 4),
+                (unsigned char)((a.b + b.b + c.b + d.b + 2) / 4),
+                (unsigned char)((a.a + b.a + c.a + d.a + 2) / 4)
+            };
+        }
+    }
+}
+
+typedef struct {
+    unsigned char *chain;
+    int width, height;
+    int tileLevels;   // levels below 0 a tile covers (64 -> 1 is 6)
+} MipTileJob;
+
+// one row of tiles, every tile walks down from level 1 to its own 1x1
+static void MipTileRows(int ty0, int ty1, void *ctx)
+{
+    MipTileJob *job = (MipTileJob *)ctx;
+    int tilesX = job->width / MIP_TILE;
+    for (int ty = ty0; ty < ty1; ty++)
+    {
+        for (int tx = 0; tx < tilesX; tx++)
+        {
+            for (int l = 1; l <= job->tileLevels; l++)
+            {
+                int sw, sh, dw, dh;
+                const Color *src = (const Color *)(job->chain + MipLevelOffset(job->width, job->height, l - 1, &sw, &sh));
+                Color *dst = (Color *)(job->chain + MipLevelOffset(job->width, job->height, l, &dw, &dh));
+                int size = MIP_TILE >> l;
+                MipDownsample(src, sw, sh, dst, dw, tx * size, (tx + 1) * size, ty * size, (ty + 1) * size);
+            }
+        }
+    }
+}
+
+static bool MipIsPow2(int v) { return v > 0 && (v & (v - 1)) == 0; }
+
+// replace an rgba8 image with image + its full mip chain, false leaves it as it was
+bool ImageBuildMipChain(Image *img)
+{
+    if (img->data == NULL || img->format != PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 || img->mipmaps > 1)
+    {
+        TraceLog(LOG_WARNING, "MIPMAP: only plain rgba8 images get a chain (format %d, %d mips)", img->format, img->mipmaps);
+        return false;
+    }
+    int w = img->width, h = img->height;
+    int levels = MipLevelCount(w, h);
+    unsigned char *chain = (unsigned char *)RL_MALLOC(MipChainBytes(w, h)); //raylib frees it in UnloadImage
+    if (!chain)
+    {
+        TraceLog(LOG_ERROR, "MIPMAP: out of memory for a %dx%d chain", w, h);
+        return false;
+    }
+    memcpy(chain, img->data, (size_t)w * h * 4);
+
+    int done = 0; //last level built
+    if (MipIsPow2(w) && MipIsPow2(h) && w >= MIP_TILE && h >= MIP_TILE)
+    {
+        MipTileJob job = { chain, w, h, 0 };
+        while ((MIP_TILE >> (job.tileLevels + 1)) >= 1) job.tileLevels++;
+        ParallelFor(h / MIP_TILE, MipTileRows, &job);
+        done = job.tileLevels;
+    }
+    for (int l = done + 1; l < levels; l++)
+    {
+        int sw, sh, dw, dh;
+        const Color *src = (const Color *)(chain + MipLevelOffset(w, h, l - 1, &sw, &sh));
+        Color *dst = (Color *)(chain + MipLevelOffset(w, h, l, &dw, &dh));
+        MipDownsample(src, sw, sh, dst, dw, 0, dw, 0, dh);
+    }
+
+    RL_FREE(img->data);
+    img->data = chain;
+    img->mipmaps = levels;
+    return true;
+}
+
+#endif //MIPMAP_H
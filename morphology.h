@@ -0,0 +1,337 @@
+#ifndef MORPHOLOGY_H
+#define MORPHOLOGY_H
+
+//1 bit masks (the road mask) packed 64 cells to a word, with the two cleanups the roads need:
+//square dilation (a row pass with word shifts, then a column pass OR-ing rows) and removing small 8-connected blobs
+//blobs are found on runs of set bits, not pixels, with a union-find per band of rows (in parallel) then stitched across bands
+#include "raylib.h"
+#include "parallel.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    int width, height;
+    int words;        // uint64 per row
+    uint64_t *bits;   // bit x%64 of word x/64, bits past width stay 0
+} BitMask;
+
+bool BitMaskInit(BitMask *m, int width, int height)
+{
+    m->width = width;
+    m->height = height;
+    m->words = (width + 63) / 64;
+    m->bits = (uint64_t *)calloc((size_t)m->words * height, sizeof(uint64_t));
+    if (!m->bits)
+    {
+        TraceLog(LOG_ERROR, "MORPH: out of memory for a %dx%d mask", width, height);
+        return false;
+    }
+    return true;
+}
+
+void BitMaskFree(BitMask *m)
+{
+    free(m->bits);
+    m->bits = NULL;
+}
+
+static inline bool BitMaskGet(const BitMask *m, int x, int y)
+{
+    return (m->bits[(size_t)y * m->words + (x >> 6)] >> (x & 63)) & 1;
+}
+
+static inline void BitMaskSet(BitMask *m, int x, int y)
+{
+    m->bits[(size_t)y * m->words + (x >> 6)] |= 1ULL << (x & 63);
+}
+
+static inline uint64_t BitMaskTail(const BitMask *m)
+{
+    int used = m->width & 63;
+    return used ? (1ULL << used) - 1 : ~0ULL;
+}
+
+// set where the rgba8 image's red is over threshold (the hard road map is black/white)
+bool BitMaskFromImage(BitMask *m, Image img, int threshold)
+{
+    if (img.format != PIXELFORMAT_UNCOMPRESSED_R8G8B8A8)
+    {
+        TraceLog(LOG_ERROR, "MORPH: mask images have to be rgba8");
+        return false;
+    }
+    if (!BitMaskInit(m, img.width, img.height)) return false;
+    const Color *pixels = (const Color *)img.data;
+    for (int y = 0; y < m->height; y++)
+    {
+        for (int x = 0; x < m->width; x++)
+        {
+            if (pixels[y * img.width + x].r > threshold) BitMaskSet(m, x, y);
+        }
+    }
+    return true;
+}
+
+// every cell of the image becomes on or off
+void BitMaskToImage(const BitMask *m, Image *img, Color on, Color off)
+{
+    Color *pixels = (Color *)img->data;
+    for (int y = 0; y < m->height; y++)
+    {
+        for (int x = 0; x < m->width; x++) pixels[y * img->width + x] = BitMaskGet(m, x, y) ? on : off;
+    }
+}
+
+//------------------------------------------------------------------dilation
+// row shifted by s cells toward +x (s < 0 toward -x), cells pushed past either end fall off
+static void BitRowShift(const uint64_t *in, uint64_t *out, int words, int s)
+{
+    int ws = (s < 0 ? -s : s) >> 6;
+    int bs = (s < 0 ? -s : s) & 63;
+    for (int w = 0; w < words; w++)
+    {
+        uint64_t v = 0;
+        if (s >= 0)
+        {
+            int a = w - ws;
+            if (a >= 0) v = in[a] << bs;
+            if (bs && a - 1 >= 0) v |= in[a - 1] >> (64 - bs);
+        }
+        else
+        {
+            int a = w + ws;
+            if (a < words) v = in[a] >> bs;
+            if (bs && a + 1 < words) v |= in[a + 1] << (64 - bs);
+        }
+        out[w] = v;
+    }
+}
+
+typedef struct {
+    BitMask *m;
+    uint64_t *tmp;
+    int radius;
+} DilateJob;
+
+static void DilateRows(int y0, int y1, void *ctx)
+{
+    DilateJob *job = (DilateJob *)ctx;
+    BitMask *m = job->m;
+    uint64_t *shifted = (uint64_t *)malloc(sizeof(uint64_t) * m->words);
+    uint64_t tail = BitMaskTail(m);
+    for (int y = y0; y < y1; y++)
+    {
+        const uint64_t *in = &m->bits[(size_t)y * m->words];
+        uint64_t *out = &job->tmp[(size_t)y * m->words];
+        memcpy(out, in, sizeof(uint64_t) * m->words);
+        for (int s = 1; s <= job->radius; s++)
+        {
+            BitRowShift(in, shifted, m->words, s);
+            for (int w = 0; w < m->words; w++) out[w] |= shifted[w];
+            BitRowShift(in, shifted, m->words, -s);
+            for (int w = 0; w < m->words; w++) out[w] |= shifted[w];
+        }
+        out[m->words - 1] &= tail;
+    }
+    free(shifted);
+}
+
+static void DilateColumns(int y0, int y1, void *ctx)
+{
+    DilateJob *job = (DilateJob *)ctx;
+    BitMask *m = job->m;
+    for (int y = y0; y < y1; y++)
+    {
+        uint64_t *out = &m->bits[(size_t)y * m->words];
+        memset(out, 0, sizeof(uint64_t) * m->words);
+        int ya = y - job->radius < 0 ? 0 : y - job->radius;
+        int yb = y + job->radius >= m->height ? m->height - 1 : y + job->radius;
+        for (int sy = ya; sy <= yb; sy++)
+        {
+            const uint64_t *in = &job->tmp[(size_t)sy * m->words];
+            for (int w = 0; w < m->words; w++) out[w] |= in[w];
+        }
+    }
+}
+
+// every set cell grows into the (2r+1)^2 square around it, clipped to the mask
+void BitMaskDilate(BitMask *m, int radius)
+{
+    if (radius <= 0) return;
+    DilateJob job = { m, (uint64_t *)malloc(sizeof(uint64_t) * m->words * m->height), radius };
+    if (!job.tmp)
+    {
+        TraceLog(LOG_ERROR, "MORPH: out of memory dilating");
+        return;
+    }
+    ParallelFor(m->height, DilateRows, &job);
+    ParallelFor(m->height, DilateColumns, &job);
+    free(job.tmp);
+}
+
+//------------------------------------------------------------------connected components
+typedef struct {
+    int x0, x1;   // inclusive
+} BitRun;
+
+typedef struct {
+    BitMask *m;
+    int *rowStart;   // height+1, runs of row y are rowStart[y]..rowStart[y+1]
+    BitRun *runs;
+    int *parent;     // union-find over runs
+    int *size;       // cells, valid at roots
+    int minSize;
+} ComponentJob;
+
+static int RunFind(int *parent, int i)
+{
+    while (parent[i] != i)
+    {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+static void RunUnion(int *parent, int a, int b)
+{
+    a = RunFind(parent, a);
+    b = RunFind(parent, b);
+    if (a == b) return;
+    if (a < b) parent[b] = a; //lowest index wins, keeps roots stable whichever band gets there first
+    else parent[a] = b;
+}
+
+// the runs of set bits in a row (written to out when its not NULL), returns the count
+static int BitRowRuns(const uint64_t *row, int words, BitRun *out)
+{
+    int count = 0;
+    int start = -1;
+    for (int w = 0; w < words; w++)
+    {
+        uint64_t v = row[w];
+        if (start < 0 && v == 0) continue;
+        if (start >= 0 && v == ~0ULL) continue;
+        for (int b = 0; b < 64; b++)
+        {
+            bool on = (v >> b) & 1;
+            int x = w * 64 + b;
+            if (on && start < 0) start = x;
+            else if (!on && start >= 0)
+            {
+                if (out) out[count] = (BitRun){ start, x - 1 };
+                count++;
+                start = -1;
+            }
+        }
+    }
+    if (start >= 0)
+    {
+        if (out) out[count] = (BitRun){ start, words * 64 - 1 };
+        count++;
+    }
+    return count;
+}
+
+static void CountRuns(int y0, int y1, void *ctx)
+{
+    ComponentJob *job = (ComponentJob *)ctx;
+    for (int y = y0; y < y1; y++) job->rowStart[y + 1] = BitRowRuns(&job->m->bits[(size_t)y * job->m->words], job->m->words, NULL);
+}
+
+static void FillRuns(int y0, int y1, void *ctx)
+{
+    ComponentJob *job = (ComponentJob *)ctx;
+    for (int y = y0; y < y1; y++) BitRowRuns(&job->m->bits[(size_t)y * job->m->words], job->m->words, &job->runs[job->rowStart[y]]);
+}
+
+// 8-connected: runs on neighbouring rows touch if they overlap or meet at a corner
+static void UnionRows(ComponentJob *job, int yAbove)
+{
+    int a = job->rowStart[yAbove], aEnd = job->rowStart[yAbove + 1];
+    int b = job->rowStart[yAbove + 1], bEnd = job->rowStart[yAbove + 2];
+    while (a < aEnd && b < bEnd)
+    {
+        BitRun ra = job->runs[a], rb = job->runs[b];
+        if (ra.x0 <= rb.x1 + 1 && rb.x0 <= ra.x1 + 1) RunUnion(job->parent, a, b);
+        if (ra.x1 < rb.x1) a++;
+        else b++;
+    }
+}
+
+static void UnionBand(int y0, int y1, void *ctx)
+{
+    ComponentJob *job = (ComponentJob *)ctx;
+    for (int i = job->rowStart[y0]; i < job->rowStart[y1]; i++) job->parent[i] = i;
+    for (int y = y0; y + 1 < y1; y++) UnionRows(job, y);
+}
+
+static void ClearSmallRuns(int y0, int y1, void *ctx)
+{
+    ComponentJob *job = (ComponentJob *)ctx;
+    BitMask *m = job->m;
+    for (int y = y0; y < y1; y++)
+    {
+        uint64_t *row = &m->bits[(size_t)y * m->words];
+        for (int i = job->rowStart[y]; i < job->rowStart[y + 1]; i++)
+        {
+            if (job->size[job->parent[i]] >= job->minSize) continue;
+            for (int x = job->runs[i].x0; x <= job->runs[i].x1; x++) row[x >> 6] &= ~(1ULL << (x & 63));
+        }
+    }
+}
+
+// clear every 8-connected blob smaller than minSize cells, returns how many blobs went
+int BitMaskRemoveSmallComponents(BitMask *m, int minSize)
+{
+    ComponentJob job = { 0 };
+    job.m = m;
+    job.minSize = minSize;
+    job.rowStart = (int *)calloc(m->height + 1, sizeof(int));
+    if (!job.rowStart) return 0;
+    ParallelFor(m->height, CountRuns, &job);
+    for (int y = 0; y < m->height; y++) job.rowStart[y + 1] += job.rowStart[y];
+    int total = job.rowStart[m->height];
+    job.runs = (BitRun *)malloc(sizeof(BitRun) * (total > 0 ? total : 1));
+    job.parent = (int *)malloc(sizeof(int) * (total > 0 ? total : 1));
+    job.size = (int *)calloc(total > 0 ? total : 1, sizeof(int));
+    if (!job.runs || !job.parent || !job.size)
+    {
+        TraceLog(LOG_ERROR, "MORPH: out of memory for %d runs", total);
+        free(job.rowStart); free(job.runs); free(job.parent); free(job.size);
+        return 0;
+    }
+    ParallelFor(m->height, FillRuns, &job);
+
+    //bands only union runs inside themselves so they never touch each others parents, the band seams are done after
+    int bands = ParallelThreadCount();
+    if (bands > m->height) bands = m->height;
+    ParallelFor(m->height, UnionBand, &job);
+    for (int t = 1; t < bands; t++)
+    {
+        int seam = m->height * t / bands; //same split ParallelFor used
+        UnionRows(&job, seam - 1);
+    }
+
+    //flatten so the clear pass only reads parent (no path halving racing across threads)
+    for (int i = 0; i < total; i++)
+    {
+        job.parent[i] = RunFind(job.parent, i);
+        job.size[job.parent[i]] += job.runs[i].x1 - job.runs[i].x0 + 1;
+    }
+    int removed = 0;
+    for (int i = 0; i < total; i++)
+    {
+        if (job.parent[i] == i && job.size[i] < minSize) removed++;
+    }
+    ParallelFor(m->height, ClearSmallRuns, &job);
+
+    free(job.rowStart);
+    free(job.runs);
+    free(job.parent);
+    free(job.size);
+    return removed;
+}
+
+#endif //MORPHOLOGY_H
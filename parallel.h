@@ -0,0 +1,68 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+//split a range of rows (or chunks, or whatever) over a few pthreads and wait for them
+//the job gets [begin, end) and must only write things nobody else in the range touches, there are no locks in here
+//small ranges or one core just run inline on the calling thread
+#include "raylib.h"
+
+#include <pthread.h>
+#include <unistd.h>
+
+#define PARALLEL_MAX_THREADS 16
+
+typedef void (*ParallelJob)(int begin, int end, void *ctx);
+
+typedef struct {
+    ParallelJob job;
+    void *ctx;
+    int begin, end;
+} ParallelSlice;
+
+int parallelThreads = 0; //0 means ask the os, --threads N sets it
+
+int ParallelThreadCount(void)
+{
+    if (parallelThreads > 0) return parallelThreads > PARALLEL_MAX_THREADS ? PARALLEL_MAX_THREADS : parallelThreads;
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    if (n < 1) n = 1;
+    return n > PARALLEL_MAX_THREADS ? PARALLEL_MAX_THREADS : (int)n;
+}
+
+static void *ParallelSliceRun(void *arg)
+{
+    ParallelSlice *s = (ParallelSlice *)arg;
+    s->job(s->begin, s->end, s->ctx);
+    return NULL;
+}
+
+// run job over [0, count) in even slices, returns once every slice is done
+void ParallelFor(int count, ParallelJob job, void *ctx)
+{
+    if (count <= 0) return;
+    int threads = ParallelThreadCount();
+    if (threads > count) threads = count;
+    if (threads <= 1)
+    {
+        job(0, count, ctx);
+        return;
+    }
+
+    pthread_t ids[PARALLEL_MAX_THREADS];
+    ParallelSlice slices[PARALLEL_MAX_THREADS];
+    bool started[PARALLEL_MAX_THREADS] = { 0 };
+    for (int t = 0; t < threads; t++)
+    {
+        slices[t] = (ParallelSlice){ job, ctx, count * t / threads, count * (t + 1) / threads };
+        //slice 0 runs here, if a thread wont start its slice runs here too
+        if (t > 0 && pthread_create(&ids[t], NULL, ParallelSliceRun, &slices[t]) == 0) started[t] = true;
+    }
+    ParallelSliceRun(&slices[0]);
+    for (int t = 1; t < threads; t++)
+    {
+        if (started[t]) pthread_join(ids[t], NULL);
+        else ParallelSliceRun(&slices[t]);
+    }
+}
+
+#endif //PARALLEL_H
@@ -6,6 +6,14 @@
 //me
 #include "models.h"
 #include "gpu.h"
+#include "render_queue.h"
+#include "profiler.h"
+#include "trace.h"
+#include "memtrack.h"
+#include "arena.h"
+#include "bench.h"
+#include "world.h"
+#include "mipmap.h"
 //fairlry standard things
 #include <float.h>
 #include <stdio.h>
@@ -19,23 +27,17 @@
 #include <inttypes.h>
 
 
-#define MAX_CHUNK_DIM 16
-#define CHUNK_COUNT 16
-#define CHUNK_SIZE 64
-#define CHUNK_WORLD_SIZE 1024.0f
+//CHUNK_COUNT, CHUNK_SIZE, CHUNK_WORLD_SIZE, MAP_SIZE, MAP_SCALE, TILE_GRID_SIZE come from world.h, read from map/world.txt at startup
 #define MAX_WORLD_SIZE (CHUNK_COUNT * CHUNK_WORLD_SIZE)
 #define WORLD_WIDTH  MAX_WORLD_SIZE
 #define WORLD_HEIGHT MAX_WORLD_SIZE
 #define GAME_MAP_SIZE 128
-#define MAP_SIZE (CHUNK_COUNT * CHUNK_SIZE)
 #define MAX_CHUNKS_TO_QUEUE (CHUNK_COUNT * CHUNK_COUNT)
-#define MAP_SCALE 16
 #define MAP_VERTICAL_OFFSET 0 //(MAP_SCALE * -64)
 #define PLAYER_HEIGHT 1.7f
 #define FULL_TREE_DIST 85.42f //112.2f
 
 //chunk tile system
-#define TILE_GRID_SIZE 8 //sync with main.c
 #define TILE_WORLD_SIZE (CHUNK_WORLD_SIZE / TILE_GRID_SIZE)
 #define WORLD_ORIGIN_OFFSET (CHUNK_COUNT / 2 * CHUNK_WORLD_SIZE)
 #define MAX_TILES ((CHUNK_WORLD_SIZE * CHUNK_WORLD_SIZE / TILE_GRID_SIZE / TILE_GRID_SIZE));
@@ -43,8 +45,11 @@
 #define TILE_GPU_UPLOAD_GRID_DIST 4
 
 //water
-#define MAX_WATER_PATCHES_PER_CHUNK 64
 #define WATER_Y_OFFSET 60.0f
+#define WATER_WAVE_PAD 3.0f //water.vs moves vertices +-2.5
+#define WATER_NEAR_DIST (1.5f * CHUNK_WORLD_SIZE) //near (subdivided) pieces inside this, far (flat rects) outside
+#define WATER_WAVE_FADE_DIST (1.0f * CHUNK_WORLD_SIZE) //water.vs waves start fading here and are gone by WATER_NEAR_DIST
+#define WATER_DRAW_DIST (2.5f * CHUNK_WORLD_SIZE) //same reach the LOD_32 chunk water had
 #define PLAYER_FLOAT_OFFSET 339.9f
 
 
@@ -78,15 +83,12 @@ typedef enum {
     LOD_8
 } TypeLOD;
 
+//cold side of a chunk, the assets, only touched on load/upload and by things that need the mesh or props
+//the per frame state (lod, flags, boxes, positions) lives in chunkHot below
 typedef struct {
     int id;
     int cx;
     int cy;
-    bool isLoaded; //in GPU
-    bool isReady; //in RAM
-    bool isTextureReady;
-    bool isTextureLoaded;
-    BoundingBox box;
     BoundingBox origBox;
     Model model;
     Model model32;
@@ -96,24 +98,75 @@ typedef struct {
     Mesh mesh32;
     Mesh mesh16;
     Mesh mesh8;
-    TypeLOD lod;
     Image img_tex;
-    Image img_tex_big;
+    Image img_tex_big;  // big and full are views into img_tex_damns mip chain, not their own allocations
     Image img_tex_full;
     Image img_tex_damn;
     Texture2D texture;
     Texture2D textureBig;
     Texture2D textureFull;
     Texture2D textureDamn;
-    Vector3 position;
-    Vector3 center;
     StaticGameObject *props;
     int treeCount;
     int curTreeIdx;
-    Model *water;
-    int waterCount;
+    Model water; //every exported patch of the chunk merged into one mesh at load
+    Model waterFar; //same water from the uncapped greedy rects, for LOD_32
+    int waterPatchCount; //how many patches went into it, for reports
+    Arena arena; //the props buffer, one reservation per chunk
 } Chunk;
 
+//hot side, struct of arrays indexed by chunk id, the lod/upload/cull/draw loops walk these front to back
+//(the old way strided over the whole Chunk, models and images and all, to read one byte of lod)
+//each array is CHUNK_TOTAL long, allocated by ChunkHotAlloc once the world is loaded
+typedef struct {
+    TypeLOD *lod;
+    bool *isLoaded; //in GPU
+    bool *isReady; //in RAM
+    bool *isTextureReady;
+    bool *isTextureLoaded;
+    bool *hasWater;
+    bool *hasWaterFar;
+    BoundingBox *box;
+    Vector3 *position;
+    Vector3 *center;
+} ChunkHot;
+
+ChunkHot chunkHot = { 0 };
+
+bool ChunkHotAlloc(void)
+{
+    chunkHot.lod = calloc(CHUNK_TOTAL, sizeof(TypeLOD));
+    chunkHot.isLoaded = calloc(CHUNK_TOTAL, sizeof(bool));
+    chunkHot.isReady = calloc(CHUNK_TOTAL, sizeof(bool));
+    chunkHot.isTextureReady = calloc(CHUNK_TOTAL, sizeof(bool));
+    chunkHot.isTextureLoaded = calloc(CHUNK_TOTAL, sizeof(bool));
+    chunkHot.hasWater = calloc(CHUNK_TOTAL, sizeof(bool));
+    chunkHot.hasWaterFar = calloc(CHUNK_TOTAL, sizeof(bool));
+    chunkHot.box = calloc(CHUNK_TOTAL, sizeof(BoundingBox));
+    chunkHot.position = calloc(CHUNK_TOTAL, sizeof(Vector3));
+    chunkHot.center = calloc(CHUNK_TOTAL, sizeof(Vector3));
+    return chunkHot.lod && chunkHot.isLoaded && chunkHot.isReady && chunkHot.isTextureReady && chunkHot.isTextureLoaded &&
+           chunkHot.hasWater && chunkHot.hasWaterFar && chunkHot.box && chunkHot.position && chunkHot.center;
+}
+
+void ChunkHotFree(void)
+{
+    free(chunkHot.lod);
+    free(chunkHot.isLoaded);
+    free(chunkHot.isReady);
+    free(chunkHot.isTextureReady);
+    free(chunkHot.isTextureLoaded);
+    free(chunkHot.hasWater);
+    free(chunkHot.hasWaterFar);
+    free(chunkHot.box);
+    free(chunkHot.position);
+    free(chunkHot.center);
+    memset(&chunkHot, 0, sizeof(ChunkHot));
+}
+
+// same numbering as Chunk.id
+static inline int ChunkId(int cx, int cy) { return cx * CHUNK_COUNT + cy; }
+
 //tiles-------------------------------------------------------------------------
 typedef struct {
     int cx, cy;
@@ -136,11 +189,19 @@ typedef struct {
     float alpha; 
 } LightningBug;
 #define BUG_COUNT 256 //oh yeah!
+//one part of a world water body, from map/water_bodies.txt
+typedef struct {
+    int body;
+    int piece;
+    bool far;
+    Model model;
+    BoundingBox box; //bounds of the whole piece, near and far parts of a piece share it
+} WaterPiece;
+WaterPiece *waterPieces = NULL;
+int waterPieceCount = 0;
 typedef struct {
     Vector3 pos;
-    float timer; 
-    float alpha; 
-} Star;
+} Star;//twinkle lives in lighting_star.vs now, the cpu only places them once
 #define STAR_COUNT 512 //oh yeah!
 Color starColors[4] = {
     (Color){255, 200, 100, 255}, // warm
@@ -152,10 +213,10 @@ Color starColors[4] = {
 //int curTreeIdx = 0;
 int tree_elf = 0;
 //very very important
-int chosenX = 7;
-int chosenY = 7;
-int closestCX = 7;
-int closestCY = 7;
+int chosenX = 0; //middle chunk, set in main once the world is loaded
+int chosenY = 0;
+int closestCX = 0;
+int closestCY = 0;
 bool onLoad = false;
 Vector3 lastLBSpawnPosition ={0};
 TileEntry *foundTiles = NULL; //will be quite large potentially (in reality not as much)
@@ -220,15 +281,14 @@ void MemoryReport()
 {
     printf("Start Memory Report -> \n");
     printf("FPS                                : %d\n", GetFPS());
-    printf("Chunk Memory         (estimated)   : %zu\n", (CHUNK_COUNT * CHUNK_COUNT) * sizeof(Chunk));
-    printf("Batched Props Memory (estimated)   : %zu\n", foundTileCount * sizeof(StaticGameObject));
+    MemTrackPrint();
     int64_t ct_8_tri=0, ct_16_tri=0, ct_32_tri=0, ct_64_tri=0;
     int64_t ct_8_vt=0, ct_16_vt=0, ct_32_vt=0, ct_64_vt=0;
     for (int cx = 0; cx < CHUNK_COUNT; cx++)
     {
         for (int cy = 0; cy < CHUNK_COUNT; cy++)
         {
-            if (!chunks[cx][cy].isLoaded) {continue;}
+            if (!chunkHot.isLoaded[ChunkId(cx, cy)]) {continue;}
             ct_64_tri += chunks[cx][cy].model.meshes[0].triangleCount;
             ct_64_vt += chunks[cx][cy].model.meshes[0].vertexCount;
             ct_32_tri += chunks[cx][cy].model32.meshes[0].triangleCount;
@@ -279,8 +339,8 @@ void GridChunkReport()
     {
         for (int cy = 0; cy < CHUNK_COUNT; cy++)
         {
-            if(chunks[cx][cy].lod==LOD_8){continue;}//dont show these as they are numerous and beligerant
-            printf("Chunk %d %d - %d\n", cx, cy, chunks[cx][cy].lod);
+            if(chunkHot.lod[ChunkId(cx, cy)]==LOD_8){continue;}//dont show these as they are numerous and beligerant
+            printf("Chunk %d %d - %d\n", cx, cy, chunkHot.lod[ChunkId(cx, cy)]);
         }
     }
     printf("   ->   ->   End Chunk Grid Report. \n");
@@ -293,7 +353,7 @@ void GridTileReport()
     {
         for (int cy = 0; cy < CHUNK_COUNT; cy++)
         {
-            if(chunks[cx][cy].lod!=LOD_64){continue;}//we only care about the active tile grid
+            if(chunkHot.lod[ChunkId(cx, cy)]!=LOD_64){continue;}//we only care about the active tile grid
             for (int i=0; i<foundTileCount; i++)
             {
                 if(foundTiles[i].cx==cx&&foundTiles[i].cy==cy)
@@ -360,13 +420,13 @@ float GetHeightOnTriangle(Vector3 p, Vector3 a, Vector3 b, Vector3 c)
     return u * a.y + v * b.y + w * c.y;
 }
 
-float GetTerrainHeightFromMeshXZ(Chunk chunk, float x, float z)
+float GetTerrainHeightFromMeshXZ(int cx, int cy, float x, float z)
 {
-    Mesh mesh = chunk.model.meshes[0];
+    Mesh mesh = chunks[cx][cy].model.meshes[0];
+    Vector3 position = chunkHot.position[ChunkId(cx, cy)];
     float *verts = (float *)mesh.vertices;
     unsigned short *tris = (unsigned short *)mesh.indices;
-    //TraceLog(LOG_INFO, "chunk pos (%f, %f, %f)", chunk.position.x, chunk.position.y, chunk.position.z);
-    //TraceLog(LOG_INFO, "chunk cen (%f, %f, %f)", chunk.center.x, chunk.center.y, chunk.center.z);
+    //TraceLog(LOG_INFO, "chunk pos (%f, %f, %f)", position.x, position.y, position.z);
     if (!verts || mesh.vertexCount < 3 || mesh.triangleCount < 1)
     {
         TraceLog(LOG_WARNING, "Something wrong with collision: (%f x %f)", x, z);
@@ -394,19 +454,19 @@ float GetTerrainHeightFromMeshXZ(Chunk chunk, float x, float z)
         if (i0 >= mesh.vertexCount || i1 >= mesh.vertexCount || i2 >= mesh.vertexCount){continue;}
 
         Vector3 a = {
-            (MAP_SCALE * verts[i0 * 3 + 0] + chunk.position.x),
-            (MAP_SCALE * verts[i0 * 3 + 1] + chunk.position.y),
-            (MAP_SCALE * verts[i0 * 3 + 2] + chunk.position.z)
+            (MAP_SCALE * verts[i0 * 3 + 0] + position.x),
+            (MAP_SCALE * verts[i0 * 3 + 1] + position.y),
+            (MAP_SCALE * verts[i0 * 3 + 2] + position.z)
         };
         Vector3 b = {
-            (MAP_SCALE * verts[i1 * 3 + 0] + chunk.position.x),
-            (MAP_SCALE * verts[i1 * 3 + 1] + chunk.position.y),
-            (MAP_SCALE * verts[i1 * 3 + 2] + chunk.position.z)
+            (MAP_SCALE * verts[i1 * 3 + 0] + position.x),
+            (MAP_SCALE * verts[i1 * 3 + 1] + position.y),
+            (MAP_SCALE * verts[i1 * 3 + 2] + position.z)
         };
         Vector3 c = {
-            (MAP_SCALE * verts[i2 * 3 + 0] + chunk.position.x),
-            (MAP_SCALE * verts[i2 * 3 + 1] + chunk.position.y),
-            (MAP_SCALE * verts[i2 * 3 + 2] + chunk.position.z)
+            (MAP_SCALE * verts[i2 * 3 + 0] + position.x),
+            (MAP_SCALE * verts[i2 * 3 + 1] + position.y),
+            (MAP_SCALE * verts[i2 * 3 + 2] + position.z)
         };
         //TraceLog(LOG_INFO, "Tri %d verts: a=(%.2f,%.2f,%.2f)", i, a.x, a.y, a.z);
         //TraceLog(LOG_INFO, "Tri %d verts: b=(%.2f,%.2f,%.2f)", i, b.x, b.y, b.z);
@@ -430,6 +490,16 @@ void UnloadMeshGPU(Mesh *mesh) {
     mesh->vboId[0] = 0;
 }
 
+// Free the arrays LoadModel/LoadModelFromMesh put around the meshes (mesh list, materials), not the mesh data and nothing on the gpu
+// materials are not unloaded on purpose, the shader and textures on them are shared
+void FreeModelShell(Model model)
+{
+    for (int i = 0; i < model.materialCount; i++) RL_FREE(model.materials[i].maps);
+    RL_FREE(model.materials);
+    RL_FREE(model.meshes);
+    RL_FREE(model.meshMaterial);
+}
+
 int loadTileCnt = 0; //-- need this counter to be global, counted in these functions
 void OpenTiles()
 {
@@ -447,7 +517,8 @@ void OpenTiles()
                 // Save entry
                     TileEntry entry = { cx, cy, tx, ty };
                     strcpy(entry.path, path);
-                    entry.model = LoadModel(entry.path);
+                    entry.model = TracedLoadModel(entry.path);
+                    MemTrackModelCpu(MEM_TILES, entry.model, 1);
                     entry.mesh = entry.model.meshes[0];
                     entry.isReady = true;
                     entry.type = (Model_Type)type;
@@ -468,7 +539,7 @@ void DocumentTiles(int cx, int cy)
         for (int ty = 0; ty < TILE_GRID_SIZE; ty++) {
             for (int i=0; i < MODEL_TOTAL_COUNT; i++)
             {
-                pthread_mutex_lock(&mutex);
+                TraceMutexLock(&mutex, "DocumentTiles");
                 char path[256];
                 snprintf(path, sizeof(path),
                         "map/chunk_%02d_%02d/tile_64/%02d_%02d/tile_%s_64.obj",
@@ -480,7 +551,8 @@ void DocumentTiles(int cx, int cy)
                     // Save entry
                     TileEntry entry = { cx, cy, tx, ty };
                     strcpy(entry.path, path);
-                    entry.model = LoadModel(entry.path);
+                    entry.model = TracedLoadModel(entry.path);
+                    MemTrackModelCpu(MEM_TILES, entry.model, 1);
                     entry.mesh = entry.model.meshes[0];
                     entry.isReady = true;
                     entry.type = (Model_Type)i;
@@ -570,7 +642,7 @@ static Light CreateLightPbr(int type, Vector3 position, Vector3 target, Color co
 bool bugGenHappened = false;
 LightningBug *GenerateLightningBugs(Vector3 cameraPos, int count, float maxDistance)
 {
-    LightningBug *bugs = (LightningBug *)malloc(sizeof(LightningBug) * count);
+    LightningBug *bugs = (LightningBug *)MemTrackMalloc(MEM_PARTICLES, sizeof(LightningBug) * count);
     if (!bugs) return NULL;
     BoundingBox box = {
         .min = (Vector3){ -0.25f, -0.25f, -0.25f },
@@ -586,7 +658,7 @@ LightningBug *GenerateLightningBugs(Vector3 cameraPos, int count, float maxDista
         float z = cameraPos.z + sinf(angle) * dist;
         bugs[i].angle = 0.0f;
         bugs[i].pos = (Vector3){ x, 0.0f, z }; // you'll set .y later
-        bugs[i].pos.y = GetTerrainHeightFromMeshXZ(chunks[closestCX][closestCY], bugs[i].pos.x, bugs[i].pos.z);
+        bugs[i].pos.y = GetTerrainHeightFromMeshXZ(closestCX, closestCY, bugs[i].pos.x, bugs[i].pos.z);
         bugs[i].pos.y = bugs[i].pos.y + GetRandomValue(1, 10);
         if(bugs[i].pos.y<-5000){bugs[i].pos.y=500;}
         bugs[i].rate = GetRandomValue(0.1f, 10.01f);
@@ -614,7 +686,7 @@ void RegenerateLightningBugs(LightningBug *bugs, Vector3 cameraPos, int count, f
         float z = cameraPos.z + sinf(angle) * dist;
         bugs[i].angle = 0.0f;
         bugs[i].pos = (Vector3){ x, 0.0f, z }; // you'll set .y later
-        bugs[i].pos.y = GetTerrainHeightFromMeshXZ(chunks[closestCX][closestCY], bugs[i].pos.x, bugs[i].pos.z);
+        bugs[i].pos.y = GetTerrainHeightFromMeshXZ(closestCX, closestCY, bugs[i].pos.x, bugs[i].pos.z);
         bugs[i].pos.y = bugs[i].pos.y + GetRandomValue(1, 10);
         if(bugs[i].pos.y<-5000){bugs[i].pos.y=500;}
         bugs[i].rate = GetRandomValue(0.1f, 10.01f);
@@ -669,36 +741,11 @@ void UpdateLightningBugs(LightningBug *bugs, int count, float deltaTime)
     }
 }
 
-void UpdateStars(Star *stars, int count)
-{
-    for (int i = 0; i < count; i++)
-    {
-        // === XZ movement ===
-        //new stuff
-        stars[i].timer -= 0.0001;
-        if (stars[i].timer <= 0.0f)
-        {
-            // 25% chance this bug blinks
-            if (GetRandomValue(1, 597) < 13)
-            {
-                stars[i].alpha = 1.0f;
-            }
-            stars[i].timer = 1.0f + (GetRandomValue(0, 100000) / 100.0f); // reset 1–2 sec
-        }
-        // fade out
-        if (stars[i].alpha > 0.0f)
-        {
-            stars[i].alpha -= 0.07f; // fade fast
-            if (stars[i].alpha < 0.0f) stars[i].alpha = 0.0f;
-        }
-    }
-}
-
 //stars
 bool starGenHappened = false;
 Star *GenerateStars(int count)
 {
-    Star *stars = (Star *)malloc(sizeof(LightningBug) * count);
+    Star *stars = (Star *)MemTrackMalloc(MEM_PARTICLES, sizeof(Star) * count);
     if (!stars) return NULL;
 
     for (int i = 0; i < count; i++)
@@ -728,8 +775,59 @@ Star *GenerateStars(int count)
     return stars;
 }
 
+//the stars never move, so their transforms go to the gpu one time, instance id rides in m15 for the shader
+unsigned int UploadStarField(Star *stars, int count, Mesh mesh, Shader shader)
+{
+    Matrix *starTransforms = (Matrix *)MemTrackMalloc(MEM_PARTICLES, sizeof(Matrix) * count);
+    if (!starTransforms) return 0;
+    for (int i = 0; i < count; i++)
+    {
+        Matrix mat = MatrixTranslate(stars[i].pos.x, stars[i].pos.y, stars[i].pos.z);
+        mat.m15 = (float)i;  // Encode instanceId into the matrix (instanceTransform[3][3] in the shader)
+        starTransforms[i] = mat;
+    }
+    unsigned int vbo = LoadInstanceBuffer(mesh, shader, starTransforms, count);
+    MemTrackFree(starTransforms);
+    if (vbo != 0) MemTrackGpu(MEM_PARTICLES, (int64_t)count * sizeof(float16), 1);
+    return vbo;
+}
+
+
+//append src to dst as plain triangles (indices get expanded), dst is cpu only until UploadMesh
+bool AppendMeshTriangles(Mesh *dst, int *capVerts, Mesh src)
+{
+    int srcVerts = (src.indices != NULL) ? src.triangleCount * 3 : src.vertexCount;
+    if (srcVerts <= 0 || src.vertices == NULL) return true;
+    if (dst->vertexCount + srcVerts > *capVerts)
+    {
+        int newCap = *capVerts * 2;
+        if (newCap < dst->vertexCount + srcVerts) newCap = dst->vertexCount + srcVerts;
+        float *v = (float *)RL_REALLOC(dst->vertices, sizeof(float) * 3 * newCap);
+        if (v) dst->vertices = v;
+        float *t = (float *)RL_REALLOC(dst->texcoords, sizeof(float) * 2 * newCap);
+        if (t) dst->texcoords = t;
+        float *n = (float *)RL_REALLOC(dst->normals, sizeof(float) * 3 * newCap);
+        if (n) dst->normals = n;
+        if (!v || !t || !n) return false;
+        *capVerts = newCap;
+    }
+    for (int i = 0; i < srcVerts; i++)
+    {
+        int si = (src.indices != NULL) ? src.indices[i] : i;
+        int di = dst->vertexCount + i;
+        memcpy(&dst->vertices[di*3], &src.vertices[si*3], sizeof(float) * 3);
+        if (src.texcoords) memcpy(&dst->texcoords[di*2], &src.texcoords[si*2], sizeof(float) * 2);
+        else { dst->texcoords[di*2] = 0.0f; dst->texcoords[di*2+1] = 0.0f; }
+        if (src.normals) memcpy(&dst->normals[di*3], &src.normals[si*3], sizeof(float) * 3);
+        else { dst->normals[di*3] = 0.0f; dst->normals[di*3+1] = 1.0f; dst->normals[di*3+2] = 0.0f; }
+    }
+    dst->vertexCount += srcVerts;
+    dst->triangleCount = dst->vertexCount / 3;
+    return true;
+}
 
 //water is similar to tiles with a manifest
+//all patches of a chunk are merged into one mesh here, so water is one draw per chunk instead of one per patch
 void OpenWaterObjects(Shader shader) {
     FILE *f = fopen("map/water_manifest.txt", "r"); // Open the manifest
     if (!f) {
@@ -737,43 +835,136 @@ void OpenWaterObjects(Shader shader) {
         return;
     }
 
+    //cpu side merge buffers, near and far per chunk ([id*2+far]), uploaded after the whole manifest is read
+    int chunkTotal = CHUNK_COUNT * CHUNK_COUNT;
+    Mesh *merged = (Mesh *)calloc(chunkTotal * 2, sizeof(Mesh));
+    int *mergedCap = (int *)calloc(chunkTotal * 2, sizeof(int));
+    if (!merged || !mergedCap) {
+        TraceLog(LOG_ERROR, "Out of memory merging water patches");
+        free(merged); free(mergedCap); fclose(f);
+        return;
+    }
+
     char line[256];
     while (fgets(line, sizeof(line), f)) {
         int cx, cy, patch;
-        if (sscanf(line, "%d %d %d", &cx, &cy, &patch) == 3) {
+        char variant[16] = { 0 };
+        int fields = sscanf(line, "%d %d %d %15s", &cx, &cy, &patch, variant);
+        if (fields >= 3) {
             if (cx >= 0 && cx < CHUNK_COUNT && cy >= 0 && cy < CHUNK_COUNT) {
+                int far = (fields == 4 && strcmp(variant, "far") == 0) ? 1 : 0;
                 // Build file path
                 char path[256];
-                snprintf(path, sizeof(path), "map/chunk_%02d_%02d/water/patch_%d.obj", cx, cy, patch);
+                snprintf(path, sizeof(path), "map/chunk_%02d_%02d/water/patch_%d%s.obj", cx, cy, patch, far ? "_far" : "");
 
-                Model model = LoadModel(path);
+                Model model = TracedLoadModel(path);
                 if (model.meshCount > 0) {
-                    // Allocate if needed
-                    if (chunks[cx][cy].water == NULL) {
-                        chunks[cx][cy].water = MemAlloc(sizeof(Model) * MAX_WATER_PATCHES_PER_CHUNK);
-                        chunks[cx][cy].waterCount = 0;
+                    int id = (cx * CHUNK_COUNT + cy) * 2 + far;
+                    bool ok = true;
+                    for (int m = 0; m < model.meshCount && ok; m++) {
+                        ok = AppendMeshTriangles(&merged[id], &mergedCap[id], model.meshes[m]);
                     }
-
-                    if (chunks[cx][cy].waterCount < MAX_WATER_PATCHES_PER_CHUNK) {
-                        chunks[cx][cy].water[chunks[cx][cy].waterCount] = model;
-                        chunks[cx][cy].water[chunks[cx][cy].waterCount].materials[0].shader = shader;
-                        chunks[cx][cy].water[chunks[cx][cy].waterCount].materials[0].maps[MATERIAL_MAP_DIFFUSE].color = (Color){ 0, 100, 255, 255 }; // semi-transparent blue;
-                        chunks[cx][cy].waterCount++;
+                    if (ok) {
+                        if (!far) chunks[cx][cy].waterPatchCount++;
                         TraceLog(LOG_INFO, "Loaded water model: %s", path);
                     } else {
-                        TraceLog(LOG_WARNING, "Too many water patches in chunk %d,%d", cx, cy);
-                        UnloadModel(model);
+                        TraceLog(LOG_WARNING, "Out of memory merging water patch: %s", path);
                     }
                 } else {
                     TraceLog(LOG_WARNING, "Failed to load water mesh: %s", path);
                 }
+                UnloadModel(model);//only needed the cpu copy, the merged mesh gets its own upload
             }
         } else {
             TraceLog(LOG_WARNING, "Malformed line in water manifest: %s", line);
         }
     }
+    fclose(f);
 
+    for (int cx = 0; cx < CHUNK_COUNT; cx++) {
+        for (int cy = 0; cy < CHUNK_COUNT; cy++) {
+            for (int far = 0; far < 2; far++) {
+                int id = (cx * CHUNK_COUNT + cy) * 2 + far;
+                if (merged[id].vertexCount == 0) {
+                    RL_FREE(merged[id].vertices); RL_FREE(merged[id].texcoords); RL_FREE(merged[id].normals);
+                    continue;
+                }
+                TracedUploadMesh(&merged[id], false);
+                MemTrackCpu(MEM_WATER, (int64_t)MeshCpuBytes(merged[id]), 1);
+                MemTrackMeshGpu(MEM_WATER, merged[id], 1);
+                Model water = LoadModelFromMesh(merged[id]);
+                water.materials[0].shader = shader;
+                water.materials[0].maps[MATERIAL_MAP_DIFFUSE].color = (Color){ 0, 100, 255, 255 }; // semi-transparent blue;
+                if (far) { chunks[cx][cy].waterFar = water; chunkHot.hasWaterFar[ChunkId(cx, cy)] = true; }
+                else { chunks[cx][cy].water = water; chunkHot.hasWater[ChunkId(cx, cy)] = true; }
+                TraceLog(LOG_INFO, "Merged %s water for chunk %d,%d (%d tris)", far ? "far" : "near", cx, cy, merged[id].triangleCount);
+            }
+        }
+    }
+    free(merged);
+    free(mergedCap);
+}
+
+//world water bodies, one model per exported part, returns false if the map has no body manifest (older export)
+bool OpenWaterBodies(Shader shader) {
+    FILE *f = fopen("map/water_bodies.txt", "r");
+    if (!f) return false;
+
+    int lines = 0;
+    int c;
+    while ((c = fgetc(f)) != EOF) {
+        if (c == '\n') lines++;
+    }
+    rewind(f);
+    waterPieces = (WaterPiece *)calloc(lines > 0 ? lines : 1, sizeof(WaterPiece));
+    if (!waterPieces) {
+        TraceLog(LOG_ERROR, "Out of memory allocating water pieces");
+        fclose(f);
+        return false;
+    }
+
+    char line[256];
+    while (fgets(line, sizeof(line), f) && waterPieceCount < lines) {
+        int body, piece, part;
+        char variant[16] = { 0 };
+        Vector3 bmin, bmax;
+        if (sscanf(line, "%d %d %d %15s %f %f %f %f %f %f", &body, &piece, &part, variant,
+                   &bmin.x, &bmin.y, &bmin.z, &bmax.x, &bmax.y, &bmax.z) != 10) {
+            TraceLog(LOG_WARNING, "Malformed line in water bodies: %s", line);
+            continue;
+        }
+        bool far = strcmp(variant, "far") == 0;
+        char path[256];
+        snprintf(path, sizeof(path), "map/water/body_%d_%d%s.obj", body, part, far ? "_far" : "");
+        Model model = TracedLoadModel(path);
+        if (model.meshCount <= 0) {
+            TraceLog(LOG_WARNING, "Failed to load water mesh: %s", path);
+            continue;
+        }
+        model.materials[0].shader = shader;
+        model.materials[0].maps[MATERIAL_MAP_DIFFUSE].color = (Color){ 0, 100, 255, 255 }; // semi-transparent blue;
+        MemTrackModelCpu(MEM_WATER, model, 1);
+        MemTrackGpu(MEM_WATER, (int64_t)ModelGpuBytes(model), 1);
+        WaterPiece *wp = &waterPieces[waterPieceCount++];
+        wp->body = body;
+        wp->piece = piece;
+        wp->far = far;
+        wp->model = model;
+        //drawn WATER_Y_OFFSET higher, plus room for the waves
+        wp->box.min = (Vector3){ bmin.x, bmin.y + WATER_Y_OFFSET - WATER_WAVE_PAD, bmin.z };
+        wp->box.max = (Vector3){ bmax.x, bmax.y + WATER_Y_OFFSET + WATER_WAVE_PAD, bmax.z };
+    }
     fclose(f);
+    waterManifestCount = waterPieceCount;
+    TraceLog(LOG_INFO, "Loaded %d water body parts", waterPieceCount);
+    return true;
+}
+
+//flat (xz) distance from p to the box, 0 inside
+float BoxDistanceXZ(BoundingBox box, Vector3 p) {
+    float dx = fmaxf(fmaxf(box.min.x - p.x, 0.0f), p.x - box.max.x);
+    float dz = fmaxf(fmaxf(box.min.z - p.z, 0.0f), p.z - box.max.z);
+    return sqrtf(dx*dx + dz*dz);
 }
 
 // Convert world-space position to global tile coordinates
@@ -973,7 +1164,7 @@ void FindClosestChunkAndAssignLod(Camera3D *camera)
         //TraceLog(LOG_INFO, "!foundChunkWithBox => (%f,%f)=>[%d,%d]",camera->position.x,camera->position.z, chunkX, chunkY);
         if (chunkX >= 0 && chunkX < CHUNK_COUNT &&
             chunkY >= 0 && chunkY < CHUNK_COUNT &&
-            chunks[chunkX][chunkY].isLoaded)
+            chunkHot.isLoaded[ChunkId(chunkX, chunkY)])
         {
             closestCX = chunkX;
             closestCY = chunkY;
@@ -985,26 +1176,26 @@ void FindClosestChunkAndAssignLod(Camera3D *camera)
     }
     //TraceLog(LOG_INFO, "FindClosestChunkAndAssignLod (2): (%d x %d)", closestCX, closestCY);
     // --- Second pass: assign LODs ---
-    for (int cy = 0; cy < CHUNK_COUNT; cy++) {
-        for (int cx = 0; cx < CHUNK_COUNT; cx++) {
-            int dx = abs(cx - closestCX);
-            int dy = abs(cy - closestCY);
-
-            if (cx == closestCX && cy == closestCY) {
-                chunks[cx][cy].lod = LOD_64;  // Highest LOD
-            }
-            else if (dx <= 1 && dy <= 1) {
-                chunks[cx][cy].lod = LOD_64;
-            }
-            else if (dx <= 2 && dy <= 2) {
-                chunks[cx][cy].lod = LOD_32;
-            }
-            else if (dx <= 3 && dy <=3) {
-                chunks[cx][cy].lod = LOD_16;
-            }
-            else {
-                chunks[cx][cy].lod = LOD_8;
-            }
+    for (int id = 0; id < CHUNK_TOTAL; id++) {
+        int cx = id / CHUNK_COUNT;
+        int cy = id % CHUNK_COUNT;
+        int dx = abs(cx - closestCX);
+        int dy = abs(cy - closestCY);
+
+        if (cx == closestCX && cy == closestCY) {
+            chunkHot.lod[id] = LOD_64;  // Highest LOD
+        }
+        else if (dx <= 1 && dy <= 1) {
+            chunkHot.lod[id] = LOD_64;
+        }
+        else if (dx <= 2 && dy <= 2) {
+            chunkHot.lod[id] = LOD_32;
+        }
+        else if (dx <= 3 && dy <=3) {
+            chunkHot.lod[id] = LOD_16;
+        }
+        else {
+            chunkHot.lod[id] = LOD_8;
         }
     }
 }
@@ -1042,11 +1233,11 @@ bool FindNextTreeInChunk(Camera3D *camera, int cx, int cy, float minDistance, Mo
 
 bool FindAnyTreeInWorld(Camera *camera, float radius, Model_Type type) {
     int attempts = 0;
-    const int maxAttempts = MAX_CHUNK_DIM * MAX_CHUNK_DIM;
+    const int maxAttempts = CHUNK_COUNT * CHUNK_COUNT;
 
     while (attempts < maxAttempts) {
-        int cx = rand() % MAX_CHUNK_DIM;
-        int cy = rand() % MAX_CHUNK_DIM;
+        int cx = rand() % CHUNK_COUNT;
+        int cy = rand() % CHUNK_COUNT;
         tree_elf++;
 
         if (FindNextTreeInChunk(camera, cx, cy, radius, type)) {
@@ -1103,7 +1294,7 @@ void ImageDataFlipHorizontal(Image *image) {
 }
 
 Image LoadSafeImage(const char *filename) {
-    Image img = LoadImage(filename);
+    Image img = TracedLoadImage(filename);
     // if (img.width != 64 || img.height != 64) {
     //     TraceLog(LOG_WARNING, "Image %s is not 64x64: (%d x %d)", filename, img.width, img.height);
     // }
@@ -1128,30 +1319,33 @@ void PreLoadTexture(int cx, int cy)
     //char slopePath[256];
     //char slopeBigPath[256];
     char avgPath[64];
-    char avgBigPath[64];
-    char avgFullPath[64];
     char avgDamnPath[64];
     //snprintf(colorPath, sizeof(colorPath), "map/chunk_%02d_%02d/color.png", cx, cy);
     //snprintf(colorBigPath, sizeof(colorBigPath), "map/chunk_%02d_%02d/color_big.png", cx, cy);
     //snprintf(slopePath, sizeof(slopePath), "map/chunk_%02d_%02d/slope.png", cx, cy);
     //snprintf(slopeBigPath, sizeof(slopeBigPath), "map/chunk_%02d_%02d/slope_big.png", cx, cy);
     snprintf(avgPath, sizeof(avgPath), "map/chunk_%02d_%02d/avg.png", cx, cy);
-    snprintf(avgBigPath, sizeof(avgBigPath), "map/chunk_%02d_%02d/avg_big.png", cx, cy);
-    snprintf(avgFullPath, sizeof(avgFullPath), "map/chunk_%02d_%02d/avg_full.png", cx, cy);
     snprintf(avgDamnPath, sizeof(avgDamnPath), "map/chunk_%02d_%02d/avg_damn.png", cx, cy);
     // --- Load images and assign to model material ---
     TraceLog(LOG_INFO, "Loading image in worker thread: %s", avgPath);
     Image img = LoadSafeImage(avgPath); //using slope and color avg right now
-    Image imgBig = LoadSafeImage(avgBigPath);
-    Image imgFull = LoadSafeImage(avgFullPath);
     Image imgDamn = LoadSafeImage(avgDamnPath);
+    //mips are built here on the loader thread, the upload then sends the whole chain (no GenTextureMipmaps on the main thread)
+    //avg_full and avg_big are levels 1 and 2 of avg_damns chain (create exports them that way), so they are views into it,
+    //one decode and one downsample for all three, only damn and img own memory
+    ImageBuildMipChain(&img);
+    ImageBuildMipChain(&imgDamn);
     chunks[cx][cy].img_tex = img;
-    chunks[cx][cy].img_tex_big = imgBig;
-    chunks[cx][cy].img_tex_full = imgFull;
+    chunks[cx][cy].img_tex_big = MipChainView(imgDamn, 2);
+    chunks[cx][cy].img_tex_full = MipChainView(imgDamn, 1);
     chunks[cx][cy].img_tex_damn = imgDamn;
-    chunks[cx][cy].isTextureReady = true;
+    MemTrackImage(MEM_TEXTURES, img, 1);
+    MemTrackImage(MEM_TEXTURES, imgDamn, 1);
+    //isTextureReady is set by LoadChunk, together with isReady
 }
 
+#define CHUNK_PROPS_BYTES (sizeof(StaticGameObject) * MAX_PROPS_UPPER_BOUND)
+
 void LoadTreePositions(int cx, int cy)
 {
     char treePath[64];
@@ -1169,9 +1363,18 @@ void LoadTreePositions(int cx, int cy)
         fclose(fp);
         return;
     }
+    if (treeCount > MAX_PROPS_UPPER_BOUND) {
+        TraceLog(LOG_WARNING, "Too many trees in chunk (%d,%d), keeping %d of %d", cx, cy, MAX_PROPS_UPPER_BOUND, treeCount);
+        treeCount = MAX_PROPS_UPPER_BOUND;
+    }
 
     //Vector3 *treePositions = (Vector3 *)malloc(sizeof(Vector3) * (treeCount + 1));
-    StaticGameObject *treePositions = malloc(sizeof(StaticGameObject) * (MAX_PROPS_UPPER_BOUND));//some buffer for these, should never be above 512
+    StaticGameObject *treePositions = ArenaAlloc(&chunks[cx][cy].arena, CHUNK_PROPS_BYTES);//some buffer for these, should never be above 512
+    if (!treePositions) {
+        fclose(fp);
+        return;
+    }
+    MemTrackCpu(MEM_PROPS, CHUNK_PROPS_BYTES, 1);
     for (int i = 0; i < treeCount; i++) {
         float x, y, z;
         int type;
@@ -1193,23 +1396,26 @@ void LoadChunk(int cx, int cy)
     char objPath32[256];
     char objPath16[256];
     char objPath8[256];
-    snprintf(objPath, sizeof(objPath), "map/chunk_%02d_%02d/64.obj", cx, cy);
-    snprintf(objPath32, sizeof(objPath32), "map/chunk_%02d_%02d/32.obj", cx, cy);
-    snprintf(objPath16, sizeof(objPath16), "map/chunk_%02d_%02d/16.obj", cx, cy);
-    snprintf(objPath8, sizeof(objPath8), "map/chunk_%02d_%02d/8.obj", cx, cy);
+    snprintf(objPath, sizeof(objPath), "map/chunk_%02d_%02d/%d.%s", cx, cy, world.lods[0], world.meshFormat);
+    snprintf(objPath32, sizeof(objPath32), "map/chunk_%02d_%02d/%d.%s", cx, cy, world.lods[1], world.meshFormat);
+    snprintf(objPath16, sizeof(objPath16), "map/chunk_%02d_%02d/%d.%s", cx, cy, world.lods[2], world.meshFormat);
+    snprintf(objPath8, sizeof(objPath8), "map/chunk_%02d_%02d/%d.%s", cx, cy, world.lods[3], world.meshFormat);
     
     // --- Load 3D model from .obj file ---
     TraceLog(LOG_INFO, "Loading OBJ: %s", objPath);
-    Model model = LoadModel(objPath);
-    Model model32 = LoadModel(objPath32);
-    Model model16 = LoadModel(objPath16);
-    Model model8 = LoadModel(objPath8);
+    Model model = TracedLoadModel(objPath);
+    Model model32 = TracedLoadModel(objPath32);
+    Model model16 = TracedLoadModel(objPath16);
+    Model model8 = TracedLoadModel(objPath8);
 
     model.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = chunks[cx][cy].textureDamn;
     model32.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = chunks[cx][cy].textureFull;
     model16.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = chunks[cx][cy].textureBig;
     model8.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = chunks[cx][cy].texture;
 
+    // --- One reservation for the cpu side we allocate ourselves (props), the meshes and images stay with raylib ---
+    ArenaInit(&chunks[cx][cy].arena, ArenaAlignUp(CHUNK_PROPS_BYTES));
+
     // --- Position the model in world space ---
     float worldHalfSize = (CHUNK_COUNT * CHUNK_SIZE) / 2.0f;
     Vector3 position = (Vector3){
@@ -1226,29 +1432,73 @@ void LoadChunk(int cx, int cy)
     // --- Store the chunk data ---
     // Save CPU-side mesh before uploading
     //chunks[cx][cy].mesh = model.meshes[0];  // <- capture BEFORE LoadModelFromMesh
-    pthread_mutex_lock(&mutex);
+    MemTrackModelCpu(MEM_TERRAIN, model, 1);
+    MemTrackModelCpu(MEM_TERRAIN, model32, 1);
+    MemTrackModelCpu(MEM_TERRAIN, model16, 1);
+    MemTrackModelCpu(MEM_TERRAIN, model8, 1);
+    TraceMutexLock(&mutex, "LoadChunk");
     chunks[cx][cy].model = model;
     chunks[cx][cy].model32 = model32;
     chunks[cx][cy].model16 = model16;
     chunks[cx][cy].model8 = model8;
-    chunks[cx][cy].position = position;
-    chunks[cx][cy].center = center;
-    chunks[cx][cy].isReady = true;
-    chunks[cx][cy].lod = LOD_8;
+    chunkHot.position[ChunkId(cx, cy)] = position;
+    chunkHot.center[ChunkId(cx, cy)] = center;
+    chunkHot.isReady[ChunkId(cx, cy)] = true;
+    chunkHot.lod[ChunkId(cx, cy)] = LOD_8;
     //mark the chunk with identifiers
     chunks[cx][cy].cx = cx;
     chunks[cx][cy].cy = cy;
-    chunks[cx][cy].id = (cx*CHUNK_COUNT) + cy;
+    chunks[cx][cy].id = ChunkId(cx, cy);
     //load trees
     LoadTreePositions(cx, cy);
+    chunkHot.isTextureReady[ChunkId(cx, cy)] = true;
     pthread_mutex_unlock(&mutex);
     //report
     TraceLog(LOG_INFO, "Chunk [%02d, %02d] loaded at position (%.1f, %.1f, %.1f)", 
              cx, cy, position.x, position.y, position.z);
 }
 
+// Evict a chunk: gpu buffers and textures, the meshes and model shells, the images, then the props arena
+void UnloadChunk(int cx, int cy)
+{
+    Chunk *c = &chunks[cx][cy];
+    int id = ChunkId(cx, cy);
+    Model *lods[4] = { &c->model, &c->model32, &c->model16, &c->model8 };
+    for (int i = 0; i < 4; i++) {
+        if (lods[i]->meshCount <= 0) continue;
+        MemTrackModelCpu(MEM_TERRAIN, *lods[i], -1);
+        if (chunkHot.isLoaded[id]) MemTrackGpu(MEM_TERRAIN, -(int64_t)ModelGpuBytes(*lods[i]), -1);
+        for (int m = 0; m < lods[i]->meshCount; m++) UnloadMesh(lods[i]->meshes[m]); //gpu side, vboId and the cpu arrays
+        FreeModelShell(*lods[i]);
+        memset(lods[i], 0, sizeof(Model));
+    }
+    if (chunkHot.isTextureLoaded[id]) {
+        MemTrackTexture(MEM_TEXTURES, c->texture, -1);
+        MemTrackTexture(MEM_TEXTURES, c->textureBig, -1);
+        MemTrackTexture(MEM_TEXTURES, c->textureFull, -1);
+        MemTrackTexture(MEM_TEXTURES, c->textureDamn, -1);
+        UnloadTexture(c->texture);
+        UnloadTexture(c->textureBig);
+        UnloadTexture(c->textureFull);
+        UnloadTexture(c->textureDamn);
+    }
+    MemTrackImage(MEM_TEXTURES, c->img_tex, -1);
+    MemTrackImage(MEM_TEXTURES, c->img_tex_damn, -1);
+    UnloadImage(c->img_tex);
+    UnloadImage(c->img_tex_damn); //big and full are views into its chain
+    c->img_tex = c->img_tex_big = c->img_tex_full = c->img_tex_damn = (Image){ 0 };
+    if (c->props) MemTrackCpu(MEM_PROPS, -(int64_t)CHUNK_PROPS_BYTES, -1);
+    c->props = NULL;
+    c->treeCount = 0;
+    ArenaFree(&c->arena);
+    chunkHot.isLoaded[id] = false;
+    chunkHot.isReady[id] = false;
+    chunkHot.isTextureReady[id] = false;
+    chunkHot.isTextureLoaded[id] = false;
+}
 
 void *ChunkLoaderThread(void *arg) {
+    TraceThreadName("loader");
     bool haveManifest = false;
     FILE *f = fopen("map/manifest.txt", "r"); // Open for append
     if (f != NULL) {
@@ -1270,9 +1520,13 @@ void *ChunkLoaderThread(void *arg) {
                 manifestTileCount = 2048; //fall back for the load bar, we dont know so guess and hope its close
                 DocumentTiles(cx,cy);
             }
-            if (!chunks[cx][cy].isLoaded) {
+            if (!chunkHot.isLoaded[ChunkId(cx, cy)]) {
+                TraceBegin("PreLoadTexture", "loader");
                 PreLoadTexture(cx, cy);
+                TraceEnd("PreLoadTexture", "loader");
+                TraceBegin("LoadChunk", "loader");
                 LoadChunk(cx, cy);
+                TraceEnd("LoadChunk", "loader");
             }
         }
     }
@@ -1286,14 +1540,84 @@ void StartChunkLoader() {
     pthread_detach(thread);
 }
 
-int main(void) {
+//used when --bench is given without a script, walks, dashes, flies over and hops chunks, then does some of it again at night
+void BuildDefaultBenchScript(char *buf, size_t size)
+{
+    snprintf(buf, size,
+        "walk 600 -16 6\n"
+        "look 90 -5 1\n"
+        "walk 600 900 6\n"
+        "dash %.4f\ndash %.4f\ndash %.4f\n"
+        "dash %.4f\ndash %.4f\n"
+        "look 200 -15 2\n"
+        "fly 3500 1400 3500 8\n"
+        "fly -4000 1600 2500 8\n"
+        "fly -4000 1600 -4000 8\n"
+        "chunk 3 3\nwalk -4500 -4200 5\n"
+        "chunk 12 12\nwalk 4800 4900 5\n"
+        "chunk 7 7\n"
+        "night\nwait 2\n"
+        "walk 900 900 6\n"
+        "dash %.4f\ndash %.4f\n"
+        "look 0 10 2\n"
+        "day\nwait 2\n",
+        GOKU_DASH_DIST, GOKU_DASH_DIST, GOKU_DASH_DIST,
+        GOKU_DASH_DIST_SHORT, GOKU_DASH_DIST_SHORT,
+        GOKU_DASH_DIST, GOKU_DASH_DIST_SHORT);
+}
+
+int main(int argc, char **argv) {
+    //----------------------bench args---------------------
+    //play --bench [script.txt] [--bench-out report.json] [--trace [trace.json]]
+    const char *traceOut = NULL;
+    TraceThreadName("main");
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--bench") == 0)
+        {
+            benchRun.active = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+            {
+                if (!BenchLoadScript(&benchRun, argv[++i])) {return -666;}
+            }
+        }
+        else if (strcmp(argv[i], "--bench-out") == 0 && i + 1 < argc)
+        {
+            snprintf(benchRun.outPath, sizeof(benchRun.outPath), "%s", argv[++i]);
+        }
+        else if (strcmp(argv[i], "--trace") == 0)
+        {
+            traceOut = (i + 1 < argc && argv[i + 1][0] != '-') ? argv[++i] : "play_trace.json";
+            TraceStart(); //from the very start so the loader thread is in it
+        }
+        else
+        {
+            TraceLog(LOG_WARNING, "unknown argument %s", argv[i]);
+        }
+    }
+    if (benchRun.active && benchRun.cmdCount == 0)
+    {
+        char script[2048];
+        BuildDefaultBenchScript(script, sizeof(script));
+        BenchParseScript(&benchRun, script);
+        snprintf(benchRun.scriptName, sizeof(benchRun.scriptName), "default");
+    }
+    if (benchRun.active && benchRun.outPath[0] == '\0') {snprintf(benchRun.outPath, sizeof(benchRun.outPath), "bench.json");}
+    bool benchGround = true;
     bool displayBoxes = false;
     bool displayLod = false;
     LightningBug *bugs;
-    Star *stars;
+    unsigned int starInstancesVbo = 0;
     //----------------------init chunks---------------------
+    if (!WorldLoad(WORLD_PATH)) {return 1;} //grid size comes from the map create wrote
+    if (!ChunkHotAlloc()) {
+        TraceLog(LOG_ERROR, "Failed to allocate chunk state");
+        exit(1);
+    }
     chunks = malloc(sizeof(Chunk *) * CHUNK_COUNT);
     for (int i = 0; i < CHUNK_COUNT; i++) chunks[i] = calloc(CHUNK_COUNT, sizeof(Chunk));
+    chosenX = chosenY = CHUNK_COUNT / 2;
+    closestCX = closestCY = CHUNK_COUNT / 2;
     if (!chunks) {
         TraceLog(LOG_ERROR, "Failed to allocate chunk row pointers");
         exit(1);
@@ -1309,12 +1633,12 @@ int main(void) {
         // Optional: clear/init each chunk
         for (int y = 0; y < CHUNK_COUNT; y++) {
             memset(&chunks[x][y], 0, sizeof(Chunk));
-            chunks[x][y].water = NULL;chunks[x][y].waterCount = 0;//make sure water is ready to be checked and then instantiated
+            chunkHot.hasWater[ChunkId(x, y)] = false;chunkHot.hasWaterFar[ChunkId(x, y)] = false;chunks[x][y].waterPatchCount = 0;//make sure water is ready to be checked and then instantiated
         }
     }
     //----------------------DONE -> init chunks---------------------
     //-----INIT TILES
-    int maxTiles = ((CHUNK_COUNT * CHUNK_COUNT) * (TILE_GRID_SIZE * TILE_GRID_SIZE));  // = 16,384
+    int maxTiles = ((CHUNK_COUNT * CHUNK_COUNT) * (TILE_GRID_SIZE * TILE_GRID_SIZE));  // = 16,384 for the default world
     foundTiles = malloc(sizeof(TileEntry) * maxTiles);
     foundTileCount = 0;
 
@@ -1325,8 +1649,15 @@ int main(void) {
     //---------------RAYLIB INIT STUFF---------------------------------------
     InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "Map Preview with Trees & Grass");
     InitAudioDevice();
-    DisableCursor();
+    if (!benchRun.active) {DisableCursor();} //a bench leaves the mouse alone, only the script moves the camera
     SetTargetFPS(60);
+    if (benchRun.active)
+    {
+        SetTargetFPS(0); //measure the real frame time, the path runs on a fixed step anyway
+        SetRandomSeed(BENCH_SEED);
+        srand(BENCH_SEED);
+        benchRun.loadStartMs = ProfNowMs();
+    }
 
     //shaders  
         // - 
@@ -1336,8 +1667,6 @@ int main(void) {
     // SetShaderValue(heightShader, GetShaderLocation(heightShader, "slopeStrength"), &strength, SHADER_UNIFORM_FLOAT);
         // - 
     Shader heightShaderLight = LoadShader("shaders/120/height_color_lighting.vs", "shaders/120/height_color_lighting.fs");
-    int mvpLocLight = GetShaderLocation(heightShaderLight, "mvp");
-    int modelLocLight = GetShaderLocation(heightShaderLight, "model");
     float strengthLight = 0.25f;
     SetShaderValue(heightShaderLight, GetShaderLocation(heightShaderLight, "slopeStrength"), &strengthLight, SHADER_UNIFORM_FLOAT);
     // Set standard locations
@@ -1347,10 +1676,20 @@ int main(void) {
     Vector3 lightDir = (Vector3){ -10.2f, -100.0f, -10.3f };
     int lightDirLoc = GetShaderLocation(heightShaderLight, "lightDir");
     SetShaderValue(heightShaderLight, lightDirLoc, &lightDir, SHADER_UNIFORM_VEC3);
+    int cameraPosLocLight = GetShaderLocation(heightShaderLight, "cameraPosition");//once here, not per chunk per frame
         // - 
     Shader waterShader = LoadShader("shaders/120/water.vs", "shaders/120/water.fs");
     int timeLoc = GetShaderLocation(waterShader, "uTime");
     int offsetLoc = GetShaderLocation(waterShader, "worldOffset");
+    //water vertices are already in world space, so no per patch offset (it also made neighbor patches wave out of sync)
+    Vector2 waterOffset = (Vector2){ 0.0f, 0.0f };
+    SetShaderValue(waterShader, offsetLoc, &waterOffset, SHADER_UNIFORM_VEC2);
+    //waves fade out before the near/far switch, far water is big flat rects and has nothing to move
+    int waveCameraLoc = GetShaderLocation(waterShader, "waveCamera");
+    float waveFadeStart = WATER_WAVE_FADE_DIST;
+    float waveFadeEnd = WATER_NEAR_DIST;
+    SetShaderValue(waterShader, GetShaderLocation(waterShader, "waveFadeStart"), &waveFadeStart, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(waterShader, GetShaderLocation(waterShader, "waveFadeEnd"), &waveFadeEnd, SHADER_UNIFORM_FLOAT);
     //tree model
     Model treeCubeModel, treeModel, bgTreeModel, rockModel;
     Texture bgTreeTexture, rockTexture;
@@ -1400,6 +1739,12 @@ int main(void) {
     Light instanceLight = CreateLight(LIGHT_DIRECTIONAL, LightPosDraw, LightTargetDraw, lightColorDraw, instancingLightShader);
     //init the static game props stuff
     InitStaticGameProps(instancingLightShader);//get the high fi models ready
+    for (int i = 0; i < MODEL_TOTAL_COUNT; i++)
+    {
+        MemTrackModelCpu(MEM_INSTANCING, HighFiStaticObjectModels[i], 1);
+        MemTrackGpu(MEM_INSTANCING, (int64_t)ModelGpuBytes(HighFiStaticObjectModels[i]), 1);
+    }
+    MemTrackCpu(MEM_INSTANCING, sizeof(HighFiTransforms), 1);
     //END -- lighting shader---------------------------------------------------------------------------------------
     //START -- lightning bug shader :)---------------------------------------------------------------------------------------
     // Load PBR shader and setup all required locations
@@ -1497,12 +1842,14 @@ int main(void) {
             1.0f
         };
     }
-    float instanceIDs[STAR_COUNT];
-    for (int i = 0; i < STAR_COUNT; i++) {
-        instanceIDs[i] = (float)i;
-    }
-    int idAttribLoc = GetShaderLocationAttrib(starShader, "instanceID");
-    SetShaderValueV(starShader, idAttribLoc, instanceIDs, SHADER_ATTRIB_FLOAT, STAR_COUNT);
+    int timeStarLoc = GetShaderLocation(starShader, "u_time");
+    int timeBugLoc = GetShaderLocation(lightningBugShader, "u_time");
+    int blinkBugAttribLoc = GetShaderLocationAttrib(lightningBugShader, "instanceBlink");
+    //draw queue, terrain/tiles/props/water get sorted so state only changes between groups
+    RenderQueue renderQueue;
+    if (!RenderQueueInit(&renderQueue, 1024)) { return -666; }
+    int propCounter[MODEL_TOTAL_COUNT] = {0};
+    bool propOverflowLogged = false; //HighFiTransforms is fixed size, say so once instead of every frame
 
     //END -- lighting bug shader---------AND STARS!------------------------------------------------------------------------------
     //skybox stuff
@@ -1525,15 +1872,15 @@ int main(void) {
     skyboxPanelUpModel.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = skyTexUp;
     // for (int cy = 0; cy < CHUNK_COUNT; cy++) {
     //     for (int cx = 0; cx < CHUNK_COUNT; cx++) {
-    //         if (!chunks[cx][cy].isLoaded && !chunks[cx][cy].isReady) {
+    //         if (!chunkHot.isLoaded[ChunkId(cx, cy)] && !chunkHot.isReady[ChunkId(cx, cy)]) {
     //             //PreLoadTexture(cx, cy);
     //             //LoadChunk(cx, cy);
     //         }
     //     }
     // }
     
-    //lets get the water
-    FILE *f = fopen("map/water_manifest.txt", "r"); // Open for append
+    //lets get the water, world bodies first, the per chunk manifest is for maps exported before bodies existed
+    FILE *f = OpenWaterBodies(waterShader) ? NULL : fopen("map/water_manifest.txt", "r");
     if (f != NULL) {
         //need to count the lines in the file and then set manifestTileCount
         int lines = 0;
@@ -1570,6 +1917,15 @@ int main(void) {
         float time = GetTime();
         SetShaderValue(waterShader, timeLoc, &time, SHADER_UNIFORM_FLOAT);
         bool reportOn = false;
+        if (benchRun.active && onLoad && !benchRun.running && !benchRun.done)
+        {
+            benchRun.running = true;
+            benchRun.loadSeconds = (float)((ProfNowMs() - benchRun.loadStartMs) / 1000.0);
+            benchRun.uploadsAtStart = benchRun.uploads;
+            benchRun.peakGpuBytes = (size_t)memTracker.gpuTotal;
+            TraceLog(LOG_INFO, "BENCH: loaded in %.2f s, running %d commands", benchRun.loadSeconds, benchRun.cmdCount);
+        }
+        int benchUploadsBefore = BenchUploadTotal(benchRun.uploads);
         int tileTriCount = 0;
         int tileBcCount = 0;
         int treeTriCount = 0;
@@ -1578,17 +1934,16 @@ int main(void) {
         int chunkBcCount = 0;
         int totalTriCount = 0;
         int totalBcCount = 0;
-        float dt = GetFrameTime();
+        float dt = benchRun.running ? BENCH_DT : GetFrameTime();
         //idk, for pbr;
         float cameraPosVecF[3] = {camera.position.x, camera.position.y, camera.position.z};
         SetShaderValue(lightningBugShader, lightningBugShader.locs[SHADER_LOC_VECTOR_VIEW], cameraPosVecF, SHADER_UNIFORM_VEC3);
         SetShaderValue(starShader, starShader.locs[SHADER_LOC_VECTOR_VIEW], cameraPosVecF, SHADER_UNIFORM_VEC3);
         //main thread of the file management system, needed for GPU operations
+        ProfBegin(PROF_UPLOAD);
         if(wasTilesDocumented)
         {
             int gx, gy;
-            float time = GetTime(); // or your own time tracker
-            SetShaderValue(starShader, GetShaderLocation(starShader, "u_time"), &time, SHADER_UNIFORM_FLOAT);
             GetGlobalTileCoords(camera.position, &gx, &gy);
             int playerTileX  = gx % TILE_GRID_SIZE;
             int playerTileY  = gy % TILE_GRID_SIZE;
@@ -1598,113 +1953,136 @@ int main(void) {
                 // int dx = abs(playerTileX - foundTiles[te].tx);
                 // int dy = abs(playerTileY - foundTiles[te].ty);
                 // bool withinRange = dx <= TILE_GPU_UPLOAD_GRID_DIST && dy <= TILE_GPU_UPLOAD_GRID_DIST;
-                // bool maybeNeeded = (chunks[foundTiles[te].cx][foundTiles[te].cy].lod == LOD_64) && (withinRange || defNeeded);
-                bool maybeNeeded = (chunks[foundTiles[te].cx][foundTiles[te].cy].lod == LOD_64); //todo: testing this to see if it is my issue
+                // bool maybeNeeded = (chunkHot.lod[ChunkId(foundTiles[te].cx, foundTiles[te].cy)] == LOD_64) && (withinRange || defNeeded);
+                bool maybeNeeded = (chunkHot.lod[ChunkId(foundTiles[te].cx, foundTiles[te].cy)] == LOD_64); //todo: testing this to see if it is my issue
                 //if you find this direct method has too many tiles with too much stuff, then go back to the other version commented out above
                 //that version will really cut down VRAM footprint,but medium-distant objects might start to disappear and then appear again as you get closer and closer
                 if(foundTiles[te].isReady && !foundTiles[te].isLoaded && maybeNeeded)
                 {
                     TraceLog(LOG_INFO, "loading tiles: %d", te);
-                    pthread_mutex_lock(&mutex);
+                    TraceMutexLock(&mutex, "tile upload");
                     // Upload meshes to GPU
-                    UploadMesh(&foundTiles[te].model.meshes[0], false);
+                    TracedUploadMesh(&foundTiles[te].model.meshes[0], false);
                     
                     // Load GPU models
-                    foundTiles[te].model = LoadModelFromMesh(foundTiles[te].model.meshes[0]);
+                    MemTrackMeshGpu(MEM_TILES, foundTiles[te].model.meshes[0], 1);
+                    Model oldTile = foundTiles[te].model;
+                    foundTiles[te].model = LoadModelFromMesh(oldTile.meshes[0]);
+                    FreeModelShell(oldTile); //LoadModelFromMesh made a new one, this used to leak every re-upload
                     foundTiles[te].box = GetModelBoundingBox(foundTiles[te].model);
                     // Apply textures
                     foundTiles[te].model.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = foundTiles[te].type==MODEL_TREE?bgTreeTexture:rockTexture;
                     //mark work done
                     foundTiles[te].isLoaded = true;
+                    benchRun.uploads.tiles++;
                     //and now its safe to unlock
                     pthread_mutex_unlock(&mutex);
                 }
                 else if(foundTiles[te].isLoaded && !maybeNeeded)
                 {
-                    pthread_mutex_lock(&mutex);
+                    TraceMutexLock(&mutex, "tile unload");
+                    MemTrackMeshGpu(MEM_TILES, foundTiles[te].model.meshes[0], -1);
                     UnloadMeshGPU(&foundTiles[te].model.meshes[0]);
                     foundTiles[te].isLoaded = false;
+                    benchRun.uploads.tileUnloads++;
                     pthread_mutex_unlock(&mutex);
                 }
             }
         }
-        for (int cy = 0; cy < CHUNK_COUNT; cy++) {
-            for (int cx = 0; cx < CHUNK_COUNT; cx++) {
-                if(chunks[cx][cy].isTextureReady && !chunks[cx][cy].isTextureLoaded)
-                {
-                    pthread_mutex_lock(&mutex);
-                    TraceLog(LOG_INFO, "loading chunk textures: %d,%d", cx, cy);
-                    Texture2D texture = LoadTextureFromImage(chunks[cx][cy].img_tex); //using slope and color avg right now
-                    Texture2D textureBig = LoadTextureFromImage(chunks[cx][cy].img_tex_big);
-                    Texture2D textureFull = LoadTextureFromImage(chunks[cx][cy].img_tex_full);
-                    Texture2D textureDamn = LoadTextureFromImage(chunks[cx][cy].img_tex_damn);
-                    SetTextureWrap(texture, TEXTURE_WRAP_CLAMP);
-                    SetTextureWrap(textureBig, TEXTURE_WRAP_CLAMP);
-                    SetTextureWrap(textureFull, TEXTURE_WRAP_CLAMP);
-                    SetTextureWrap(textureDamn, TEXTURE_WRAP_CLAMP);
-                    GenTextureMipmaps(&textureFull);  // <-- this generates mipmaps
-                    SetTextureFilter(textureFull, TEXTURE_FILTER_TRILINEAR); // use a better filter
-                    GenTextureMipmaps(&textureBig);  // <-- this generates mipmaps
-                    SetTextureFilter(textureBig, TEXTURE_FILTER_TRILINEAR); // use a better filter
-                    GenTextureMipmaps(&texture);  // <-- this generates mipmaps
-                    SetTextureFilter(texture, TEXTURE_FILTER_TRILINEAR); // use a better filter
-                    GenTextureMipmaps(&textureDamn);  // <-- this generates mipmaps
-                    SetTextureFilter(textureDamn, TEXTURE_FILTER_TRILINEAR); // use a better filter
-                    chunks[cx][cy].texture = texture;  // Copy contents
-                    chunks[cx][cy].textureBig = textureBig;
-                    chunks[cx][cy].textureFull = textureFull;
-                    chunks[cx][cy].textureDamn = textureDamn;
-                    chunks[cx][cy].isTextureLoaded = true;
-                    pthread_mutex_unlock(&mutex);
-                }
-                else if (chunks[cx][cy].isTextureLoaded && chunks[cx][cy].isReady && !chunks[cx][cy].isLoaded) {
-                    pthread_mutex_lock(&mutex);
-                    TraceLog(LOG_INFO, "loading chunk model: %d,%d", cx, cy);
-
-                    // Upload meshes to GPU
-                    UploadMesh(&chunks[cx][cy].model.meshes[0], false);
-                    UploadMesh(&chunks[cx][cy].model32.meshes[0], false);
-                    UploadMesh(&chunks[cx][cy].model16.meshes[0], false);
-                    UploadMesh(&chunks[cx][cy].model8.meshes[0], false);
-
-                    // Load GPU models
-                    chunks[cx][cy].model = LoadModelFromMesh(chunks[cx][cy].model.meshes[0]);
-                    chunks[cx][cy].model32 = LoadModelFromMesh(chunks[cx][cy].model32.meshes[0]);
-                    chunks[cx][cy].model16 = LoadModelFromMesh(chunks[cx][cy].model16.meshes[0]);
-                    chunks[cx][cy].model8 = LoadModelFromMesh(chunks[cx][cy].model8.meshes[0]);
-
-                    //apply transform to vertices based on world position -- and of course it does not work because we are using a custom shader now
-                    // chunks[cx][cy].model.transform = MatrixTranslate(chunks[cx][cy].position.x, chunks[cx][cy].position.y, chunks[cx][cy].position.z);
-                    // chunks[cx][cy].model32.transform = MatrixTranslate(chunks[cx][cy].position.x, chunks[cx][cy].position.y, chunks[cx][cy].position.z);
-                    // chunks[cx][cy].model16.transform = MatrixTranslate(chunks[cx][cy].position.x, chunks[cx][cy].position.y, chunks[cx][cy].position.z);
-                    // chunks[cx][cy].model.transform = MatrixTranslate(chunks[cx][cy].position.x, chunks[cx][cy].position.y, chunks[cx][cy].position.z);
-                    //apply shader to 64 chunk
-                    chunks[cx][cy].model.materials[0].shader = heightShaderLight;
-                    chunks[cx][cy].model32.materials[0].shader = heightShaderLight;//only do this for reltively close things, not 8 and 16
-                    // Apply textures
-                    chunks[cx][cy].model.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = chunks[cx][cy].textureDamn;
-                    chunks[cx][cy].model32.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = chunks[cx][cy].textureFull;
-                    chunks[cx][cy].model16.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = chunks[cx][cy].textureBig;
-                    chunks[cx][cy].model8.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = chunks[cx][cy].texture;
-
-                    // Setup bounding box
-                    chunks[cx][cy].origBox = ScaleBoundingBox(GetModelBoundingBox(chunks[cx][cy].model), (Vector3){MAP_SCALE, MAP_SCALE, MAP_SCALE});
-                    chunks[cx][cy].box = UpdateBoundingBox(chunks[cx][cy].origBox, chunks[cx][cy].center);
-
-                    chunks[cx][cy].isLoaded = true;
-                    TraceLog(LOG_INFO, "loaded chunk model -> %d,%d", cx, cy);
-                    pthread_mutex_unlock(&mutex);
-                }
+        for (int id = 0; id < CHUNK_TOTAL; id++) {
+            int cx = id / CHUNK_COUNT;
+            int cy = id % CHUNK_COUNT;
+            if(chunkHot.isTextureReady[id] && !chunkHot.isTextureLoaded[id])
+            {
+                TraceMutexLock(&mutex, "chunk textures");
+                TraceLog(LOG_INFO, "loading chunk textures: %d,%d", cx, cy);
+                Texture2D texture = TracedLoadTextureFromImage(chunks[cx][cy].img_tex); //using slope and color avg right now
+                Texture2D textureBig = TracedLoadTextureFromImage(chunks[cx][cy].img_tex_big);
+                Texture2D textureFull = TracedLoadTextureFromImage(chunks[cx][cy].img_tex_full);
+                Texture2D textureDamn = TracedLoadTextureFromImage(chunks[cx][cy].img_tex_damn);
+                SetTextureWrap(texture, TEXTURE_WRAP_CLAMP);
+                SetTextureWrap(textureBig, TEXTURE_WRAP_CLAMP);
+                SetTextureWrap(textureFull, TEXTURE_WRAP_CLAMP);
+                SetTextureWrap(textureDamn, TEXTURE_WRAP_CLAMP);
+                //the images carry their mip chains (ImageBuildMipChain in the loader), so trilinear works straight away
+                SetTextureFilter(textureFull, TEXTURE_FILTER_TRILINEAR); // use a better filter
+                SetTextureFilter(textureBig, TEXTURE_FILTER_TRILINEAR); // use a better filter
+                SetTextureFilter(texture, TEXTURE_FILTER_TRILINEAR); // use a better filter
+                SetTextureFilter(textureDamn, TEXTURE_FILTER_TRILINEAR); // use a better filter
+                chunks[cx][cy].texture = texture;  // Copy contents
+                chunks[cx][cy].textureBig = textureBig;
+                chunks[cx][cy].textureFull = textureFull;
+                chunks[cx][cy].textureDamn = textureDamn;
+                chunkHot.isTextureLoaded[id] = true;
+                MemTrackTexture(MEM_TEXTURES, texture, 1);
+                MemTrackTexture(MEM_TEXTURES, textureBig, 1);
+                MemTrackTexture(MEM_TEXTURES, textureFull, 1);
+                MemTrackTexture(MEM_TEXTURES, textureDamn, 1);
+                benchRun.uploads.chunkTextures++;
+                pthread_mutex_unlock(&mutex);
+            }
+            else if (chunkHot.isTextureLoaded[id] && chunkHot.isReady[id] && !chunkHot.isLoaded[id]) {
+                TraceMutexLock(&mutex, "chunk model");
+                TraceLog(LOG_INFO, "loading chunk model: %d,%d", cx, cy);
+
+                // Upload meshes to GPU
+                TracedUploadMesh(&chunks[cx][cy].model.meshes[0], false);
+                TracedUploadMesh(&chunks[cx][cy].model32.meshes[0], false);
+                TracedUploadMesh(&chunks[cx][cy].model16.meshes[0], false);
+                TracedUploadMesh(&chunks[cx][cy].model8.meshes[0], false);
+
+                MemTrackMeshGpu(MEM_TERRAIN, chunks[cx][cy].model.meshes[0], 1);
+                MemTrackMeshGpu(MEM_TERRAIN, chunks[cx][cy].model32.meshes[0], 1);
+                MemTrackMeshGpu(MEM_TERRAIN, chunks[cx][cy].model16.meshes[0], 1);
+                MemTrackMeshGpu(MEM_TERRAIN, chunks[cx][cy].model8.meshes[0], 1);
+
+                // Load GPU models
+                Model oldLods[4] = { chunks[cx][cy].model, chunks[cx][cy].model32, chunks[cx][cy].model16, chunks[cx][cy].model8 };
+                chunks[cx][cy].model = LoadModelFromMesh(chunks[cx][cy].model.meshes[0]);
+                chunks[cx][cy].model32 = LoadModelFromMesh(chunks[cx][cy].model32.meshes[0]);
+                chunks[cx][cy].model16 = LoadModelFromMesh(chunks[cx][cy].model16.meshes[0]);
+                chunks[cx][cy].model8 = LoadModelFromMesh(chunks[cx][cy].model8.meshes[0]);
+                for (int i = 0; i < 4; i++) {FreeModelShell(oldLods[i]);}
+
+                //apply transform to vertices based on world position -- and of course it does not work because we are using a custom shader now
+                // chunks[cx][cy].model.transform = MatrixTranslate(chunkHot.position[id].x, chunkHot.position[id].y, chunkHot.position[id].z);
+                // chunks[cx][cy].model32.transform = MatrixTranslate(chunkHot.position[id].x, chunkHot.position[id].y, chunkHot.position[id].z);
+                // chunks[cx][cy].model16.transform = MatrixTranslate(chunkHot.position[id].x, chunkHot.position[id].y, chunkHot.position[id].z);
+                // chunks[cx][cy].model.transform = MatrixTranslate(chunkHot.position[id].x, chunkHot.position[id].y, chunkHot.position[id].z);
+                //apply shader to 64 chunk
+                chunks[cx][cy].model.materials[0].shader = heightShaderLight;
+                chunks[cx][cy].model32.materials[0].shader = heightShaderLight;//only do this for reltively close things, not 8 and 16
+                // Apply textures
+                chunks[cx][cy].model.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = chunks[cx][cy].textureDamn;
+                chunks[cx][cy].model32.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = chunks[cx][cy].textureFull;
+                chunks[cx][cy].model16.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = chunks[cx][cy].textureBig;
+                chunks[cx][cy].model8.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = chunks[cx][cy].texture;
+
+                // Setup bounding box
+                chunks[cx][cy].origBox = ScaleBoundingBox(GetModelBoundingBox(chunks[cx][cy].model), (Vector3){MAP_SCALE, MAP_SCALE, MAP_SCALE});
+                chunkHot.box[id] = UpdateBoundingBox(chunks[cx][cy].origBox, chunkHot.center[id]);
+
+                chunkHot.isLoaded[id] = true;
+                benchRun.uploads.chunkModels++;
+                TraceLog(LOG_INFO, "loaded chunk model -> %d,%d", cx, cy);
+                pthread_mutex_unlock(&mutex);
             }
         }
 
-        FindClosestChunkAndAssignLod(&camera); //Im not sure If I need this here, but things work okay so...?
+        ProfEnd(PROF_UPLOAD);
 
-        // Mouse look
-        Vector2 mouse = GetMouseDelta();
-        yaw -= mouse.x * 0.003f;
-        pitch -= mouse.y * 0.003f;
-        pitch = Clamp(pitch, -PI/2.0f, PI/2.0f);
+        ProfBegin(PROF_LOD);
+        FindClosestChunkAndAssignLod(&camera); //Im not sure If I need this here, but things work okay so...?
+        ProfEnd(PROF_LOD);
+
+        ProfBegin(PROF_INPUT);
+        // Mouse look, not during a bench (the path starts from yaw/pitch, a stray mouse move would change the run)
+        if (!benchRun.active) {
+            Vector2 mouse = GetMouseDelta();
+            yaw -= mouse.x * 0.003f;
+            pitch -= mouse.y * 0.003f;
+            pitch = Clamp(pitch, -PI/2.0f, PI/2.0f);
+        }
 
         Vector3 forward = {
             cosf(pitch) * cosf(yaw) * MAP_SCALE,
@@ -1714,7 +2092,7 @@ int main(void) {
         Vector3 right = Vector3Normalize(Vector3CrossProduct(forward, camera.up));
 
         Vector3 move = { 0 };
-        if (IsKeyDown(KEY_T)) 
+        if (!benchRun.active && IsKeyDown(KEY_T)) 
         {
             if (onLoad && !FindNextTreeInChunk(&camera, closestCX, closestCY, 15.0f, MODEL_TREE)) {
                 TraceLog(LOG_INFO, "No suitable tree found in current chunk.");
@@ -1724,7 +2102,7 @@ int main(void) {
                 }
             }
         }
-        if (IsKeyDown(KEY_R)) 
+        if (!benchRun.active && IsKeyDown(KEY_R)) 
         {
             if (onLoad && !FindNextTreeInChunk(&camera, closestCX, closestCY, 15.0f, MODEL_ROCK)) {
                 TraceLog(LOG_INFO, "No suitable rock found in current chunk.");
@@ -1746,9 +2124,14 @@ int main(void) {
         if (IsKeyDown(KEY_L)) {displayLod = !displayLod;}
         if (IsKeyDown(KEY_F12)) {TakeScreenshotWithTimestamp();}
         if (IsKeyDown(KEY_F11)) {reportOn = true;}
-        if (IsKeyPressed(KEY_F10)) {MemoryReport();}
+        if (IsKeyPressed(KEY_F10)) {MemoryReport();MemTrackDumpCSVWithTimestamp();}
         if (IsKeyPressed(KEY_F9)) {GridChunkReport();}
         if (IsKeyPressed(KEY_F8)) {GridTileReport();}
+        if (IsKeyPressed(KEY_F7)) {frameProfiler.overlay = !frameProfiler.overlay;}
+        if (IsKeyPressed(KEY_F6)) {ProfDumpCSVWithTimestamp();}
+        if (IsKeyPressed(KEY_F5)) {BenchToggleRecording();}
+        if (IsKeyPressed(KEY_F3)) {memTracker.overlay = !memTracker.overlay;}
+        if (IsKeyPressed(KEY_F4)) {if (tracer.enabled) {if (traceOut) {TraceWrite(traceOut);} else {TraceWriteWithTimestamp();}} else {TraceStart();}}
         //if (IsKeyDown(KEY_M)) {DisableCursor();} //I forget the right way to do this ...
         if (IsKeyDown(KEY_PAGE_UP)) {chosenX = (chosenX+1)%CHUNK_COUNT;}
         if (IsKeyDown(KEY_PAGE_DOWN)) {chosenY = (chosenY+1)%CHUNK_COUNT;}
@@ -1759,7 +2142,7 @@ int main(void) {
         if (IsKeyDown(KEY_S)) move = Vector3Subtract(move, forward);
         if (IsKeyDown(KEY_D)) move = Vector3Add(move, right);
         if (IsKeyDown(KEY_A)) move = Vector3Subtract(move, right);
-        if (IsKeyDown(KEY_Z)) { dayTime=!dayTime;}
+        if (!benchRun.active && IsKeyDown(KEY_Z)) { dayTime=!dayTime;}
         if(IsKeyDown(KEY_F1))
         {
             for (int i = 0; i < MAX_LIGHTS; i++)
@@ -1769,7 +2152,7 @@ int main(void) {
         }
         if (IsKeyDown(KEY_LEFT_SHIFT)) move.y -= (1.0f * MAP_SCALE);
         if (IsKeyDown(KEY_SPACE)) move.y += (1.0f * MAP_SCALE);
-        if (IsKeyDown(KEY_ENTER)) {chunks[chosenX][chosenY].curTreeIdx=0;closestCX=chosenX;closestCY=chosenY;camera.position.x=chunks[closestCX][closestCY].center.x;camera.position.z=chunks[closestCX][closestCY].center.z;}
+        if (!benchRun.active && IsKeyDown(KEY_ENTER)) {chunks[chosenX][chosenY].curTreeIdx=0;closestCX=chosenX;closestCY=chosenY;camera.position.x=chunkHot.center[ChunkId(closestCX, closestCY)].x;camera.position.z=chunkHot.center[ChunkId(closestCX, closestCY)].z;}
 
         //fade to black, end scene...
         if (dayTime) {
@@ -1810,11 +2193,41 @@ int main(void) {
             }
             if(onLoad && !starGenHappened)
             {
-                stars = GenerateStars(STAR_COUNT);
+                Star *stars = GenerateStars(STAR_COUNT);
+                if (stars)
+                {
+                    starInstancesVbo = UploadStarField(stars, STAR_COUNT, sphereStarMesh, starShader);
+                    MemTrackFree(stars);
+                }
                 starGenHappened = true;
             }
         }
 
+        bool benchFinished = false;
+        if (benchRun.running)
+        {
+            //scripted camera, hands off the keyboard and mouse while it runs
+            move = (Vector3){ 0 };
+            BenchPose pose = { .pos = camera.position, .yaw = yaw, .pitch = pitch, .ground = benchGround };
+            if (!BenchStep(&benchRun, BENCH_DT, &pose))
+            {
+                benchFinished = true;
+            }
+            else if (pose.teleport && pose.cx >= 0 && pose.cy >= 0 && pose.cx < CHUNK_COUNT && pose.cy < CHUNK_COUNT)
+            {
+                chunks[pose.cx][pose.cy].curTreeIdx=0;closestCX=pose.cx;closestCY=pose.cy;camera.position.x=chunkHot.center[ChunkId(closestCX, closestCY)].x;camera.position.z=chunkHot.center[ChunkId(closestCX, closestCY)].z;
+            }
+            else
+            {
+                camera.position = pose.pos;
+            }
+            if (pose.setDay) {dayTime = pose.day;}
+            yaw = pose.yaw;
+            pitch = pose.pitch;
+            benchGround = pose.ground;
+            forward = (Vector3){ cosf(pitch) * cosf(yaw) * MAP_SCALE, sinf(pitch) * MAP_SCALE, cosf(pitch) * sinf(yaw) * MAP_SCALE };
+        }
+
         if (Vector3Length(move) > 0.01f) {
             move = Vector3Normalize(move);
             move = Vector3Scale(move, goku ? spd : spd * dt);
@@ -1822,8 +2235,12 @@ int main(void) {
         }
         camera.target = Vector3Add(camera.position, forward);
         skyCam.target = Vector3Add(skyCam.position, forward);
+        ProfEnd(PROF_INPUT);
+        ProfBegin(PROF_LOD);
         FindClosestChunkAndAssignLod(&camera);//this one is definetley needed
-        if(onLoad && camera.position.y > PLAYER_FLOAT_OFFSET)//he floats underwater
+        ProfEnd(PROF_LOD);
+        ProfBegin(PROF_INPUT);
+        if(onLoad && camera.position.y > PLAYER_FLOAT_OFFSET && (!benchRun.running || benchGround))//he floats underwater
         {
             if (closestCX < 0 || closestCY < 0 || closestCX >= CHUNK_COUNT || closestCY >= CHUNK_COUNT) {
                 // Outside world bounds
@@ -1831,15 +2248,18 @@ int main(void) {
             }
             else
             {
-                float groundY = GetTerrainHeightFromMeshXZ(chunks[closestCX][closestCY], camera.position.x, camera.position.z);
+                float groundY = GetTerrainHeightFromMeshXZ(closestCX, closestCY, camera.position.x, camera.position.z);
                 //TraceLog(LOG_INFO, "setting camera y: (%d,%d){%f,%f,%f}[%f]", closestCX, closestCY, camera.position.x, camera.position.y, camera.position.z, groundY);
                 if(groundY < -9000.0f){groundY=camera.position.y - PLAYER_HEIGHT;} // if we error, dont change y
                 camera.position.y = groundY + PLAYER_HEIGHT;  // e.g. +1.8f for standing
             }
         }
 
-        UpdateCamera(&camera, CAMERA_FIRST_PERSON);
-        UpdateCamera(&skyCam, CAMERA_FIRST_PERSON);
+        if (!benchRun.active) { //raylibs first person camera reads the keyboard and mouse itself
+            UpdateCamera(&camera, CAMERA_FIRST_PERSON);
+            UpdateCamera(&skyCam, CAMERA_FIRST_PERSON);
+        }
+        BenchRecordPose(camera.position, yaw, pitch);
 
         // Update the light shader with the camera view position
         SetShaderValue(lightningBugShader, lightningBugShader.locs[SHADER_LOC_VECTOR_VIEW], &camera.position, SHADER_UNIFORM_VEC3);
@@ -1853,10 +2273,12 @@ int main(void) {
             UpdateLightValues(lightningBugShader, lights[i]);//update
             UpdateLightValues(starShader, starLights[i]);//update
         }
+        ProfEnd(PROF_INPUT);
 
         BeginDrawing();
         ClearBackground(backGroundColor);
         //skybox separate scene
+        ProfBegin(PROF_SKYBOX);
         BeginMode3D(skyCam);
             if(true)
             {
@@ -1878,6 +2300,7 @@ int main(void) {
                 rlEnableDepthMask();
             }
         EndMode3D();
+        ProfEnd(PROF_SKYBOX);
         //regular scene of the map
         BeginMode3D(camera);
             if(onLoad){SetCustomCameraProjection(camera, 45.0f, (float)SCREEN_WIDTH/SCREEN_HEIGHT, 0.3f, 5000.0f);} // Near = 1, Far = 4000
@@ -1887,6 +2310,7 @@ int main(void) {
             int loadCnt = 0;
             //int loadTileCnt = 0; -- this one needs to be global so we can update it while loading tiles
             //get frustum
+            ProfBegin(PROF_CULL);
             Matrix view = MatrixLookAt(camera.position, camera.target, camera.up);
             Matrix proj = MatrixPerspective(DEG2RAD * camera.fovy, SCREEN_WIDTH / (float)SCREEN_HEIGHT, 0.1f, 2048.0f);
             Matrix projChunk8 = MatrixPerspective(DEG2RAD * camera.fovy, SCREEN_WIDTH / (float)SCREEN_HEIGHT, 0.1f, 16384.0f);//for far away chunks
@@ -1898,7 +2322,9 @@ int main(void) {
             GetGlobalTileCoords(camera.position, &gx, &gy);
             int playerTileX  = gx % TILE_GRID_SIZE;
             int playerTileY  = gy % TILE_GRID_SIZE;
+            ProfEnd(PROF_CULL);
             //lightning bugs
+            ProfBegin(PROF_NIGHT);
             if(!dayTime)
             {
                 //if doing reflectoinis, stuff like this ....
@@ -1933,7 +2359,6 @@ int main(void) {
                 if(onLoad) //fire flies
                 {
                     int bugsAdded = 0;
-                    int starsAdded = 0;
                     //- loop through all of the static props that are int he active active tile zone
                     Matrix transforms[BUG_COUNT] = {0};
                     float blinkValues[BUG_COUNT] = {0};
@@ -1956,11 +2381,9 @@ int main(void) {
                         bugsAdded++;
                     }   
                     // Before drawing:
-                    int blinkAttribLoc = GetShaderLocationAttrib(lightningBugShader, "instanceBlink");
-                    SetShaderValueV(lightningBugShader, blinkAttribLoc, blinkValues, SHADER_ATTRIB_FLOAT, bugsAdded);
+                    SetShaderValueV(lightningBugShader, blinkBugAttribLoc, blinkValues, SHADER_ATTRIB_FLOAT, bugsAdded);
                     float time = GetTime(); // Raylib built-in
-                    int timeLoc = GetShaderLocation(lightningBugShader, "u_time");
-                    SetShaderValue(lightningBugShader, timeLoc, &time, SHADER_UNIFORM_FLOAT);
+                    SetShaderValue(lightningBugShader, timeBugLoc, &time, SHADER_UNIFORM_FLOAT);
                     DrawMeshInstancedCustom(
                             sphereMesh, 
                             sphereMaterial, 
@@ -1968,211 +2391,183 @@ int main(void) {
                             bugsAdded
                     );//rpi5
                     //stars ** ** ** ** ** **** ** ** ** ** **** ** ** ** ** **** ** ** ** ** **** ** ** ** ** **
-                    Matrix starTransforms[STAR_COUNT] = {0};
-                    float starBlinkValues[STAR_COUNT] = {0};
-                    //UpdateStars(stars,STAR_COUNT);
-                    for (int i = 0; i < STAR_COUNT; i++)
-                    {
-                        //first update the bugs positions
-                        starBlinkValues[starsAdded] = stars[i].alpha;
-                        // //get ready to draw
-                        Vector3 __p = stars[i].pos;
-                        // Matrix translation = MatrixTranslate();
-                        // starTransforms[starsAdded] = translation;//MatrixMultiply(rotation, translation);//todo: add rotations and such
-                        
-                        Matrix mat = MatrixTranslate(__p.x, __p.y, __p.z);
-                        mat.m15 = (float)i;  // Encode instanceId into the matrix (row 3, column 1)
-                        starTransforms[i] = mat;
-                        starsAdded++;
-                    }   
-                    // Before drawing:
-                    int blinkStarAttribLoc = GetShaderLocationAttrib(starShader, "instanceBlink");
-                    SetShaderValueV(starShader, blinkStarAttribLoc, starBlinkValues, SHADER_ATTRIB_FLOAT, starsAdded);
                     float timeStar = GetTime(); // Raylib built-in
-                    int timeStarLoc = GetShaderLocation(starShader, "u_time");
                     SetShaderValue(starShader, timeStarLoc, &timeStar, SHADER_UNIFORM_FLOAT);
-                    DrawMeshInstancedCustom(
+                    DrawMeshInstancedStatic(
                             sphereStarMesh, 
                             sphereStarMaterial, 
-                            starTransforms, 
-                            starsAdded
-                    );//rpi5
+                            starInstancesVbo, 
+                            STAR_COUNT
+                    );//rpi5, no upload, the buffer has been on the gpu since the first night
                     //** ** ** ** ** **** ** ** ** ** **** ** ** ** ** **** ** ** ** ** **** ** ** ** ** **
                 }
             }
+            ProfEnd(PROF_NIGHT);
+            //everything below is queued, then sorted and drawn in one go at the end
+            ProfBegin(PROF_CULL);
+            RenderQueueBegin(&renderQueue, camera.position);
+            for(int mt=0; mt<MODEL_TOTAL_COUNT; mt++){propCounter[mt]=0;}
             for(int te = 0; te < foundTileCount; te++)
             {
                 if(!foundTiles[te].isReady){loadedEemTiles=false;continue;}//complete RAM state needs to control if we show the loading bar
                 if(!foundTiles[te].isLoaded){continue;}
                 //TraceLog(LOG_INFO, "TEST - Maybe - Drawing tile model: chunk %02d_%02d, tile %02d_%02d", foundTiles[te].cx, foundTiles[te].cy, foundTiles[te].tx, foundTiles[te].ty);
-                if(chunks[foundTiles[te].cx][foundTiles[te].cy].lod == LOD_64 //this one first because its quick, although it might get removed later
+                if(chunkHot.lod[ChunkId(foundTiles[te].cx, foundTiles[te].cy)] == LOD_64 //this one first because its quick, although it might get removed later
                     && (!IsTileActive(foundTiles[te].cx,foundTiles[te].cy,foundTiles[te].tx,foundTiles[te].ty, closestCX, closestCY, playerTileX, playerTileY) || USE_TILES_ONLY) 
                     && IsBoxInFrustum(foundTiles[te].box , frustumChunk8))
                 {
                     if(reportOn){tileBcCount++;tileTriCount+=foundTiles[te].model.meshes[0].triangleCount;};
-                    DrawModel(foundTiles[te].model, (Vector3){0,0,0}, 1.0f, lightTileColor);
+                    Vector3 tileCenter = Vector3Scale(Vector3Add(foundTiles[te].box.min, foundTiles[te].box.max), 0.5f);
+                    RenderQueuePushModel(&renderQueue, RQ_PASS_TILES, &foundTiles[te].model, (Vector3){0,0,0}, 1.0f, lightTileColor, tileCenter);
                     //TraceLog(LOG_INFO, "TEST Drawing tile model: chunk %02d_%02d, tile %02d_%02d", foundTiles[te].cx, foundTiles[te].cy, foundTiles[te].tx, foundTiles[te].ty);
                     if(displayBoxes){DrawBoundingBox(foundTiles[te].box,RED);}
                 }
             }
-            for (int cy = 0; cy < CHUNK_COUNT; cy++) {
-                for (int cx = 0; cx < CHUNK_COUNT; cx++) {
-                    if(chunks[cx][cy].isLoaded)
+            //water gets nudged toward the player, same for every patch so do it once
+            Vector3 waterPos = { 0, WATER_Y_OFFSET, 0 };
+            Vector3 waterShift = Vector3Scale(Vector3Subtract(waterPos, camera.position), 0.05f);// Scale it down to something subtle, like 5%
+            Vector3 waterDrawPos = Vector3Add(waterPos, waterShift);
+            Vector2 waveCamera = { camera.position.x - waterDrawPos.x, camera.position.z - waterDrawPos.z };
+            SetShaderValue(waterShader, waveCameraLoc, &waveCamera, SHADER_UNIFORM_VEC2);
+            for (int id = 0; id < CHUNK_TOTAL; id++) {
+                int cx = id / CHUNK_COUNT;
+                int cy = id % CHUNK_COUNT;
+                if(chunkHot.isLoaded[id])
+                {
+                    loadCnt++;
+                    //if(onLoad && !IsBoxInFrustum(chunkHot.box[id], frustum)){continue;}
+                    //if(onLoad && (cx!=closestCX||cy!=closestCY) && !ShouldRenderChunk(chunkHot.center[id],camera)){continue;}
+                    //TraceLog(LOG_INFO, "drawing chunk: %d,%d", cx, cy);
+                    if(chunkHot.lod[id] == LOD_64) 
                     {
-                        loadCnt++;
-                        //if(onLoad && !IsBoxInFrustum(chunks[cx][cy].box, frustum)){continue;}
-                        //if(onLoad && (cx!=closestCX||cy!=closestCY) && !ShouldRenderChunk(chunks[cx][cy].center,camera)){continue;}
-                        //TraceLog(LOG_INFO, "drawing chunk: %d,%d", cx, cy);
-                        if(chunks[cx][cy].lod == LOD_64) 
+                        chunkBcCount++;
+                        chunkTriCount+=chunks[cx][cy].model.meshes[0].triangleCount;
+                        //mvp and model come from DrawModel (locs are set at load), cameraPosition is set once per frame
+                        RenderQueuePushModel(&renderQueue, RQ_PASS_TERRAIN, &chunks[cx][cy].model, chunkHot.position[id], MAP_SCALE, WHITE, chunkHot.center[id]);
+                        if(onLoad)//only once we have fully loaded everything
                         {
-                            chunkBcCount++;
-                            chunkTriCount+=chunks[cx][cy].model.meshes[0].triangleCount;
-                            Matrix mvp = MatrixMultiply(proj, MatrixMultiply(view, chunks[cx][cy].model.transform));
-                            SetShaderValueMatrix(heightShaderLight, mvpLocLight, mvp);
-                            //SetShaderValueMatrix(heightShaderLight, modelLocLight, MatrixIdentity());
-                            Matrix chunkModelMatrix = MatrixTranslate(chunks[cx][cy].position.x, chunks[cx][cy].position.y, chunks[cx][cy].position.z);
-                            SetShaderValueMatrix(heightShaderLight, modelLocLight, chunkModelMatrix);
-                            Vector3 camPos = camera.position;
-                            SetShaderValue(heightShaderLight, GetShaderLocation(heightShaderLight, "cameraPosition"), &camPos, SHADER_UNIFORM_VEC3);
-                            BeginShaderMode(heightShaderLight);
-                            DrawModel(chunks[cx][cy].model, chunks[cx][cy].position, MAP_SCALE, WHITE);
-                            EndShaderMode();
-                            if(onLoad)//only once we have fully loaded everything
+                            //handle water first
+                            if (chunkHot.hasWater[id])
                             {
-                                //handle water first
-                                for (int w=0; w<chunks[cx][cy].waterCount; w++)
-                                {
-                                    glEnable(GL_POLYGON_OFFSET_FILL);
-                                    glPolygonOffset(-1.0f, -1.0f); // Push water slightly forward in Z-buffer
-                                    rlDisableBackfaceCulling();
-                                    //rlDisableDepthMask(); 
-                                    //BeginBlendMode(BLEND_ALPHA);
-                                    Vector3 cameraPos = camera.position;
-                                    Vector3 waterPos = { 0, WATER_Y_OFFSET, 0 };
-                                    // Get direction from patch to camera
-                                    Vector3 toCamera = Vector3Subtract(waterPos, cameraPos);
-                                    // Scale it down to something subtle, like 5%
-                                    Vector3 shift = Vector3Scale(toCamera, 0.05f);
-                                    // Final draw position is nudged toward the player
-                                    Vector3 drawPos = Vector3Add(waterPos, shift);
-                                    Vector2 offset = (Vector2){ w * cx, w * cy };
-                                    SetShaderValue(waterShader, offsetLoc, &offset, SHADER_UNIFORM_VEC2);
-                                    BeginShaderMode(waterShader);
-                                    DrawModel(chunks[cx][cy].water[w], drawPos, 1.0f, (Color){ 0, 100, 253, 232 });
-                                    EndShaderMode();
-                                    //EndBlendMode();
-                                    //rlEnableDepthMask(); 
-                                    rlEnableBackfaceCulling();
-                                    glDisable(GL_POLYGON_OFFSET_FILL);
-                                }
-                                if(!USE_GPU_INSTANCING)
-                                {
-                                    for(int pInd = 0; pInd<chunks[cx][cy].treeCount; pInd++)
-                                    {
-                                        BoundingBox tob = UpdateBoundingBox(treeOrigBox,chunks[cx][cy].props[pInd].pos);
-                                        if((!IsTreeInActiveTile(chunks[cx][cy].props[pInd].pos, closestCX,closestCY,playerTileX,playerTileY) || USE_TILES_ONLY)
-                                            || !IsBoxInFrustum(tob, frustum)){continue;}
-                                        //TraceLog(LOG_INFO, "Drawing (%d,%d) tree at %.2f %.2f %.2f", cx, cy, chunks[cx][cy].treePositions[pInd].x, chunks[cx][cy].treePositions[pInd].y, chunks[cx][cy].treePositions[pInd].z);
-                                        if(USE_TREE_CUBES)
-                                        {
-                                            DrawModelEx(treeCubeModel, chunks[cx][cy].props[pInd].pos, (Vector3){0, 1, 0}, 0.0f, (Vector3){1, 1, 1}, DARKGREEN);
-                                        }
-                                        else
-                                        {
-                                            bool close = Vector3Distance(chunks[cx][cy].props[pInd].pos,camera.position) < FULL_TREE_DIST;
-                                            Model tree3 = close ? treeModel : bgTreeModel;
-                                            tree3 = chunks[cx][cy].props[pInd].type==MODEL_ROCK?rockModel:tree3;
-                                            if(reportOn){treeTriCount+=tree3.meshes[0].triangleCount;treeBcCount++;}
-                                            DrawModel(tree3, chunks[cx][cy].props[pInd].pos, 1.0f, WHITE);
-                                        }
-                                        if(displayBoxes){DrawBoundingBox(tob,BLUE);}
-                                    }
-                                }
-                                else //GPU INSTANCING FOR CLOSE STATIC PROPS
+                                RenderQueuePushModel(&renderQueue, RQ_PASS_WATER, &chunks[cx][cy].water, waterDrawPos, 1.0f, (Color){ 0, 100, 253, 232 }, chunkHot.center[id]);
+                            }
+                            if(!USE_GPU_INSTANCING)
+                            {
+                                for(int pInd = 0; pInd<chunks[cx][cy].treeCount; pInd++)
                                 {
-                                    int counter[MODEL_TOTAL_COUNT] = {0,0};
-                                    //- loop through all of the static props that are int he active active tile zone
-                                    for(int pInd = 0; pInd<chunks[cx][cy].treeCount; pInd++)
+                                    BoundingBox tob = UpdateBoundingBox(treeOrigBox,chunks[cx][cy].props[pInd].pos);
+                                    if((!IsTreeInActiveTile(chunks[cx][cy].props[pInd].pos, closestCX,closestCY,playerTileX,playerTileY) || USE_TILES_ONLY)
+                                        || !IsBoxInFrustum(tob, frustum)){continue;}
+                                    //TraceLog(LOG_INFO, "Drawing (%d,%d) tree at %.2f %.2f %.2f", cx, cy, chunks[cx][cy].treePositions[pInd].x, chunks[cx][cy].treePositions[pInd].y, chunks[cx][cy].treePositions[pInd].z);
+                                    if(USE_TREE_CUBES)
                                     {
-                                        //culling
-                                        BoundingBox tob = UpdateBoundingBox(treeOrigBox,chunks[cx][cy].props[pInd].pos);
-                                        if((!IsTreeInActiveTile(chunks[cx][cy].props[pInd].pos, closestCX,closestCY,playerTileX,playerTileY) || USE_TILES_ONLY)
-                                            || !IsBoxInFrustum(tob, frustum)){continue;}
-                                        //get ready to draw
-                                        Vector3 _p = chunks[cx][cy].props[pInd].pos;
-                                        Matrix translation = MatrixTranslate(_p.x, _p.y, _p.z);
-                                        Vector3 axis = Vector3Normalize((Vector3){ (float)GetRandomValue(0, 360), (float)GetRandomValue(0, 360), (float)GetRandomValue(0, 360) });
-                                        float angle = (float)GetRandomValue(0, 180)*DEG2RAD;
-                                        Matrix rotation = MatrixRotate(axis, angle);
-                                        //transforms[i] = MatrixMultiply(rotation, translation);//todo: add rotations and such
-                                        HighFiTransforms[chunks[cx][cy].props[pInd].type][counter[chunks[cx][cy].props[pInd].type]] = translation;//well this is kindof insane
-                                        counter[chunks[cx][cy].props[pInd].type]++;
-                                        if(displayBoxes){DrawBoundingBox(tob,BLUE);}
-                                        if(reportOn){treeTriCount+=HighFiStaticObjectModels[chunks[cx][cy].props[pInd].type].meshes[0].triangleCount;}
+                                        DrawModelEx(treeCubeModel, chunks[cx][cy].props[pInd].pos, (Vector3){0, 1, 0}, 0.0f, (Vector3){1, 1, 1}, DARKGREEN);
                                     }
-                                    //draw
-                                    for(int mt=0; mt<MODEL_TOTAL_COUNT; mt++)
+                                    else
                                     {
-                                        treeBcCount++;
-                                        DrawMeshInstancedCustom(
-                                            HighFiStaticObjectModels[mt].meshes[0], 
-                                            HighFiStaticObjectMaterials[mt], 
-                                            HighFiTransforms[mt], 
-                                            counter[mt]
-                                        );//rpi5
+                                        bool close = Vector3Distance(chunks[cx][cy].props[pInd].pos,camera.position) < FULL_TREE_DIST;
+                                        Model *tree3 = close ? &treeModel : &bgTreeModel;
+                                        tree3 = chunks[cx][cy].props[pInd].type==MODEL_ROCK?&rockModel:tree3;
+                                        if(reportOn){treeTriCount+=tree3->meshes[0].triangleCount;treeBcCount++;}
+                                        RenderQueuePushModel(&renderQueue, RQ_PASS_PROPS, tree3, chunks[cx][cy].props[pInd].pos, 1.0f, WHITE, chunks[cx][cy].props[pInd].pos);
                                     }
+                                    if(displayBoxes){DrawBoundingBox(tob,BLUE);}
                                 }
                             }
-                        }
-                        else if(chunks[cx][cy].lod == LOD_32 && IsBoxInFrustum(chunks[cx][cy].box, frustumChunk8)) {
-                            chunkBcCount++;
-                            chunkTriCount+=chunks[cx][cy].model32.meshes[0].triangleCount;
-                            Matrix mvp = MatrixMultiply(proj, MatrixMultiply(view, chunks[cx][cy].model.transform));
-                            SetShaderValueMatrix(heightShaderLight, mvpLocLight, mvp);
-                            BeginShaderMode(heightShaderLight);
-                            DrawModel(chunks[cx][cy].model32, chunks[cx][cy].position, MAP_SCALE, displayLod?BLUE:WHITE);
-                            EndShaderMode();
-                            for (int w=0; w<chunks[cx][cy].waterCount; w++)
+                            else //GPU INSTANCING FOR CLOSE STATIC PROPS
                             {
-                                glEnable(GL_POLYGON_OFFSET_FILL);
-                                glPolygonOffset(-1.0f, -1.0f); // Push water slightly forward in Z-buffer
-                                rlDisableBackfaceCulling();
-                                //rlDisableDepthMask();
-                                //BeginBlendMode(BLEND_ALPHA);
-                                Vector3 cameraPos = camera.position;
-                                Vector3 waterPos = { 0, WATER_Y_OFFSET, 0 };
-                                // Get direction from patch to camera
-                                Vector3 toCamera = Vector3Subtract(waterPos, cameraPos);
-                                // Scale it down to something subtle, like 5%
-                                Vector3 shift = Vector3Scale(toCamera, 0.05f);
-                                // Final draw position is nudged toward the player
-                                Vector3 drawPos = Vector3Add(waterPos, shift);
-                                Vector2 offset = (Vector2){ w * cx, w * cy };
-                                SetShaderValue(waterShader, offsetLoc, &offset, SHADER_UNIFORM_VEC2);
-                                BeginShaderMode(waterShader);
-                                DrawModel(chunks[cx][cy].water[w], drawPos, 1.0f, (Color){ 0, 100, 254, 180 });
-                                EndShaderMode();
-                                //EndBlendMode();
-                                //rlEnableDepthMask();
-                                rlEnableBackfaceCulling();
-                                glDisable(GL_POLYGON_OFFSET_FILL);
+                                //- loop through all of the static props that are int he active active tile zone
+                                //transforms pile up across every close chunk, one instanced draw per model type at flush
+                                for(int pInd = 0; pInd<chunks[cx][cy].treeCount; pInd++)
+                                {
+                                    int pType = chunks[cx][cy].props[pInd].type;
+                                    //culling
+                                    BoundingBox tob = UpdateBoundingBox(treeOrigBox,chunks[cx][cy].props[pInd].pos);
+                                    if((!IsTreeInActiveTile(chunks[cx][cy].props[pInd].pos, closestCX,closestCY,playerTileX,playerTileY) || USE_TILES_ONLY)
+                                        || !IsBoxInFrustum(tob, frustum)){continue;}
+                                    if(propCounter[pType] >= MAX_PROPS_UPPER_BOUND){
+                                        if(!propOverflowLogged){
+                                            TraceLog(LOG_WARNING, "More than %d visible props of type %d, the rest are not drawn", MAX_PROPS_UPPER_BOUND, pType);
+                                            propOverflowLogged = true;
+                                        }
+                                        continue;
+                                    }
+                                    //get ready to draw
+                                    Vector3 _p = chunks[cx][cy].props[pInd].pos;
+                                    Matrix translation = MatrixTranslate(_p.x, _p.y, _p.z);
+                                    HighFiTransforms[pType][propCounter[pType]] = translation;//well this is kindof insane
+                                    propCounter[pType]++;
+                                    if(displayBoxes){DrawBoundingBox(tob,BLUE);}
+                                    if(reportOn){treeTriCount+=HighFiStaticObjectModels[pType].meshes[0].triangleCount;}
+                                }
                             }
                         }
-                        else if(chunks[cx][cy].lod == LOD_16 && IsBoxInFrustum(chunks[cx][cy].box, frustumChunk8)) {
-                            chunkBcCount++;
-                            chunkTriCount+=chunks[cx][cy].model16.meshes[0].triangleCount;
-                            DrawModel(chunks[cx][cy].model16, chunks[cx][cy].position, MAP_SCALE, displayLod?PURPLE:chunk_16_color);
-                        }
-                        else if(IsBoxInFrustum(chunks[cx][cy].box, frustumChunk8)||!onLoad) {
-                            chunkBcCount++;
-                            chunkTriCount+=chunks[cx][cy].model8.meshes[0].triangleCount;
-                            DrawModel(chunks[cx][cy].model8, chunks[cx][cy].position, MAP_SCALE, displayLod?RED:chunk_08_color);
+                    }
+                    else if(chunkHot.lod[id] == LOD_32 && IsBoxInFrustum(chunkHot.box[id], frustumChunk8)) {
+                        chunkBcCount++;
+                        chunkTriCount+=chunks[cx][cy].model32.meshes[0].triangleCount;
+                        RenderQueuePushModel(&renderQueue, RQ_PASS_TERRAIN, &chunks[cx][cy].model32, chunkHot.position[id], MAP_SCALE, displayLod?BLUE:WHITE, chunkHot.center[id]);
+                        if (chunkHot.hasWater[id] || chunkHot.hasWaterFar[id])
+                        {
+                            //far water is big flat rects, older maps only have the near set
+                            Model *water = chunkHot.hasWaterFar[id] ? &chunks[cx][cy].waterFar : &chunks[cx][cy].water;
+                            RenderQueuePushModel(&renderQueue, RQ_PASS_WATER, water, waterDrawPos, 1.0f, (Color){ 0, 100, 254, 180 }, chunkHot.center[id]);
                         }
-                        if(displayBoxes){DrawBoundingBox(chunks[cx][cy].box,YELLOW);}
                     }
-                    else {loadedEem = false;}
+                    else if(chunkHot.lod[id] == LOD_16 && IsBoxInFrustum(chunkHot.box[id], frustumChunk8)) {
+                        chunkBcCount++;
+                        chunkTriCount+=chunks[cx][cy].model16.meshes[0].triangleCount;
+                        RenderQueuePushModel(&renderQueue, RQ_PASS_TERRAIN, &chunks[cx][cy].model16, chunkHot.position[id], MAP_SCALE, displayLod?PURPLE:chunk_16_color, chunkHot.center[id]);
+                    }
+                    else if(IsBoxInFrustum(chunkHot.box[id], frustumChunk8)||!onLoad) {
+                        chunkBcCount++;
+                        chunkTriCount+=chunks[cx][cy].model8.meshes[0].triangleCount;
+                        RenderQueuePushModel(&renderQueue, RQ_PASS_TERRAIN, &chunks[cx][cy].model8, chunkHot.position[id], MAP_SCALE, displayLod?RED:chunk_08_color, chunkHot.center[id]);
+                    }
+                    if(displayBoxes){DrawBoundingBox(chunkHot.box[id],YELLOW);}
+                }
+                else {loadedEem = false;}
+            }
+            //world water bodies, culled per piece, near or far set picked by distance to the piece where it is drawn
+            //(shifted like the rest of the water), the same distance water.vs fades the waves with, so far pieces are flat
+            if(onLoad)
+            {
+                for(int wp = 0; wp < waterPieceCount; wp++)
+                {
+                    BoundingBox drawBox = { Vector3Add(waterPieces[wp].box.min, waterShift), Vector3Add(waterPieces[wp].box.max, waterShift) };
+                    float d = BoxDistanceXZ(drawBox, camera.position);
+                    if(d > WATER_DRAW_DIST || waterPieces[wp].far != (d > WATER_NEAR_DIST)){continue;}
+                    if(!IsBoxInFrustum(drawBox, frustumChunk8)){continue;}
+                    Vector3 center = Vector3Scale(Vector3Add(drawBox.min, drawBox.max), 0.5f);
+                    RenderQueuePushModel(&renderQueue, RQ_PASS_WATER, &waterPieces[wp].model, waterDrawPos, 1.0f, (Color){ 0, 100, 253, 232 }, center);
+                    if(displayBoxes){DrawBoundingBox(drawBox,SKYBLUE);}
+                }
+            }
+            if(USE_GPU_INSTANCING)
+            {
+                for(int mt=0; mt<MODEL_TOTAL_COUNT; mt++)
+                {
+                    if(propCounter[mt] == 0){continue;}
+                    treeBcCount++;
+                    RenderQueuePushInstanced(&renderQueue, RQ_PASS_PROPS, &HighFiStaticObjectModels[mt].meshes[0], &HighFiStaticObjectMaterials[mt], HighFiTransforms[mt], propCounter[mt]);//rpi5
                 }
             }
+            //per frame uniforms, once, then draw the whole sorted frame, a pass at a time so the profiler can split it
+            SetShaderValue(heightShaderLight, cameraPosLocLight, &camera.position, SHADER_UNIFORM_VEC3);
+            RenderQueueSort(&renderQueue);
+            ProfEnd(PROF_CULL);
+            ProfBegin(PROF_TERRAIN);
+            RenderQueueFlushPass(&renderQueue, RQ_PASS_TERRAIN);
+            ProfEnd(PROF_TERRAIN);
+            ProfBegin(PROF_TILES);
+            RenderQueueFlushPass(&renderQueue, RQ_PASS_TILES);
+            ProfEnd(PROF_TILES);
+            ProfBegin(PROF_INSTANCING);
+            RenderQueueFlushPass(&renderQueue, RQ_PASS_PROPS);
+            ProfEnd(PROF_INSTANCING);
+            ProfBegin(PROF_WATER);
+            RenderQueueFlushPass(&renderQueue, RQ_PASS_WATER);
+            ProfEnd(PROF_WATER);
             //rlEnableBackfaceCulling();
             if(reportOn) //triangle report
             {
@@ -2186,10 +2581,12 @@ int main(void) {
                 printf("Estimated batch calls for chunks     :  %d\n", chunkBcCount);
                 printf("Estimated TOTAL triangles this frame :  %d\n", totalTriCount);
                 printf("Estimated TOTAL batch calls          :  %d\n", totalBcCount);
+                printf("Queue draws / shader binds / passes  :  %d / %d / %d\n", renderQueue.drawCalls, renderQueue.shaderChanges, renderQueue.passChanges);
                 printf("Current FPS (so you can document)    :  %d\n", GetFPS());
             }
             //DrawGrid(256, 1.0f);
         EndMode3D();
+        ProfBegin(PROF_UI);
         DrawText("WASD to move, mouse to look", 10, 10, 20, BLACK);
         DrawText(TextFormat("Pitch: %.2f  Yaw: %.2f", pitch, yaw), 10, 30, 20, BLACK);
         DrawText(TextFormat("Next Chunk: (%d,%d)", chosenX, chosenY), 10, 50, 20, BLACK);
@@ -2258,17 +2655,38 @@ int main(void) {
             for (int cy = 0; cy < CHUNK_COUNT; cy++) {
                 for (int cx = 0; cx < CHUNK_COUNT; cx++) {
                     // Offset the entire chunk's Y to make sea level align with Y=0
-                    //chunks[cx][cy].position.y += seaLevel;
-                    //chunks[cx][cy].center.y += seaLevel;
-                    //chunks[cx][cy].box = UpdateBoundingBox(chunks[cx][cy].origBox, chunks[cx][cy].center);
+                    //chunkHot.position[ChunkId(cx, cy)].y += seaLevel;
+                    //chunkHot.center[ChunkId(cx, cy)].y += seaLevel;
+                    //chunkHot.box[ChunkId(cx, cy)] = UpdateBoundingBox(chunks[cx][cy].origBox, chunkHot.center[ChunkId(cx, cy)]);
                 }
             }
             camera.position.x = -16; //3000;//
             camera.position.z = -16; //3000;//
         }
         DrawFPS(10,110);
+        if (frameProfiler.overlay) {ProfDrawOverlay(SCREEN_WIDTH - 330, 10, 320, 120);}
+        if (memTracker.overlay) {MemTrackDrawOverlay(SCREEN_WIDTH - 330, frameProfiler.overlay ? 260 : 10);}
+        ProfEnd(PROF_UI);
+        ProfBegin(PROF_PRESENT);
         EndDrawing();
+        ProfEnd(PROF_PRESENT);
+        ProfFrameEnd();
+        if (benchRun.running)
+        {
+            int uploadsThisFrame = BenchUploadTotal(benchRun.uploads) - benchUploadsBefore;
+            BenchRecordFrame(&benchRun, uploadsThisFrame, renderQueue.drawCalls, (size_t)memTracker.gpuTotal);
+            if (benchFinished)
+            {
+                benchRun.running = false;
+                benchRun.done = true;
+                BenchWriteReport(&benchRun);
+                break;
+            }
+        }
     }
+    if (benchRecordFile) {BenchToggleRecording();}
+    if (tracer.enabled) {if (traceOut) {TraceWrite(traceOut);} else {TraceWriteWithTimestamp();}}
+    BenchFree(&benchRun);
 
     //unload skybox
     UnloadTexture(skyTexFront);
@@ -2276,6 +2694,14 @@ int main(void) {
     UnloadTexture(skyTexLeft);
     UnloadTexture(skyTexRight);
     UnloadTexture(skyTexUp);
+    //unload stars, the instance buffer isnt part of the mesh so UnloadMesh wont get it
+    if (starInstancesVbo != 0)
+    {
+        rlUnloadVertexBuffer(starInstancesVbo);
+        MemTrackGpu(MEM_PARTICLES, -(int64_t)STAR_COUNT * sizeof(float16), -1);
+        starInstancesVbo = 0;
+    }
+    UnloadMesh(sphereStarMesh);
     //unload in game map
     UnloadTexture(mapTexture);
     //unload tiles
@@ -2284,18 +2710,9 @@ int main(void) {
     for (int cy = 0; cy < CHUNK_COUNT; cy++)
     {
         for (int cx = 0; cx < CHUNK_COUNT; cx++) {
-            if(chunks[cx][cy].isLoaded)
+            if(chunkHot.isReady[ChunkId(cx, cy)])
             {
-                UnloadModel(chunks[cx][cy].model);
-                UnloadModel(chunks[cx][cy].model32);
-                UnloadModel(chunks[cx][cy].model16);
-                UnloadModel(chunks[cx][cy].model8);
-                UnloadTexture(chunks[cx][cy].texture);
-                UnloadTexture(chunks[cx][cy].textureBig);
-                UnloadTexture(chunks[cx][cy].textureFull);
-                UnloadTexture(chunks[cx][cy].textureDamn);
-                free(chunks[cx][cy].props);
-                chunks[cx][cy].props = NULL;
+                UnloadChunk(cx, cy);
             }
         }
     }
@@ -2314,8 +2731,10 @@ int main(void) {
     }
     free(chunks);
     chunks = NULL;
+    ChunkHotFree();
 
     CloseAudioDevice();
+    RenderQueueFree(&renderQueue);
     CloseWindow();
     return 0;
 }
@@ -0,0 +1,190 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+//tiny scoped cpu profiler for the frame, rolling history per phase, overlay graph and csv dump
+//note: these are cpu times, gpu work shows up wherever the driver decides to block (usually PROF_PRESENT)
+#include "raylib.h"
+#include "trace.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+typedef enum {
+    PROF_INPUT = 0,   // mouse/keys, movement, ground snap, lights
+    PROF_LOD,         // FindClosestChunkAndAssignLod
+    PROF_UPLOAD,      // main thread gpu uploads from the loader thread
+    PROF_CULL,        // frustum tests + building the render queue
+    PROF_TERRAIN,
+    PROF_TILES,
+    PROF_INSTANCING,  // props
+    PROF_WATER,
+    PROF_NIGHT,       // fireflies and stars
+    PROF_SKYBOX,
+    PROF_UI,          // 2d text, map, loading bar, this overlay
+    PROF_PRESENT,     // EndDrawing, swap + fps limiter wait
+    PROF_PHASE_COUNT
+} ProfPhase;
+
+static const char *ProfPhaseNames[PROF_PHASE_COUNT] = {
+    "input", "lod", "upload", "cull", "terrain", "tiles", "instancing", "water", "night", "skybox", "ui", "present"
+};
+
+static const Color ProfPhaseColors[PROF_PHASE_COUNT] = {
+    { 230, 41, 55, 255 },   // red
+    { 255, 161, 0, 255 },   // orange
+    { 253, 249, 0, 255 },   // yellow
+    { 0, 228, 48, 255 },    // green
+    { 0, 117, 44, 255 },    // dark green
+    { 102, 191, 255, 255 }, // sky blue
+    { 0, 82, 172, 255 },    // dark blue
+    { 0, 121, 241, 255 },   // blue
+    { 200, 122, 255, 255 }, // purple
+    { 211, 176, 131, 255 }, // beige
+    { 255, 109, 194, 255 }, // pink
+    { 130, 130, 130, 255 }, // gray
+};
+
+#define PROF_HISTORY 300 //frames kept, 5 sec at 60
+#define PROF_BUDGET_MS 16.6f
+
+typedef struct {
+    double phaseStart[PROF_PHASE_COUNT];
+    float current[PROF_PHASE_COUNT];          // this frame so far
+    float history[PROF_HISTORY][PROF_PHASE_COUNT];
+    float frameMs[PROF_HISTORY];              // wall time frame to frame
+    unsigned long frameIndex[PROF_HISTORY];
+    unsigned long frameCounter;
+    double frameStart;
+    int head;                                 // next slot to write
+    int count;                                // valid slots
+    bool overlay;
+} FrameProfiler;
+
+FrameProfiler frameProfiler = { 0 };
+
+static inline double ProfNowMs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+// Phases can be entered more than once a frame, the time adds up
+static inline void ProfBegin(ProfPhase phase)
+{
+    frameProfiler.phaseStart[phase] = ProfNowMs();
+    TraceBegin(ProfPhaseNames[phase], "frame");
+}
+
+static inline void ProfEnd(ProfPhase phase)
+{
+    frameProfiler.current[phase] += (float)(ProfNowMs() - frameProfiler.phaseStart[phase]);
+    TraceEnd(ProfPhaseNames[phase], "frame");
+}
+
+// Close the frame: push this frames numbers into the ring and start the next one
+void ProfFrameEnd(void)
+{
+    FrameProfiler *p = &frameProfiler;
+    double now = ProfNowMs();
+    if (p->frameStart <= 0.0) p->frameStart = now;
+    memcpy(p->history[p->head], p->current, sizeof(p->current));
+    p->frameMs[p->head] = (float)(now - p->frameStart);
+    p->frameIndex[p->head] = p->frameCounter++;
+    p->head = (p->head + 1) % PROF_HISTORY;
+    if (p->count < PROF_HISTORY) p->count++;
+    memset(p->current, 0, sizeof(p->current));
+    p->frameStart = now;
+}
+
+// i = 0 is the oldest frame still in the ring
+static inline int ProfSlot(int i)
+{
+    return (frameProfiler.head - frameProfiler.count + i + PROF_HISTORY) % PROF_HISTORY;
+}
+
+float ProfAverage(ProfPhase phase)
+{
+    if (frameProfiler.count == 0) return 0.0f;
+    float sum = 0.0f;
+    for (int i = 0; i < frameProfiler.count; i++) sum += frameProfiler.history[ProfSlot(i)][phase];
+    return sum / frameProfiler.count;
+}
+
+// Write every frame in the ring as csv, one row per frame, oldest first
+bool ProfDumpCSV(const char *path)
+{
+    FILE *f = fopen(path, "w");
+    if (!f)
+    {
+        TraceLog(LOG_WARNING, "PROFILER: could not open %s", path);
+        return false;
+    }
+    fprintf(f, "frame,frame_ms");
+    for (int ph = 0; ph < PROF_PHASE_COUNT; ph++) fprintf(f, ",%s_ms", ProfPhaseNames[ph]);
+    fprintf(f, "\n");
+    for (int i = 0; i < frameProfiler.count; i++)
+    {
+        int s = ProfSlot(i);
+        fprintf(f, "%lu,%.3f", frameProfiler.frameIndex[s], frameProfiler.frameMs[s]);
+        for (int ph = 0; ph < PROF_PHASE_COUNT; ph++) fprintf(f, ",%.3f", frameProfiler.history[s][ph]);
+        fprintf(f, "\n");
+    }
+    fclose(f);
+    TraceLog(LOG_INFO, "PROFILER: wrote %d frames to %s", frameProfiler.count, path);
+    return true;
+}
+
+void ProfDumpCSVWithTimestamp(void)
+{
+    time_t now = time(NULL);
+    struct tm *t = localtime(&now);
+    char filename[128];
+    strftime(filename, sizeof(filename), "profile_%Y%m%d_%H%M%S.csv", t);
+    ProfDumpCSV(filename);
+}
+
+// Stacked bar per frame (newest on the right), the white line is the 60 fps budget, legend shows the rolling average
+void ProfDrawOverlay(int x, int y, int width, int height)
+{
+    FrameProfiler *p = &frameProfiler;
+    float msToPx = height / (PROF_BUDGET_MS * 2.0f); //graph tops out at two frames worth
+    DrawRectangle(x, y, width, height, (Color){ 0, 0, 0, 160 });
+    int bars = p->count < width ? p->count : width;
+    for (int b = 0; b < bars; b++)
+    {
+        int s = ProfSlot(p->count - bars + b);
+        int bx = x + width - bars + b;
+        float stack = 0.0f;
+        for (int ph = 0; ph < PROF_PHASE_COUNT; ph++)
+        {
+            float ms = p->history[s][ph];
+            int y0 = y + height - (int)((stack + ms) * msToPx);
+            int y1 = y + height - (int)(stack * msToPx);
+            if (y0 < y) y0 = y;
+            if (y1 > y0) DrawLine(bx, y0, bx, y1, ProfPhaseColors[ph]);
+            stack += ms;
+        }
+    }
+    int budgetY = y + height - (int)(PROF_BUDGET_MS * msToPx);
+    DrawLine(x, budgetY, x + width, budgetY, WHITE);
+
+    int ly = y + height + 4;
+    float total = 0.0f;
+    for (int ph = 0; ph < PROF_PHASE_COUNT; ph++)
+    {
+        float avg = ProfAverage(ph);
+        total += avg;
+        int col = ph % 2;
+        int row = ph / 2;
+        int lx = x + col * (width / 2);
+        DrawRectangle(lx, ly + row * 14 + 2, 8, 8, ProfPhaseColors[ph]);
+        DrawText(TextFormat("%-10s %5.2f ms", ProfPhaseNames[ph], avg), lx + 12, ly + row * 14, 10, RAYWHITE);
+    }
+    int rows = (PROF_PHASE_COUNT + 1) / 2;
+    DrawText(TextFormat("measured %.2f ms  frame %.2f ms", total, p->count ? p->frameMs[ProfSlot(p->count - 1)] : 0.0f),
+             x, ly + rows * 14 + 2, 10, RAYWHITE);
+}
+
+#endif //PROFILER_H
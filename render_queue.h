@@ -0,0 +1,232 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+//collect the frame first, sort it, then draw it, so shaders/textures/gl state change once per group instead of per chunk
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include "gpu.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Passes are drawn in this order, keep water last (it blends over everything)
+typedef enum {
+    RQ_PASS_TERRAIN = 0,  // chunks, front to back
+    RQ_PASS_TILES,        // baked tile batches
+    RQ_PASS_PROPS,        // trees and rocks, gpu instanced or not
+    RQ_PASS_WATER,        // polygon offset + no backface culling, back to front
+    RQ_PASS_COUNT
+} RenderPass;
+
+typedef enum {
+    RQ_ITEM_MODEL = 0,
+    RQ_ITEM_INSTANCED,
+} RenderItemType;
+
+typedef struct {
+    uint64_t key;             // pass | shader | texture | depth, see RenderQueueKey
+    RenderItemType type;
+    Shader shader;            // copy, the group bind needs the whole thing
+    //RQ_ITEM_MODEL
+    const Model *model;
+    Vector3 position;
+    float scale;
+    Color tint;
+    //RQ_ITEM_INSTANCED
+    const Mesh *mesh;
+    const Material *material;
+    const Matrix *transforms; // must stay alive until RenderQueueFlush
+    int instances;
+} RenderItem;
+
+typedef struct {
+    RenderItem *items;
+    int count;
+    int capacity;
+    Vector3 eye;              // depth is measured from here
+    bool sorted;
+    int cursor;               // next item RenderQueueFlushPass looks at
+    //stats since RenderQueueBegin, for the F11 report
+    int drawCalls;
+    int shaderChanges;
+    int passChanges;
+} RenderQueue;
+
+//64 bit sort key: 4 bits pass, 12 bits shader, 16 bits texture, 32 bits depth
+//depth is a positive float, its bits sort the same as its value, so no conversion needed
+static inline uint64_t RenderQueueKey(RenderPass pass, unsigned int shaderId, unsigned int textureId, float depthSq)
+{
+    uint32_t depthBits = 0;
+    if (depthSq < 0.0f) depthSq = 0.0f;
+    memcpy(&depthBits, &depthSq, sizeof(depthBits));
+    if (pass == RQ_PASS_WATER) depthBits = ~depthBits; // back to front for blending
+    return ((uint64_t)(pass & 0xF) << 60) |
+           ((uint64_t)(shaderId & 0xFFF) << 48) |
+           ((uint64_t)(textureId & 0xFFFF) << 32) |
+           (uint64_t)depthBits;
+}
+
+bool RenderQueueInit(RenderQueue *q, int capacity)
+{
+    memset(q, 0, sizeof(RenderQueue));
+    q->items = (RenderItem *)malloc(sizeof(RenderItem) * capacity);
+    if (!q->items)
+    {
+        TraceLog(LOG_ERROR, "RENDER QUEUE: failed to allocate %d items", capacity);
+        return false;
+    }
+    q->capacity = capacity;
+    return true;
+}
+
+void RenderQueueFree(RenderQueue *q)
+{
+    free(q->items);
+    memset(q, 0, sizeof(RenderQueue));
+}
+
+// Start a new frame, depth for sorting is measured from eye
+void RenderQueueBegin(RenderQueue *q, Vector3 eye)
+{
+    q->count = 0;
+    q->eye = eye;
+    q->sorted = false;
+    q->cursor = 0;
+    q->drawCalls = 0;
+    q->shaderChanges = 0;
+    q->passChanges = 0;
+}
+
+static RenderItem *RenderQueueNext(RenderQueue *q)
+{
+    if (q->count >= q->capacity)
+    {
+        int newCap = q->capacity > 0 ? q->capacity * 2 : 256;
+        RenderItem *grown = (RenderItem *)realloc(q->items, sizeof(RenderItem) * newCap);
+        if (!grown)
+        {
+            TraceLog(LOG_WARNING, "RENDER QUEUE: out of memory, dropping draw");
+            return NULL;
+        }
+        q->items = grown;
+        q->capacity = newCap;
+    }
+    RenderItem *item = &q->items[q->count++];
+    memset(item, 0, sizeof(RenderItem));
+    return item;
+}
+
+// Queue a DrawModel, center is only used for the depth part of the key
+void RenderQueuePushModel(RenderQueue *q, RenderPass pass, const Model *model, Vector3 position, float scale, Color tint, Vector3 center)
+{
+    if (model->meshCount <= 0 || model->materialCount <= 0) return;
+    RenderItem *item = RenderQueueNext(q);
+    if (!item) return;
+    Material *mat = &model->materials[0];
+    item->type = RQ_ITEM_MODEL;
+    item->shader = mat->shader;
+    item->model = model;
+    item->position = position;
+    item->scale = scale;
+    item->tint = tint;
+    item->key = RenderQueueKey(pass, mat->shader.id, mat->maps[MATERIAL_MAP_DIFFUSE].texture.id, Vector3DistanceSqr(center, q->eye));
+}
+
+// Queue a DrawMeshInstancedCustom, the transforms are read at flush time
+void RenderQueuePushInstanced(RenderQueue *q, RenderPass pass, const Mesh *mesh, const Material *material, const Matrix *transforms, int instances)
+{
+    if (instances <= 0) return;
+    RenderItem *item = RenderQueueNext(q);
+    if (!item) return;
+    item->type = RQ_ITEM_INSTANCED;
+    item->shader = material->shader;
+    item->mesh = mesh;
+    item->material = material;
+    item->transforms = transforms;
+    item->instances = instances;
+    item->key = RenderQueueKey(pass, material->shader.id, material->maps[MATERIAL_MAP_DIFFUSE].texture.id, 0.0f);
+}
+
+//gl state that belongs to a whole pass
+static void RenderQueueBeginPass(RenderPass pass)
+{
+    if (pass == RQ_PASS_WATER)
+    {
+        glEnable(GL_POLYGON_OFFSET_FILL);
+        glPolygonOffset(-1.0f, -1.0f); // Push water slightly forward in Z-buffer
+        rlDisableBackfaceCulling();
+    }
+}
+
+static void RenderQueueEndPass(RenderPass pass)
+{
+    if (pass == RQ_PASS_WATER)
+    {
+        rlEnableBackfaceCulling();
+        glDisable(GL_POLYGON_OFFSET_FILL);
+    }
+}
+
+static int RenderItemCompare(const void *a, const void *b)
+{
+    uint64_t ka = ((const RenderItem *)a)->key;
+    uint64_t kb = ((const RenderItem *)b)->key;
+    return (ka > kb) - (ka < kb);
+}
+
+void RenderQueueSort(RenderQueue *q)
+{
+    if (q->sorted) return;
+    qsort(q->items, q->count, sizeof(RenderItem), RenderItemCompare);
+    q->sorted = true;
+    q->cursor = 0;
+}
+
+// Draw the items of one pass, passes have to be flushed in order (the queue is walked once)
+// must be called inside BeginMode3D, per frame uniforms (time, camera position) should be set before
+void RenderQueueFlushPass(RenderQueue *q, RenderPass pass)
+{
+    RenderQueueSort(q);
+    //skip anything from earlier passes that nobody flushed
+    while (q->cursor < q->count && (int)(q->items[q->cursor].key >> 60) < (int)pass) q->cursor++;
+    if (q->cursor >= q->count || (int)(q->items[q->cursor].key >> 60) != (int)pass) return;
+
+    RenderQueueBeginPass(pass);
+    q->passChanges++;
+    int curShader = -1;
+    for (; q->cursor < q->count; q->cursor++)
+    {
+        RenderItem *item = &q->items[q->cursor];
+        if ((int)(item->key >> 60) != (int)pass) break;
+        if (item->type == RQ_ITEM_INSTANCED)
+        {
+            //binds its own program, so close the group first
+            if (curShader != -1) { EndShaderMode(); curShader = -1; }
+            DrawMeshInstancedCustom(*item->mesh, *item->material, item->transforms, item->instances);
+        }
+        else
+        {
+            if ((int)item->shader.id != curShader)
+            {
+                if (curShader != -1) EndShaderMode();
+                BeginShaderMode(item->shader);
+                curShader = (int)item->shader.id;
+                q->shaderChanges++;
+            }
+            DrawModel(*item->model, item->position, item->scale, item->tint);
+        }
+        q->drawCalls++;
+    }
+    if (curShader != -1) EndShaderMode();
+    RenderQueueEndPass(pass);
+}
+
+// Sort and draw everything queued since RenderQueueBegin
+void RenderQueueFlush(RenderQueue *q)
+{
+    for (int pass = 0; pass < RQ_PASS_COUNT; pass++) RenderQueueFlushPass(q, (RenderPass)pass);
+}
+
+#endif //RENDER_QUEUE_H
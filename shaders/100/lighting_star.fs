@@ -24,12 +24,12 @@ void main()
     //     0.5 + 0.5 * sin(instanceId * 1.7 + 4.0)
     // );
 
-    gl_FragColor = vec4(
+    vec3 starColor = vec3(
         0.5 + 0.5 * sin(u_time + instanceId * 3.1), 
         0.5 + 0.5 * sin(u_time + instanceId * 2.3 + 2.0), 
-        0.5 + 0.5 * sin(u_time + instanceId * 1.7 + 4.0), 
-        1.0
-    ); // or replace with star color
+        0.5 + 0.5 * sin(u_time + instanceId * 1.7 + 4.0)
+    );
+    gl_FragColor = vec4(starColor * blink, 1.0); // blink comes from the vertex shader
     //gl_FragColor = vec4(starColor[0], starColor[1], starColor[2], 1.0); // or replace with star color
 
     // vec3 finalColor = vec3(0.0);
@@ -12,18 +12,26 @@ attribute mat4 instanceTransform;
 varying float blink;
 varying float instanceId;
 
+// cheap per star random in 0..1, so every star gets its own rate and phase
+float hash11(float n)
+{
+    return fract(sin(n * 12.9898) * 43758.5453);
+}
+
 void main()
 {
-    instanceId = instanceTransform[3][3]; // this is mat.m12 from C
-    //instanceTransform[3][1]=1;
+    instanceId = instanceTransform[3][3]; // this is mat.m15 from C, the transforms are uploaded once
     mat4 new_transform = instanceTransform;
     new_transform[3][3]=1.0;
     vec4 worldPos = new_transform * vec4(vertexPosition, 1.0);
     gl_Position = mvp * worldPos;
-    
 
-    //blink = 0.5 + 0.5 * sin(instanceId * 9.0 + u_time * 1.5);
-    float wave = sin(instanceId * 9.0 + u_time * 1.5);
-    blink = 0.75 + 0.25 * wave;  // Range now: 0.5 to 1.0
+    // twinkle used to be a cpu timer per star, now it is all here
+    float rate = 0.8 + 1.6 * hash11(instanceId);
+    float phase = 6.2831 * hash11(instanceId + 17.0);
+    float wave = sin(phase + u_time * rate);
+    // every so often a star flares up and fades out fast
+    float flare = fract(u_time * 0.05 * rate + hash11(instanceId + 41.0));
+    flare = smoothstep(0.97, 1.0, flare) * 0.5;
+    blink = clamp(0.75 + 0.25 * wave + flare, 0.5, 1.0);  // Range: 0.5 to 1.0
 }
-
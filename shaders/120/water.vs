@@ -6,6 +6,9 @@ attribute vec2 vertexTexCoord;
 uniform mat4 mvp;
 uniform float uTime;
 uniform vec2 worldOffset;
+uniform vec2 waveCamera;      // camera xz in the same space as vertexPosition (the 5% water shift taken out)
+uniform float waveFadeStart;  // waves are full strength inside this
+uniform float waveFadeEnd;    // and gone past this, far water (only drawn past it) stays flat
 
 varying vec2 fragUV;
 varying float heightOffset;
@@ -25,8 +28,9 @@ void main() {
     wave += sin((gx - (gz*gz) - uTime * 0.8) * 7.0);
     wave += cos((gx * 0.013 + gz * 0.0011 + uTime) * 1.5);
 
-    // Scale and apply to y-position
-    pos.y += wave * 0.5;
+    // Scale and apply to y-position, fading out with distance
+    float fade = 1.0 - smoothstep(waveFadeStart, waveFadeEnd, distance(pos.xz, waveCamera));
+    pos.y += wave * 0.5 * fade;
 
     fragUV = vertexTexCoord;
     heightOffset = pos.y-295;
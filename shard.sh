@@ -0,0 +1,16 @@
+#!/bin/sh
+
+# sh shard.sh N CHUNKS [SEED] -> N create processes, one band of chunk rows each, then the merge
+N=${1:-4}
+CHUNKS=${2:-16}
+SEED=${3:-0}
+
+echo "start -> $N shards, ${CHUNKS}x${CHUNKS} chunks, seed $SEED"
+i=0
+while [ "$i" -lt "$N" ]; do
+  ./create --tiled --chunks "$CHUNKS" --seed "$SEED" --shard "$i/$N" > "shard_$i.log" 2>&1 &
+  i=$((i + 1))
+done
+wait
+echo "merge -> $N shards"
+./create --merge "$N"
@@ -0,0 +1,164 @@
+#ifndef STAGE_TIMER_H
+#define STAGE_TIMER_H
+
+//wall + cpu time per generation stage for create, stages with the same name add up (GenerateChunkModel x256 is one row)
+//stages can nest, the parent includes the child time
+//cpu time is for the whole process, so once stages go multithreaded cpu > wall is the speedup showing
+#include "raylib.h"
+#include "trace.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+
+#define MAX_STAGES 64
+
+typedef struct {
+    const char *name;   // must be a literal, we keep the pointer
+    int calls;
+    double wallMs;
+    double cpuMs;
+    int64_t pixels;
+    int64_t triangles;
+    int64_t bytes;      // written to disk
+} StageStat;
+
+typedef struct {
+    int idx;
+    double wall0;
+    double cpu0;
+} StageTimer;
+
+StageStat stageStats[MAX_STAGES];
+int stageCount = 0;
+
+static inline double StageClockMs(clockid_t clock)
+{
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+void StageReset(void)
+{
+    memset(stageStats, 0, sizeof(stageStats));
+    stageCount = 0;
+}
+
+static int StageIndex(const char *name)
+{
+    for (int i = 0; i < stageCount; i++)
+    {
+        if (strcmp(stageStats[i].name, name) == 0) return i;
+    }
+    if (stageCount >= MAX_STAGES)
+    {
+        TraceLog(LOG_WARNING, "STAGES: too many stages, dropping %s", name);
+        return -1;
+    }
+    stageStats[stageCount].name = name;
+    return stageCount++;
+}
+
+StageTimer StageBegin(const char *name)
+{
+    StageTimer t = { StageIndex(name), StageClockMs(CLOCK_MONOTONIC), StageClockMs(CLOCK_PROCESS_CPUTIME_ID) };
+    if (t.idx >= 0) TraceBegin(name, "stage");
+    return t;
+}
+
+// pixels/triangles/bytes are whatever the stage produced, 0 if it does not make sense
+void StageEnd(StageTimer t, int64_t pixels, int64_t triangles, int64_t bytes)
+{
+    if (t.idx < 0) return;
+    StageStat *s = &stageStats[t.idx];
+    TraceEnd(s->name, "stage");
+    s->calls++;
+    s->wallMs += StageClockMs(CLOCK_MONOTONIC) - t.wall0;
+    s->cpuMs += StageClockMs(CLOCK_PROCESS_CPUTIME_ID) - t.cpu0;
+    s->pixels += pixels;
+    s->triangles += triangles;
+    s->bytes += bytes;
+}
+
+long FileSizeBytes(const char *path)
+{
+    struct stat st;
+    if (stat(path, &st) != 0) return 0;
+    return (long)st.st_size;
+}
+
+//ExportImage/ExportMesh with the time and file size counted
+bool TimedExportImage(Image image, const char *fileName)
+{
+    StageTimer t = StageBegin("ExportImage");
+    bool ok = ExportImage(image, fileName);
+    StageEnd(t, (int64_t)image.width * image.height, 0, FileSizeBytes(fileName));
+    return ok;
+}
+
+bool TimedExportMesh(Mesh mesh, const char *fileName)
+{
+    StageTimer t = StageBegin("ExportMesh");
+    bool ok = ExportMesh(mesh, fileName);
+    StageEnd(t, 0, mesh.triangleCount, FileSizeBytes(fileName));
+    return ok;
+}
+
+void TimedImageResize(Image *image, int newWidth, int newHeight)
+{
+    StageTimer t = StageBegin("ImageResize");
+    ImageResize(image, newWidth, newHeight);
+    StageEnd(t, (int64_t)newWidth * newHeight, 0, 0);
+}
+
+static double StagePerSecond(int64_t amount, double ms)
+{
+    return ms > 0.0 ? amount / (ms / 1000.0) : 0.0;
+}
+
+void StagePrintSummary(void)
+{
+    printf("%-28s %6s %11s %11s %14s %14s %14s\n", "stage", "calls", "wall ms", "cpu ms", "Mpix/s", "Ktri/s", "MB/s");
+    for (int i = 0; i < stageCount; i++)
+    {
+        StageStat *s = &stageStats[i];
+        printf("%-28s %6d %11.1f %11.1f %14.2f %14.2f %14.2f\n", s->name, s->calls, s->wallMs, s->cpuMs,
+               StagePerSecond(s->pixels, s->wallMs) / 1e6, StagePerSecond(s->triangles, s->wallMs) / 1e3,
+               StagePerSecond(s->bytes, s->wallMs) / (1024.0 * 1024.0));
+    }
+}
+
+bool StageWriteJSON(const char *path, int seed, int mapSize, double totalWallMs)
+{
+    FILE *f = fopen(path, "w");
+    if (!f)
+    {
+        TraceLog(LOG_ERROR, "STAGES: could not write %s", path);
+        return false;
+    }
+    fprintf(f, "{\n");
+    fprintf(f, "  \"seed\": %d,\n", seed);
+    fprintf(f, "  \"map_size\": %d,\n", mapSize);
+    fprintf(f, "  \"total_wall_ms\": %.3f,\n", totalWallMs);
+    fprintf(f, "  \"stages\": [\n");
+    for (int i = 0; i < stageCount; i++)
+    {
+        StageStat *s = &stageStats[i];
+        fprintf(f, "    { \"name\": \"%s\", \"calls\": %d, \"wall_ms\": %.3f, \"cpu_ms\": %.3f, "
+                   "\"pixels\": %lld, \"triangles\": %lld, \"bytes\": %lld, "
+                   "\"pixels_per_s\": %.1f, \"triangles_per_s\": %.1f, \"bytes_per_s\": %.1f }%s\n",
+                s->name, s->calls, s->wallMs, s->cpuMs,
+                (long long)s->pixels, (long long)s->triangles, (long long)s->bytes,
+                StagePerSecond(s->pixels, s->wallMs), StagePerSecond(s->triangles, s->wallMs), StagePerSecond(s->bytes, s->wallMs),
+                i + 1 < stageCount ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    fclose(f);
+    TraceLog(LOG_INFO, "STAGES: wrote %d stages to %s", stageCount, path);
+    return true;
+}
+
+#endif //STAGE_TIMER_H
@@ -11,14 +11,13 @@
 #include <unistd.h> // for usleep
 #include <string.h>
 
+#include "world.h"
+
 #define SCREEN_WIDTH 1280
 #define SCREEN_HEIGHT 720
-#define CHUNK_COUNT 16
-#define CHUNK_SIZE 64
+//CHUNK_COUNT, CHUNK_SIZE, MAP_SIZE, MAP_SCALE come from world.h (map/world.txt)
 #define HEIGHT_SCALE 20.0f
-#define MAP_SIZE (CHUNK_COUNT * CHUNK_SIZE)
 #define MAX_CHUNKS_TO_QUEUE (CHUNK_COUNT * CHUNK_COUNT)
-#define MAP_SCALE 16
 #define MAP_VERTICAL_OFFSET 0 //(MAP_SCALE * -64)
 #define PLAYER_HEIGHT 1.7f
 #define USE_TREE_CUBES false
@@ -45,17 +44,16 @@ typedef struct {
     Texture2D textureFull;
     Vector3 position;
     Vector3 center;
-    float heightData[(CHUNK_SIZE + 1) * (CHUNK_SIZE + 1)];
     Vector3 *treePositions;
     int treeCount;
 } Chunk;
 
-Chunk chunks[CHUNK_COUNT][CHUNK_COUNT];
+Chunk **chunks = NULL; //CHUNK_COUNT x CHUNK_COUNT, allocated in main
 Vector3 cameraVelocity = { 0 };
 
 Camera3D camera = { 0 };
-int activeCX = CHUNK_COUNT / 2;
-int activeCY = CHUNK_COUNT / 2;
+int activeCX = 0; //middle chunk, set in main
+int activeCY = 0;
 bool showBoxes = true;
 
 void ImageDataFlipVertical(Image *image) {
@@ -175,10 +173,10 @@ void LoadChunk(int cx, int cy)
     char objPath32[256];
     char objPath16[256];
     char objPath8[256];
-    snprintf(objPath, sizeof(objPath), "map/chunk_%02d_%02d/64.obj", cx, cy);
-    snprintf(objPath32, sizeof(objPath32), "map/chunk_%02d_%02d/32.obj", cx, cy);
-    snprintf(objPath16, sizeof(objPath16), "map/chunk_%02d_%02d/16.obj", cx, cy);
-    snprintf(objPath8, sizeof(objPath8), "map/chunk_%02d_%02d/8.obj", cx, cy);
+    snprintf(objPath, sizeof(objPath), "map/chunk_%02d_%02d/%d.%s", cx, cy, world.lods[0], world.meshFormat);
+    snprintf(objPath32, sizeof(objPath32), "map/chunk_%02d_%02d/%d.%s", cx, cy, world.lods[1], world.meshFormat);
+    snprintf(objPath16, sizeof(objPath16), "map/chunk_%02d_%02d/%d.%s", cx, cy, world.lods[2], world.meshFormat);
+    snprintf(objPath8, sizeof(objPath8), "map/chunk_%02d_%02d/%d.%s", cx, cy, world.lods[3], world.meshFormat);
     
     // --- Load 3D model from .obj file ---
     TraceLog(LOG_INFO, "Loading OBJ: %s", objPath);
@@ -244,6 +242,14 @@ int main(void)
     float pitch = 0.0f;
     float yaw = 0.0f;  // Face toward -Z (the terrain is likely laid out in +X, +Z space)
 
+    if (!WorldLoad(WORLD_PATH)) return 1;
+    chunks = malloc(sizeof(Chunk *) * CHUNK_COUNT);
+    for (int x = 0; x < CHUNK_COUNT; x++) {
+        chunks[x] = calloc(CHUNK_COUNT, sizeof(Chunk));
+    }
+    activeCX = CHUNK_COUNT / 2;
+    activeCY = CHUNK_COUNT / 2;
+
     InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "Chunk LOD Seam Study");
     SetTargetFPS(60);
     DisableCursor();
@@ -0,0 +1,240 @@
+#ifndef TILESTORE_H
+#define TILESTORE_H
+
+//a float field too big for ram, cut into square tiles that live on disk (one raw file per tile)
+//only TILESTORE_CACHE tiles are resident at a time, least recently used dirty tiles get written back when they are pushed out
+//windows can be read past the edge of the world, those cells repeat the edge (same as the clamps in the slope code)
+#include "raylib.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TILESTORE_CACHE 16 //resident tiles, 16 x 512x512 floats = 16MB
+
+typedef struct {
+    int tx, ty;            // -1 when the slot is empty
+    float *data;           // tileSize * tileSize
+    bool dirty;
+    unsigned long long lastUse;
+} TileSlot;
+
+typedef struct {
+    char dir[256];
+    int worldSize;         // cells per side
+    int tileSize;          // cells per tile side
+    int tilesPerSide;
+    TileSlot slots[TILESTORE_CACHE];
+    unsigned long long clock;
+    long long bytesRead;   // disk traffic, for the stage table
+    long long bytesWritten;
+} TileStore;
+
+static void TileStorePath(TileStore *s, int tx, int ty, char *out, size_t size)
+{
+    snprintf(out, size, "%s/t_%03d_%03d.f32", s->dir, tx, ty);
+}
+
+// dir has to exist already, old tiles in it are reused (they are overwritten as the passes run)
+bool TileStoreInit(TileStore *s, const char *dir, int worldSize, int tileSize)
+{
+    memset(s, 0, sizeof(TileStore));
+    snprintf(s->dir, sizeof(s->dir), "%s", dir);
+    s->worldSize = worldSize;
+    s->tileSize = tileSize;
+    s->tilesPerSide = (worldSize + tileSize - 1) / tileSize;
+    for (int i = 0; i < TILESTORE_CACHE; i++)
+    {
+        s->slots[i].tx = -1;
+        s->slots[i].ty = -1;
+        s->slots[i].data = (float *)malloc(sizeof(float) * tileSize * tileSize);
+        if (!s->slots[i].data)
+        {
+            TraceLog(LOG_ERROR, "TILESTORE: out of memory for %d tiles of %d", TILESTORE_CACHE, tileSize);
+            return false;
+        }
+    }
+    return true;
+}
+
+static void TileStoreWriteBack(TileStore *s, TileSlot *slot)
+{
+    if (!slot->dirty || slot->tx < 0) return;
+    char path[320];
+    TileStorePath(s, slot->tx, slot->ty, path, sizeof(path));
+    FILE *f = fopen(path, "wb");
+    if (!f)
+    {
+        TraceLog(LOG_ERROR, "TILESTORE: could not write %s", path);
+        return;
+    }
+    size_t n = (size_t)s->tileSize * s->tileSize;
+    if (fwrite(slot->data, sizeof(float), n, f) != n) TraceLog(LOG_ERROR, "TILESTORE: short write on %s", path);
+    fclose(f);
+    s->bytesWritten += (long long)(n * sizeof(float));
+    slot->dirty = false;
+}
+
+// The tile, resident, a tile that was never written reads as zeros
+float *TileStoreGet(TileStore *s, int tx, int ty)
+{
+    s->clock++;
+    TileSlot *victim = &s->slots[0];
+    for (int i = 0; i < TILESTORE_CACHE; i++)
+    {
+        TileSlot *slot = &s->slots[i];
+        if (slot->tx == tx && slot->ty == ty)
+        {
+            slot->lastUse = s->clock;
+            return slot->data;
+        }
+        if (slot->lastUse < victim->lastUse) victim = slot;
+    }
+
+    TileStoreWriteBack(s, victim);
+    size_t n = (size_t)s->tileSize * s->tileSize;
+    char path[320];
+    TileStorePath(s, tx, ty, path, sizeof(path));
+    FILE *f = fopen(path, "rb");
+    if (f)
+    {
+        if (fread(victim->data, sizeof(float), n, f) != n) TraceLog(LOG_WARNING, "TILESTORE: short read on %s", path);
+        fclose(f);
+        s->bytesRead += (long long)(n * sizeof(float));
+    }
+    else
+    {
+        memset(victim->data, 0, n * sizeof(float));
+    }
+    victim->tx = tx;
+    victim->ty = ty;
+    victim->dirty = false;
+    victim->lastUse = s->clock;
+    return victim->data;
+}
+
+static inline int TileStoreClamp(int v, int max)
+{
+    return v < 0 ? 0 : (v > max ? max : v);
+}
+
+// Copy world cells [x0, x0+w) x [y0, y0+h) into out (w wide), anything outside the world repeats the edge
+void TileStoreReadWindow(TileStore *s, int x0, int y0, int w, int h, float *out)
+{
+    int ts = s->tileSize;
+    int last = s->worldSize - 1;
+    for (int y = 0; y < h; y++)
+    {
+        int gy = TileStoreClamp(y0 + y, last);
+        int x = 0;
+        while (x < w)
+        {
+            int gx = x0 + x;
+            if (gx < 0 || gx > last)
+            {
+                int cgx = TileStoreClamp(gx, last);
+                out[y * w + x] = TileStoreGet(s, cgx / ts, gy / ts)[(gy % ts) * ts + cgx % ts];
+                x++;
+                continue;
+            }
+            //one memcpy per tile the row crosses
+            int run = (gx / ts + 1) * ts - gx;
+            if (run > w - x) run = w - x;
+            if (run > last - gx + 1) run = last - gx + 1;
+            float *tile = TileStoreGet(s, gx / ts, gy / ts);
+            memcpy(&out[y * w + x], &tile[(gy % ts) * ts + gx % ts], sizeof(float) * run);
+            x += run;
+        }
+    }
+}
+
+// Copy a w x h block (rows srcStride apart) into world cells starting at x0, y0, cells outside the world are skipped
+void TileStoreWriteWindow(TileStore *s, int x0, int y0, int w, int h, const float *src, int srcStride)
+{
+    int ts = s->tileSize;
+    for (int y = 0; y < h; y++)
+    {
+        int gy = y0 + y;
+        if (gy < 0 || gy >= s->worldSize) continue;
+        int x = 0;
+        while (x < w)
+        {
+            int gx = x0 + x;
+            if (gx < 0) { x++; continue; }
+            if (gx >= s->worldSize) break;
+            int run = (gx / ts + 1) * ts - gx;
+            if (run > w - x) run = w - x;
+            if (run > s->worldSize - gx) run = s->worldSize - gx;
+            float *tile = TileStoreGet(s, gx / ts, gy / ts);
+            memcpy(&tile[(gy % ts) * ts + gx % ts], &src[y * srcStride + x], sizeof(float) * run);
+            //mark it, TileStoreGet just made it the most recent slot
+            for (int i = 0; i < TILESTORE_CACHE; i++)
+            {
+                if (s->slots[i].data == tile) { s->slots[i].dirty = true; break; }
+            }
+            x += run;
+        }
+    }
+}
+
+// Same as TileStoreWriteWindow but src is added onto what is there
+void TileStoreAddWindow(TileStore *s, int x0, int y0, int w, int h, const float *src, int srcStride)
+{
+    int ts = s->tileSize;
+    for (int y = 0; y < h; y++)
+    {
+        int gy = y0 + y;
+        if (gy < 0 || gy >= s->worldSize) continue;
+        int x = 0;
+        while (x < w)
+        {
+            int gx = x0 + x;
+            if (gx < 0) { x++; continue; }
+            if (gx >= s->worldSize) break;
+            int run = (gx / ts + 1) * ts - gx;
+            if (run > w - x) run = w - x;
+            if (run > s->worldSize - gx) run = s->worldSize - gx;
+            float *tile = TileStoreGet(s, gx / ts, gy / ts);
+            float *row = &tile[(gy % ts) * ts + gx % ts];
+            const float *add = &src[y * srcStride + x];
+            for (int i = 0; i < run; i++) row[i] += add[i];
+            for (int i = 0; i < TILESTORE_CACHE; i++)
+            {
+                if (s->slots[i].data == tile) { s->slots[i].dirty = true; break; }
+            }
+            x += run;
+        }
+    }
+}
+
+void TileStoreFlush(TileStore *s)
+{
+    for (int i = 0; i < TILESTORE_CACHE; i++) TileStoreWriteBack(s, &s->slots[i]);
+}
+
+// flushes, frees the cache, the tiles stay on disk
+void TileStoreClose(TileStore *s)
+{
+    TileStoreFlush(s);
+    for (int i = 0; i < TILESTORE_CACHE; i++)
+    {
+        free(s->slots[i].data);
+        s->slots[i].data = NULL;
+    }
+}
+
+// delete the tile files, for when the passes are done with a store
+void TileStoreRemoveFiles(TileStore *s)
+{
+    char path[320];
+    for (int ty = 0; ty < s->tilesPerSide; ty++)
+    {
+        for (int tx = 0; tx < s->tilesPerSide; tx++)
+        {
+            TileStorePath(s, tx, ty, path, sizeof(path));
+            remove(path);
+        }
+    }
+}
+
+#endif //TILESTORE_H
@@ -0,0 +1,257 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+//timeline of begin/end events per thread, written as chrome trace json (open in chrome://tracing or ui.perfetto.dev)
+//off by default, every call is one branch until TraceStart, events go into one buffer behind its own lock
+#include "raylib.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#define TRACE_MAX_EVENTS (1 << 19) //~50MB, a few minutes of play, after that events are dropped
+#define TRACE_MAX_THREADS 16
+
+typedef struct {
+    char ph;              // 'B' begin, 'E' end
+    int tid;
+    const char *name;     // must be a literal, we keep the pointer
+    const char *cat;
+    double tsUs;
+    char detail[64];      // file path, shows up in args
+} TraceEvent;
+
+typedef struct {
+    bool enabled;
+    TraceEvent *events;
+    int count;
+    int capacity;
+    bool dropped;
+    double startUs;
+    int threadCount;
+    const char *threadNames[TRACE_MAX_THREADS];
+    pthread_mutex_t lock;
+} Tracer;
+
+Tracer tracer = { .lock = PTHREAD_MUTEX_INITIALIZER };
+__thread int traceTid = -1;
+
+static inline double TraceNowUs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000.0 + ts.tv_nsec / 1000.0;
+}
+
+// small thread ids in the order threads first show up, 0 is whoever traced first (main)
+static int TraceThreadId(void)
+{
+    if (traceTid < 0)
+    {
+        pthread_mutex_lock(&tracer.lock);
+        traceTid = tracer.threadCount < TRACE_MAX_THREADS ? tracer.threadCount++ : TRACE_MAX_THREADS - 1;
+        pthread_mutex_unlock(&tracer.lock);
+    }
+    return traceTid;
+}
+
+// Name the calling thread in the timeline, fine to call before TraceStart
+void TraceThreadName(const char *name)
+{
+    int tid = TraceThreadId();
+    tracer.threadNames[tid] = name;
+}
+
+void TraceStart(void)
+{
+    pthread_mutex_lock(&tracer.lock);
+    if (!tracer.events)
+    {
+        tracer.capacity = 16384;
+        tracer.events = (TraceEvent *)malloc(sizeof(TraceEvent) * tracer.capacity);
+        if (!tracer.events)
+        {
+            pthread_mutex_unlock(&tracer.lock);
+            TraceLog(LOG_ERROR, "TRACE: failed to allocate event buffer");
+            return;
+        }
+    }
+    tracer.count = 0;
+    tracer.dropped = false;
+    tracer.startUs = TraceNowUs();
+    tracer.enabled = true;
+    pthread_mutex_unlock(&tracer.lock);
+    TraceLog(LOG_INFO, "TRACE: recording");
+}
+
+static void TraceEmit(char ph, const char *name, const char *cat, const char *detail)
+{
+    if (!tracer.enabled) return;
+    int tid = TraceThreadId();
+    double now = TraceNowUs();
+    pthread_mutex_lock(&tracer.lock);
+    if (!tracer.enabled) //TraceWrite got in between the check above and the lock
+    {
+        pthread_mutex_unlock(&tracer.lock);
+        return;
+    }
+    if (tracer.count >= tracer.capacity && tracer.capacity < TRACE_MAX_EVENTS)
+    {
+        int newCap = tracer.capacity * 2;
+        if (newCap > TRACE_MAX_EVENTS) newCap = TRACE_MAX_EVENTS;
+        TraceEvent *grown = (TraceEvent *)realloc(tracer.events, sizeof(TraceEvent) * newCap);
+        if (grown)
+        {
+            tracer.events = grown;
+            tracer.capacity = newCap;
+        }
+    }
+    if (tracer.count < tracer.capacity)
+    {
+        TraceEvent *e = &tracer.events[tracer.count++];
+        e->ph = ph;
+        e->tid = tid;
+        e->name = name;
+        e->cat = cat;
+        e->tsUs = now - tracer.startUs;
+        if (detail) snprintf(e->detail, sizeof(e->detail), "%s", detail);
+        else e->detail[0] = '\0';
+    }
+    else if (!tracer.dropped)
+    {
+        tracer.dropped = true;
+        TraceLog(LOG_WARNING, "TRACE: buffer full, dropping events");
+    }
+    pthread_mutex_unlock(&tracer.lock);
+}
+
+static inline void TraceBegin(const char *name, const char *cat) { TraceEmit('B', name, cat, NULL); }
+static inline void TraceBeginDetail(const char *name, const char *cat, const char *detail) { TraceEmit('B', name, cat, detail); }
+static inline void TraceEnd(const char *name, const char *cat) { TraceEmit('E', name, cat, NULL); }
+
+// pthread_mutex_lock that shows up as "lock wait" when someone else is holding it
+void TraceMutexLock(pthread_mutex_t *m, const char *what)
+{
+    if (!tracer.enabled)
+    {
+        pthread_mutex_lock(m);
+        return;
+    }
+    if (pthread_mutex_trylock(m) == 0) return;
+    TraceEmit('B', "lock wait", "lock", what);
+    pthread_mutex_lock(m);
+    TraceEmit('E', "lock wait", "lock", what);
+}
+
+//asset loads/uploads with a span around them, same idea as the Timed* wrappers in stage_timer.h
+Model TracedLoadModel(const char *fileName)
+{
+    TraceBeginDetail("OBJ parse", "asset", fileName);
+    Model model = LoadModel(fileName);
+    TraceEnd("OBJ parse", "asset");
+    return model;
+}
+
+Image TracedLoadImage(const char *fileName)
+{
+    TraceBeginDetail("PNG decode", "asset", fileName);
+    Image img = LoadImage(fileName);
+    TraceEnd("PNG decode", "asset");
+    return img;
+}
+
+void TracedUploadMesh(Mesh *mesh, bool dynamic)
+{
+    TraceBegin("UploadMesh", "gpu");
+    UploadMesh(mesh, dynamic);
+    TraceEnd("UploadMesh", "gpu");
+}
+
+Texture2D TracedLoadTextureFromImage(Image image)
+{
+    TraceBegin("LoadTextureFromImage", "gpu");
+    Texture2D tex = LoadTextureFromImage(image);
+    TraceEnd("LoadTextureFromImage", "gpu");
+    return tex;
+}
+
+void TracedGenTextureMipmaps(Texture2D *texture)
+{
+    TraceBegin("GenTextureMipmaps", "gpu");
+    GenTextureMipmaps(texture);
+    TraceEnd("GenTextureMipmaps", "gpu");
+}
+
+static void TraceWriteString(FILE *f, const char *s)
+{
+    fputc('"', f);
+    for (; *s; s++)
+    {
+        if (*s == '"' || *s == '\\') fputc('\\', f);
+        if ((unsigned char)*s >= 0x20) fputc(*s, f);
+    }
+    fputc('"', f);
+}
+
+// Stop recording and write {"traceEvents":[...]}, chrome wants ts in microseconds
+// the buffer is taken out under the lock, so a late TraceEmit or a TraceStart never touches what is being written
+bool TraceWrite(const char *path)
+{
+    pthread_mutex_lock(&tracer.lock);
+    tracer.enabled = false;
+    TraceEvent *events = tracer.events;
+    int count = tracer.count;
+    int threadCount = tracer.threadCount;
+    tracer.events = NULL; //TraceStart allocates a new one
+    tracer.count = 0;
+    tracer.capacity = 0;
+    pthread_mutex_unlock(&tracer.lock);
+
+    FILE *f = fopen(path, "w");
+    if (!f)
+    {
+        TraceLog(LOG_ERROR, "TRACE: could not write %s", path);
+        free(events);
+        return false;
+    }
+    fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    for (int t = 0; t < threadCount; t++)
+    {
+        fprintf(f, "{\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"name\":\"thread_name\",\"args\":{\"name\":", t);
+        TraceWriteString(f, tracer.threadNames[t] ? tracer.threadNames[t] : "thread");
+        fprintf(f, "}}%s\n", t + 1 < threadCount || count > 0 ? "," : "");
+    }
+    for (int i = 0; i < count; i++)
+    {
+        TraceEvent *e = &events[i];
+        fprintf(f, "{\"ph\":\"%c\",\"pid\":1,\"tid\":%d,\"ts\":%.1f,\"name\":", e->ph, e->tid, e->tsUs);
+        TraceWriteString(f, e->name);
+        fprintf(f, ",\"cat\":");
+        TraceWriteString(f, e->cat);
+        if (e->detail[0])
+        {
+            fprintf(f, ",\"args\":{\"detail\":");
+            TraceWriteString(f, e->detail);
+            fprintf(f, "}");
+        }
+        fprintf(f, "}%s\n", i + 1 < count ? "," : "");
+    }
+    fprintf(f, "]}\n");
+    fclose(f);
+    free(events);
+    TraceLog(LOG_INFO, "TRACE: wrote %d events to %s", count, path);
+    return true;
+}
+
+void TraceWriteWithTimestamp(void)
+{
+    time_t now = time(NULL);
+    struct tm *t = localtime(&now);
+    char filename[128];
+    strftime(filename, sizeof(filename), "trace_%Y%m%d_%H%M%S.json", t);
+    TraceWrite(filename);
+}
+
+#endif //TRACE_H
@@ -2,20 +2,22 @@
 #include "raymath.h"
 #include "rlgl.h"
 #include "models.h"
+#include "world.h"
 #include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
 #include <dirent.h>
 #include <string.h>
 
-#define CHUNK_COUNT 16
-#define TILE_COUNT 16
+//CHUNK_COUNT and TILE_GRID_SIZE come from map/world.txt (world.h), this used to check a 16x16 tile grid that create never wrote
 //#define TILE_SIZE 64
 //#define TILE_TYPES 2  // e.g. "rock", "tree"
 
 // validation function
 void ValidateTiles(int cx, int cy)
 {
-    for (int tx = 0; tx < TILE_COUNT; tx++) {
-        for (int ty = 0; ty < TILE_COUNT; ty++) {
+    for (int tx = 0; tx < TILE_GRID_SIZE; tx++) {
+        for (int ty = 0; ty < TILE_GRID_SIZE; ty++) {
             for (int i=0; i < MODEL_TOTAL_COUNT; i++)
             {
                 char path[256];
@@ -51,7 +53,102 @@ void ValidateTiles(int cx, int cy)
     }
 }
 
+#define WATER_TILE_SIZE 16.0f //same as main.c, water vertices sit on this grid
+
+static int CompareKeys(const void *a, const void *b)
+{
+    int64_t ka = *(const int64_t *)a, kb = *(const int64_t *)b;
+    return (ka > kb) - (ka < kb);
+}
+
+static int64_t WaterGridKey(int gx, int gz) { return ((int64_t)gx << 32) ^ (uint32_t)gz; }
+
+static int Gcd(int a, int b) { while (b) { int t = a % b; a = b; b = t; } return a; }
+
+//near water is displaced by water.vs, so no triangle edge may pass through a vertex it doesnt use (a t-junction cracks open
+//when the waves move the vertex and not the edge), checked over every near part of a body since its pieces touch
+//returns how many t-junctions it found
+int ValidateWaterBody(int body, Mesh *meshes, int count)
+{
+    int total = 0;
+    for (int m = 0; m < count; m++) total += meshes[m].vertexCount;
+    int64_t *keys = (int64_t *)malloc(sizeof(int64_t) * (total > 0 ? total : 1));
+    if (!keys) return 0;
+    int k = 0;
+    for (int m = 0; m < count; m++) {
+        for (int v = 0; v < meshes[m].vertexCount; v++) {
+            keys[k++] = WaterGridKey((int)lroundf(meshes[m].vertices[v*3+0] / WATER_TILE_SIZE), (int)lroundf(meshes[m].vertices[v*3+2] / WATER_TILE_SIZE));
+        }
+    }
+    qsort(keys, total, sizeof(int64_t), CompareKeys);
+
+    int bad = 0;
+    for (int m = 0; m < count; m++) {
+        Mesh mesh = meshes[m];
+        for (int t = 0; t < mesh.triangleCount; t++) {
+            for (int e = 0; e < 3; e++) {
+                int ia = t*3 + e, ib = t*3 + (e + 1) % 3;
+                if (mesh.indices) { ia = mesh.indices[ia]; ib = mesh.indices[ib]; }
+                int ax = (int)lroundf(mesh.vertices[ia*3+0] / WATER_TILE_SIZE), az = (int)lroundf(mesh.vertices[ia*3+2] / WATER_TILE_SIZE);
+                int bx = (int)lroundf(mesh.vertices[ib*3+0] / WATER_TILE_SIZE), bz = (int)lroundf(mesh.vertices[ib*3+2] / WATER_TILE_SIZE);
+                //every grid point strictly inside the edge
+                int g = Gcd(abs(bx - ax), abs(bz - az));
+                for (int s = 1; s < g; s++) {
+                    int64_t key = WaterGridKey(ax + (bx - ax) / g * s, az + (bz - az) / g * s);
+                    if (bsearch(&key, keys, total, sizeof(int64_t), CompareKeys)) {
+                        if (bad < 8) printf("water t-junction => body %d, edge (%d,%d)-(%d,%d) passes a vertex\n", body, ax, az, bx, bz);
+                        bad++;
+                    }
+                }
+            }
+        }
+    }
+    free(keys);
+    return bad;
+}
+
+void ValidateWater(void)
+{
+    FILE *f = fopen("map/water_bodies.txt", "r");
+    if (!f) return; //older export, per chunk water only
+    Mesh meshes[256];
+    Model models[256];
+    int count = 0;
+    int currentBody = -1;
+    int bodies = 0, bad = 0;
+    char line[256];
+    bool more = true;
+    while (more) {
+        more = fgets(line, sizeof(line), f) != NULL;
+        int body = -1, piece, part;
+        char variant[16] = { 0 };
+        if (more && (sscanf(line, "%d %d %d %15s", &body, &piece, &part, variant) != 4 || strcmp(variant, "near") != 0)) continue;
+        //lines come a body at a time, check the last one when the body changes (or the file ends)
+        if ((body != currentBody || count == 256) && count > 0) {
+            bad += ValidateWaterBody(currentBody, meshes, count);
+            for (int i = 0; i < count; i++) UnloadModel(models[i]);
+            count = 0;
+            bodies++;
+        }
+        if (!more) break;
+        currentBody = body;
+        char path[256];
+        snprintf(path, sizeof(path), "map/water/body_%d_%d.obj", body, part);
+        Model model = LoadModel(path);
+        if (model.meshCount <= 0) {
+            printf("water part missing => %s\n", path);
+            continue;
+        }
+        models[count] = model;
+        meshes[count] = model.meshes[0];
+        count++;
+    }
+    fclose(f);
+    printf("water: %d bodies checked, %d t-junctions\n", bodies, bad);
+}
+
 int main(void) {
+    if (!WorldLoad(WORLD_PATH)) return 1; //before the log level goes quiet
     // Required by some mesh/model functions
     SetConfigFlags(FLAG_WINDOW_HIDDEN); // Don't open a visible window
     SetTraceLogLevel(LOG_NONE);
@@ -61,6 +158,7 @@ int main(void) {
             ValidateTiles(cx,cy);
         }
     }
+    ValidateWater();
     CloseWindow();  // Clean up (even if no window was shown)
     return 0;
 }
@@ -0,0 +1,148 @@
+#ifndef WORLD_H
+#define WORLD_H
+
+//the world descriptor: grid size, chunk size, tile grid, scales, lods and asset formats
+//create writes it next to the map (map/world.txt), every other tool reads it and sizes itself from it at runtime
+//the grid macros below used to be #defined separately in every .c file (and they did not agree), now they all point here
+#include "raylib.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define WORLD_PATH "map/world.txt"
+#define WORLD_VERSION 1
+#define WORLD_MAX_LODS 8
+#define WORLD_MAX_CHUNK_COUNT 128 //8192 cells a side at 64 per chunk (--tiled), paths just get a third digit past 99
+#define WORLD_MAX_TILE_GRID 100   //paths are %02d_%02d
+
+typedef struct {
+    int version;
+    int chunkCount;        // chunks per side, the world is chunkCount x chunkCount
+    int chunkSize;         // heightmap cells per chunk side, the full lod mesh
+    int tileGrid;          // tiles per chunk side for the batched props
+    int mapScale;          // world units per heightmap cell
+    float chunkWorldSize;  // chunkSize * mapScale
+    float heightScale;
+    int lodCount;
+    int lods[WORLD_MAX_LODS]; // biggest first, these are the NN.obj names
+    int textureSize;       // upscaled chunk texture
+    char meshFormat[8];
+    char imageFormat[8];
+} World;
+
+// the old compile time world, 16x16 chunks of 64 cells, 8x8 tiles, maps made before world.txt existed are this
+#define WORLD_DEFAULT { WORLD_VERSION, 16, 64, 8, 16, 1024.0f, 60.0f, 4, { 64, 32, 16, 8 }, 1024, "obj", "png" }
+
+World world = WORLD_DEFAULT;
+
+//grid shorthand used all over the tools, these are runtime values now
+#define CHUNK_COUNT (world.chunkCount)
+#define CHUNK_SIZE (world.chunkSize)
+#define TILE_GRID_SIZE (world.tileGrid)
+#define MAP_SCALE (world.mapScale)
+#define CHUNK_WORLD_SIZE (world.chunkWorldSize)
+#define MAP_SIZE (world.chunkCount * world.chunkSize)
+#define CHUNK_TOTAL (world.chunkCount * world.chunkCount)
+
+// fix up the derived values and reject nonsense, false leaves the world as it was
+bool WorldValidate(World *w)
+{
+    if (w->chunkCount < 1 || w->chunkCount > WORLD_MAX_CHUNK_COUNT ||
+        w->tileGrid < 1 || w->tileGrid > WORLD_MAX_TILE_GRID ||
+        w->chunkSize < 2 || w->mapScale < 1 || w->lodCount != 4) //every tool keeps exactly 4 lods per chunk
+    {
+        TraceLog(LOG_ERROR, "WORLD: bad descriptor (chunks %d, chunk size %d, tile grid %d, scale %d, lods %d)",
+                 w->chunkCount, w->chunkSize, w->tileGrid, w->mapScale, w->lodCount);
+        return false;
+    }
+    if (w->chunkSize % w->tileGrid != 0)
+    {
+        TraceLog(LOG_ERROR, "WORLD: chunk size %d does not split into %d tiles", w->chunkSize, w->tileGrid);
+        return false;
+    }
+    if (w->lods[0] != w->chunkSize)
+    {
+        TraceLog(LOG_ERROR, "WORLD: the first lod (%d) has to be the chunk size (%d)", w->lods[0], w->chunkSize);
+        return false;
+    }
+    w->chunkWorldSize = (float)(w->chunkSize * w->mapScale);
+    return true;
+}
+
+bool WorldSave(const char *path)
+{
+    FILE *f = fopen(path, "w");
+    if (!f)
+    {
+        TraceLog(LOG_ERROR, "WORLD: could not write %s", path);
+        return false;
+    }
+    fprintf(f, "# MapBuilder world descriptor, written by create, read by play/lod/validate_tiles\n");
+    fprintf(f, "version %d\n", world.version);
+    fprintf(f, "chunk_count %d\n", world.chunkCount);
+    fprintf(f, "chunk_size %d\n", world.chunkSize);
+    fprintf(f, "tile_grid %d\n", world.tileGrid);
+    fprintf(f, "map_scale %d\n", world.mapScale);
+    fprintf(f, "chunk_world_size %.1f\n", world.chunkWorldSize);
+    fprintf(f, "height_scale %.3f\n", world.heightScale);
+    fprintf(f, "lods");
+    for (int i = 0; i < world.lodCount; i++) fprintf(f, " %d", world.lods[i]);
+    fprintf(f, "\n");
+    fprintf(f, "texture_size %d\n", world.textureSize);
+    fprintf(f, "mesh_format %s\n", world.meshFormat);
+    fprintf(f, "image_format %s\n", world.imageFormat);
+    fclose(f);
+    TraceLog(LOG_INFO, "WORLD: wrote %s (%dx%d chunks, %dx%d tiles)", path, world.chunkCount, world.chunkCount, world.tileGrid, world.tileGrid);
+    return true;
+}
+
+// Read path into world, a missing file keeps the defaults (old maps), a broken one is an error
+bool WorldLoad(const char *path)
+{
+    FILE *f = fopen(path, "r");
+    if (!f)
+    {
+        TraceLog(LOG_WARNING, "WORLD: no %s, using the default %dx%d world", path, world.chunkCount, world.chunkCount);
+        return true;
+    }
+    World w = world;
+    char line[256];
+    while (fgets(line, sizeof(line), f))
+    {
+        char key[32];
+        int used = 0;
+        if (line[0] == '#' || sscanf(line, "%31s %n", key, &used) != 1) continue;
+        const char *val = line + used;
+        if (strcmp(key, "version") == 0) w.version = atoi(val);
+        else if (strcmp(key, "chunk_count") == 0) w.chunkCount = atoi(val);
+        else if (strcmp(key, "chunk_size") == 0) w.chunkSize = atoi(val);
+        else if (strcmp(key, "tile_grid") == 0) w.tileGrid = atoi(val);
+        else if (strcmp(key, "map_scale") == 0) w.mapScale = atoi(val);
+        else if (strcmp(key, "chunk_world_size") == 0) {} // derived, WorldValidate recomputes it
+        else if (strcmp(key, "height_scale") == 0) w.heightScale = (float)atof(val);
+        else if (strcmp(key, "lods") == 0)
+        {
+            w.lodCount = 0;
+            int n = 0, lod = 0;
+            while (w.lodCount < WORLD_MAX_LODS && sscanf(val, "%d%n", &lod, &n) == 1)
+            {
+                w.lods[w.lodCount++] = lod;
+                val += n;
+            }
+        }
+        else if (strcmp(key, "texture_size") == 0) w.textureSize = atoi(val);
+        else if (strcmp(key, "mesh_format") == 0) sscanf(val, "%7s", w.meshFormat);
+        else if (strcmp(key, "image_format") == 0) sscanf(val, "%7s", w.imageFormat);
+        else TraceLog(LOG_WARNING, "WORLD: unknown key %s in %s", key, path);
+    }
+    fclose(f);
+    if (w.version > WORLD_VERSION) TraceLog(LOG_WARNING, "WORLD: %s is version %d, this build knows %d", path, w.version, WORLD_VERSION);
+    if (!WorldValidate(&w)) return false;
+    world = w;
+    TraceLog(LOG_INFO, "WORLD: %dx%d chunks of %d cells, %dx%d tiles, scale %d", world.chunkCount, world.chunkCount, world.chunkSize,
+             world.tileGrid, world.tileGrid, world.mapScale);
+    return true;
+}
+
+#endif //WORLD_H